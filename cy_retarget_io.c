@@ -29,8 +29,152 @@
 #include "cy_utils.h"
 #include "xmc_uart.h"
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include "xmc_device.h"
+#if (UC_FAMILY == XMC4)
+#include "xmc_dma.h"
+#endif
+
+#if defined(CY_RTOS_AWARE) || defined(COMPONENT_RTOS_AWARE)
+// In the buffered modes, tasks waiting for ring buffer space or received data block on a semaphore
+// signalled by the interrupt instead of polling. This works with all toolchains.
+#define CY_RETARGET_IO_RTOS_WAIT
+#include "cyabs_rtos.h"
+#if defined(CY_RETARGET_IO_LINE_BUFFERS) && (CY_RETARGET_IO_LINE_BUFFERS > 0)
+// Partial lines written to stdout are collected per task and sent when they are complete
+#define CY_RETARGET_IO_TASK_LINES
+#endif
+#endif
+
+// Set by cy_retarget_io_panic_flush. The output path does not take any lock after that.
+static volatile bool cy_retarget_io_in_panic = false;
+
+#if defined(CY_RETARGET_IO_STATS)
+static cy_retarget_io_stats_t cy_retarget_io_stats;
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_stats_init
+//
+// Starts the clock of the statistics: the DWT cycle counter on Cortex-M3/M4, SysTick on Cortex-M0,
+// started without interrupt if the application does not use it
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_stats_init(void)
+{
+    (void)memset(&cy_retarget_io_stats, 0, sizeof(cy_retarget_io_stats));
+    #if (__CORTEX_M >= 3U)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+    #else
+    if ((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) == 0U)
+    {
+        SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+        SysTick->VAL  = 0U;
+        SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+    }
+    #endif // if (__CORTEX_M >= 3U)
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_stats_now
+//--------------------------------------------------------------------------------------------------
+static inline uint32_t cy_retarget_io_stats_now(void)
+{
+    #if (__CORTEX_M >= 3U)
+    return DWT->CYCCNT;
+    #else
+    return SysTick->VAL;
+    #endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_stats_add_cycles
+//
+// Adds the cycles elapsed since start to the total and returns them. With SysTick, intervals
+// longer than its period are not measured correctly.
+//--------------------------------------------------------------------------------------------------
+static uint32_t cy_retarget_io_stats_add_cycles(uint64_t* total, uint32_t start)
+{
+    uint32_t now = cy_retarget_io_stats_now();
+    #if (__CORTEX_M >= 3U)
+    uint32_t cycles = now - start;
+    #else
+    // SysTick counts down from LOAD to 0
+    uint32_t cycles = (now <= start)
+        ? (start - now)
+        : ((start + (SysTick->LOAD & SysTick_LOAD_RELOAD_Msk) + 1U) - now);
+    #endif
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *total += cycles;
+    __set_PRIMASK(primask);
+    return cycles;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_stats_count
+//--------------------------------------------------------------------------------------------------
+static inline void cy_retarget_io_stats_count(uint32_t* counter, size_t value)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *counter += (uint32_t)value;
+    __set_PRIMASK(primask);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_stats_high_water
+//--------------------------------------------------------------------------------------------------
+static inline void cy_retarget_io_stats_high_water(uint32_t* mark, size_t value)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (*mark < (uint32_t)value)
+    {
+        *mark = (uint32_t)value;
+    }
+    __set_PRIMASK(primask);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_stats_write_done
+//
+// Accounts a call of an output function in write_cycles and in the latency histogram
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_stats_write_done(uint32_t start)
+{
+    uint32_t cycles = cy_retarget_io_stats_add_cycles(&cy_retarget_io_stats.write_cycles, start);
+    uint32_t bin    = 0U;
+    while ((cycles != 0U) && (bin < (CY_RETARGET_IO_STATS_LATENCY_BINS - 1U)))
+    {
+        cycles >>= 1U;
+        ++bin;
+    }
+    cy_retarget_io_stats_count(&cy_retarget_io_stats.write_latency[bin], 1U);
+}
+
+
+#define CY_RETARGET_IO_STATS_START(start)   uint32_t start = cy_retarget_io_stats_now()
+#define CY_RETARGET_IO_STATS_CYCLES(field, start) \
+    (void)cy_retarget_io_stats_add_cycles(&cy_retarget_io_stats.field, (start))
+#define CY_RETARGET_IO_STATS_WRITE_DONE(start) cy_retarget_io_stats_write_done(start)
+#define CY_RETARGET_IO_STATS_COUNT(field, value) \
+    cy_retarget_io_stats_count(&cy_retarget_io_stats.field, (value))
+#define CY_RETARGET_IO_STATS_HIGH_WATER(field, value) \
+    cy_retarget_io_stats_high_water(&cy_retarget_io_stats.field, (value))
+#else // if defined(CY_RETARGET_IO_STATS)
+#define CY_RETARGET_IO_STATS_START(start)
+#define CY_RETARGET_IO_STATS_CYCLES(field, start)
+#define CY_RETARGET_IO_STATS_COUNT(field, value)
+#define CY_RETARGET_IO_STATS_HIGH_WATER(field, value)
+#define CY_RETARGET_IO_STATS_WRITE_DONE(start)
+#endif // if defined(CY_RETARGET_IO_STATS)
 
 #if (defined(CY_RTOS_AWARE) || defined(COMPONENT_RTOS_AWARE)) && defined(__GNUC__) && \
     !defined(__ARMCC_VERSION) && !defined(__clang__)
@@ -65,15 +209,23 @@ static cy_rslt_t cy_retarget_io_mutex_init(void)
 
 //--------------------------------------------------------------------------------------------------
 // cy_retarget_io_mutex_acquire
+//
+// Interrupts cannot block on the mutex, they write without it
 //--------------------------------------------------------------------------------------------------
 static void cy_retarget_io_mutex_acquire(void)
 {
+    if (cy_retarget_io_in_panic || (__get_IPSR() != 0U))
+    {
+        return;
+    }
     CY_ASSERT(cy_retarget_io_mutex_initialized);
+    CY_RETARGET_IO_STATS_START(start);
     cy_rslt_t rslt = cy_rtos_get_mutex(&cy_retarget_io_mutex, CY_RTOS_NEVER_TIMEOUT);
     if (rslt != CY_RSLT_SUCCESS)
     {
         abort();
     }
+    CY_RETARGET_IO_STATS_CYCLES(mutex_wait_cycles, start);
 }
 
 
@@ -82,6 +234,10 @@ static void cy_retarget_io_mutex_acquire(void)
 //--------------------------------------------------------------------------------------------------
 static void cy_retarget_io_mutex_release(void)
 {
+    if (cy_retarget_io_in_panic || (__get_IPSR() != 0U))
+    {
+        return;
+    }
     CY_ASSERT(cy_retarget_io_mutex_initialized);
     cy_rslt_t rslt = cy_rtos_set_mutex(&cy_retarget_io_mutex);
     if (rslt != CY_RSLT_SUCCESS)
@@ -96,11 +252,15 @@ static void cy_retarget_io_mutex_release(void)
 //--------------------------------------------------------------------------------------------------
 static void cy_retarget_io_mutex_deinit(void)
 {
-    CY_ASSERT(cy_retarget_io_mutex_initialized);
-    cy_rslt_t rslt = cy_rtos_deinit_mutex(&cy_retarget_io_mutex);
-    if (rslt != CY_RSLT_SUCCESS)
+    // Also called to undo an initialization that failed before the mutex was created
+    if (cy_retarget_io_mutex_initialized)
     {
-        abort();
+        cy_rslt_t rslt = cy_rtos_deinit_mutex(&cy_retarget_io_mutex);
+        if (rslt != CY_RSLT_SUCCESS)
+        {
+            abort();
+        }
+        cy_retarget_io_mutex_initialized = false;
     }
 }
 
@@ -164,435 +324,5621 @@ extern "C" {
 // UART channel handle
 cy_retarget_io_uart_t cy_retarget_io_uart_obj;
 
-// Tracks the previous character sent to output stream
-#ifdef CY_RETARGET_IO_CONVERT_LF_TO_CRLF
-static char cy_retarget_io_stdout_prev_char = 0;
-#endif // CY_RETARGET_IO_CONVERT_LF_TO_CRLF
-
-//--------------------------------------------------------------------------------------------------
-// cy_retarget_io_getchar
-//--------------------------------------------------------------------------------------------------
-static inline cy_rslt_t cy_retarget_io_getchar(char* c)
-{
-    while ((XMC_UART_CH_GetStatusFlag(cy_retarget_io_uart_obj.channel) &
-            (XMC_UART_CH_STATUS_FLAG_RECEIVE_INDICATION |
-             XMC_UART_CH_STATUS_FLAG_ALTERNATIVE_RECEIVE_INDICATION)) == 0U)
-    {
-        // Block indefinitely waiting for data in the receive buffer
-    }
+// Trace capture log, takes the output of the main channel while its buffer is set
+cy_retarget_io_capture_t cy_retarget_io_capture;
 
-    // Read single character from the receive buffer
-    *c = XMC_UART_CH_GetReceivedData(cy_retarget_io_uart_obj.channel);
+// Tracks the previous character sent to output stream, an LF at the start of a line
+static char cy_retarget_io_stdout_prev_char = '\n';
+static char cy_retarget_io_stderr_prev_char = '\n';
 
-    // Clear the receive buffer indication flag
-    XMC_UART_CH_ClearStatusFlag(cy_retarget_io_uart_obj.channel,
-                                XMC_UART_CH_STATUS_FLAG_ALTERNATIVE_RECEIVE_INDICATION |
-                                XMC_UART_CH_STATUS_FLAG_RECEIVE_INDICATION);
-    return CY_RSLT_SUCCESS;
-}
+// Standard stream routed to a USIC channel other than cy_retarget_io_uart_obj. The channel is
+// always used in the polling mode and has its own lock, so it never waits for the main channel.
+typedef struct
+{
+    XMC_USIC_CH_t* channel; // NULL if the stream uses the main channel
+    char           prev_char;
+    #if (defined(CY_RTOS_AWARE) || defined(COMPONENT_RTOS_AWARE)) && defined(__GNUC__) && \
+    !defined(__ARMCC_VERSION) && !defined(__clang__)
+    cy_mutex_t     mutex;
+    bool           mutex_initialized;
+    #endif
+} cy_retarget_io_route_t;
 
+static cy_retarget_io_route_t cy_retarget_io_routes[CY_RETARGET_IO_STDERR + 1];
 
+#if (defined(CY_RTOS_AWARE) || defined(COMPONENT_RTOS_AWARE)) && defined(__GNUC__) && \
+    !defined(__ARMCC_VERSION) && !defined(__clang__)
 //--------------------------------------------------------------------------------------------------
-// cy_retarget_io_putchar
+// cy_retarget_io_route_lock_init
 //--------------------------------------------------------------------------------------------------
-static inline cy_rslt_t cy_retarget_io_putchar(char c)
+static cy_rslt_t cy_retarget_io_route_lock_init(cy_retarget_io_route_t* route)
 {
-    // Send single character to the transmit buffer
-    XMC_UART_CH_Transmit(cy_retarget_io_uart_obj.channel, c);
-    return CY_RSLT_SUCCESS;
+    cy_rslt_t rslt = CY_RSLT_SUCCESS;
+    if (!route->mutex_initialized)
+    {
+        rslt = cy_rtos_init_mutex(&route->mutex);
+        route->mutex_initialized = (rslt == CY_RSLT_SUCCESS);
+    }
+    return rslt;
 }
 
 
-#if defined(__ARMCC_VERSION) // ARM-MDK
 //--------------------------------------------------------------------------------------------------
-// fputc
+// cy_retarget_io_route_lock
 //--------------------------------------------------------------------------------------------------
-__attribute__((weak)) int fputc(int ch, FILE* f)
+static void cy_retarget_io_route_lock(cy_retarget_io_route_t* route)
 {
-    (void)f;
-    cy_rslt_t rslt = CY_RSLT_SUCCESS;
-    #ifdef CY_RETARGET_IO_CONVERT_LF_TO_CRLF
-    if (((char)ch == '\n') && (cy_retarget_io_stdout_prev_char != '\r'))
-    {
-        rslt = cy_retarget_io_putchar('\r');
-    }
-    #endif // CY_RETARGET_IO_CONVERT_LF_TO_CRLF
-
-    if (CY_RSLT_SUCCESS == rslt)
+    if (cy_retarget_io_in_panic || (__get_IPSR() != 0U))
     {
-        rslt = cy_retarget_io_putchar(ch);
+        return;
     }
-
-    #ifdef CY_RETARGET_IO_CONVERT_LF_TO_CRLF
-    if (CY_RSLT_SUCCESS == rslt)
+    CY_ASSERT(route->mutex_initialized);
+    if (cy_rtos_get_mutex(&route->mutex, CY_RTOS_NEVER_TIMEOUT) != CY_RSLT_SUCCESS)
     {
-        cy_retarget_io_stdout_prev_char = (char)ch;
+        abort();
     }
-    #endif // CY_RETARGET_IO_CONVERT_LF_TO_CRLF
-
-    return (CY_RSLT_SUCCESS == rslt) ? ch : EOF;
 }
 
 
-#elif defined (__ICCARM__) // IAR
-    #include <yfuns.h>
-
 //--------------------------------------------------------------------------------------------------
-// __write
+// cy_retarget_io_route_unlock
 //--------------------------------------------------------------------------------------------------
-__weak size_t __write(int handle, const unsigned char* buffer, size_t size)
+static void cy_retarget_io_route_unlock(cy_retarget_io_route_t* route)
 {
-    size_t nChars = 0;
-    // This template only writes to "standard out", for all other file handles it returns failure.
-    if (handle != _LLIO_STDOUT)
+    if (cy_retarget_io_in_panic || (__get_IPSR() != 0U))
     {
-        return (_LLIO_ERROR);
+        return;
     }
-    if (buffer != NULL)
+    CY_ASSERT(route->mutex_initialized);
+    if (cy_rtos_set_mutex(&route->mutex) != CY_RSLT_SUCCESS)
     {
-        cy_rslt_t rslt = CY_RSLT_SUCCESS;
-        for (; nChars < size; ++nChars)
-        {
-            #ifdef CY_RETARGET_IO_CONVERT_LF_TO_CRLF
-            if ((*buffer == '\n') && (cy_retarget_io_stdout_prev_char != '\r'))
-            {
-                rslt = cy_retarget_io_putchar('\r');
-            }
-            #endif // CY_RETARGET_IO_CONVERT_LF_TO_CRLF
-
-            if (rslt == CY_RSLT_SUCCESS)
-            {
-                rslt = cy_retarget_io_putchar(*buffer);
-            }
-
-            if (rslt != CY_RSLT_SUCCESS)
-            {
-                break;
-            }
-
-            #ifdef CY_RETARGET_IO_CONVERT_LF_TO_CRLF
-            cy_retarget_io_stdout_prev_char = *buffer;
-            #endif // CY_RETARGET_IO_CONVERT_LF_TO_CRLF
-            ++buffer;
-        }
+        abort();
     }
-    return (nChars);
 }
 
 
-#else // (__GNUC__)  GCC
-#if !defined(CY_RETARGET_IO_NO_FLOAT)
-// Add an explicit reference to the floating point printf library to allow the usage of floating
-// point conversion specifier.
-__asm(".global _printf_float");
-#endif
 //--------------------------------------------------------------------------------------------------
-// _write
+// cy_retarget_io_route_lock_deinit
 //--------------------------------------------------------------------------------------------------
-__attribute__((weak)) int _write(int fd, const char* ptr, int len)
+static void cy_retarget_io_route_lock_deinit(cy_retarget_io_route_t* route)
 {
-    int nChars = 0;
-    (void)fd;
-    if (ptr != NULL)
+    if (route->mutex_initialized)
     {
-        cy_rslt_t rslt = CY_RSLT_SUCCESS;
-        cy_retarget_io_mutex_acquire();
-        for (; nChars < len; ++nChars)
-        {
-            #ifdef CY_RETARGET_IO_CONVERT_LF_TO_CRLF
-            if ((*ptr == '\n') && (cy_retarget_io_stdout_prev_char != '\r'))
-            {
-                rslt = cy_retarget_io_putchar('\r');
-            }
-            #endif // CY_RETARGET_IO_CONVERT_LF_TO_CRLF
-
-            if (CY_RSLT_SUCCESS == rslt)
-            {
-                rslt = cy_retarget_io_putchar((uint32_t)*ptr);
-            }
-
-            if (CY_RSLT_SUCCESS != rslt)
-            {
-                break;
-            }
-
-            #ifdef CY_RETARGET_IO_CONVERT_LF_TO_CRLF
-            cy_retarget_io_stdout_prev_char = *ptr;
-            #endif // CY_RETARGET_IO_CONVERT_LF_TO_CRLF
-            ++ptr;
-        }
-        cy_retarget_io_mutex_release();
+        (void)cy_rtos_deinit_mutex(&route->mutex);
+        route->mutex_initialized = false;
     }
-    return (nChars);
 }
 
 
-#endif // if defined(__ARMCC_VERSION)
+#else // if (defined(CY_RTOS_AWARE) || defined(COMPONENT_RTOS_AWARE)) && defined(__GNUC__) &&
+// !defined(__ARMCC_VERSION) && !defined(__clang__)
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_route_lock_init
+//--------------------------------------------------------------------------------------------------
+static inline cy_rslt_t cy_retarget_io_route_lock_init(cy_retarget_io_route_t* route)
+{
+    (void)route;
+    return CY_RSLT_SUCCESS;
+}
 
 
-#if defined(__ARMCC_VERSION) // ARM-MDK
 //--------------------------------------------------------------------------------------------------
-// fgetc
+// cy_retarget_io_route_lock
 //--------------------------------------------------------------------------------------------------
-__attribute__((weak)) int fgetc(FILE* f)
+static inline void cy_retarget_io_route_lock(cy_retarget_io_route_t* route)
 {
-    (void)f;
-    char c;
-    cy_rslt_t rslt = cy_retarget_io_getchar(&c);
-    return (CY_RSLT_SUCCESS == rslt) ? c : EOF;
+    (void)route;
 }
 
 
-#elif defined (__ICCARM__) // IAR
 //--------------------------------------------------------------------------------------------------
-// __read
+// cy_retarget_io_route_unlock
 //--------------------------------------------------------------------------------------------------
-__weak size_t __read(int handle, unsigned char* buffer, size_t size)
+static inline void cy_retarget_io_route_unlock(cy_retarget_io_route_t* route)
 {
-    // This template only reads from "standard in", for all other file handles it returns failure.
-    if ((handle != _LLIO_STDIN) || (buffer == NULL))
-    {
-        return (_LLIO_ERROR);
-    }
-    else
-    {
-        cy_rslt_t rslt = cy_retarget_io_getchar((char*)buffer);
-        return (CY_RSLT_SUCCESS == rslt) ? 1 : 0;
-    }
+    (void)route;
 }
 
 
-#else // (__GNUC__)  GCC
-#if !defined(CY_RETARGET_IO_NO_FLOAT)
-// Add an explicit reference to the floating point scanf library to allow the usage of floating
-// point conversion specifier.
-__asm(".global _scanf_float");
-#endif
 //--------------------------------------------------------------------------------------------------
-// _read
+// cy_retarget_io_route_lock_deinit
 //--------------------------------------------------------------------------------------------------
-__attribute__((weak)) int _read(int fd, char* ptr, int len)
+static inline void cy_retarget_io_route_lock_deinit(cy_retarget_io_route_t* route)
 {
-    (void)fd;
+    (void)route;
+}
 
-    cy_rslt_t rslt;
-    int nChars = 0;
-    if (ptr != NULL)
+
+#endif // if (defined(CY_RTOS_AWARE) || defined(COMPONENT_RTOS_AWARE)) && defined(__GNUC__) &&
+// !defined(__ARMCC_VERSION) && !defined(__clang__)
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_get_route
+//
+// Returns the route of the stream if it uses its own channel, NULL if it uses the main channel
+//--------------------------------------------------------------------------------------------------
+static inline cy_retarget_io_route_t* cy_retarget_io_get_route(int fd)
+{
+    if ((fd < CY_RETARGET_IO_STDIN) || (fd > CY_RETARGET_IO_STDERR) ||
+        (cy_retarget_io_routes[fd].channel == NULL))
     {
-        for (; nChars < len; ++ptr)
-        {
-            rslt = cy_retarget_io_getchar(ptr);
-            if (rslt == CY_RSLT_SUCCESS)
-            {
-                ++nChars;
-                if ((*ptr == '\n') || (*ptr == '\r'))
-                {
-                    break;
-                }
-            }
-            else
-            {
-                break;
-            }
-        }
+        return NULL;
     }
-    return (nChars);
+    return &cy_retarget_io_routes[fd];
 }
 
+// Software ring buffer. One slot is always kept free to tell a full buffer from an empty one.
+typedef struct
+{
+    uint8_t*        buffer;
+    size_t          size;
+    volatile size_t head;   // Next slot to be written, owned by the producer
+    volatile size_t tail;   // Next slot to be read, owned by the consumer
+} cy_retarget_io_ring_t;
 
-#endif // if defined(__ARMCC_VERSION)
+// Transmit ring buffer, drained by cy_retarget_io_irq_handler. Unused when buffer is NULL.
+// Any number of producers share it without a lock, head is the end of the data the consumer has
+// found to be complete.
+static cy_retarget_io_ring_t cy_retarget_io_tx_ring;
 
-#if defined(__ARMCC_VERSION) // ARM-MDK
-// Include _sys_* prototypes provided by ARM Compiler runtime library
-    #include <rt_sys.h>
+// Producer state of the transmit ring buffer, always updated as a whole with an atomic
+// compare-and-swap. The lower bits hold the end of the reserved area, the upper bits count the
+// producers still copying into it. Everything up to the end of the reserved area is complete
+// whenever the count is zero. The top bit is set while cy_retarget_io_reserve has handed out the
+// space after the reserved area, no other producer can reserve space until it is committed. The
+// PREV bits tell whether the reserved area ends with LF, CR or another character, text is
+// converted against them and they change with the same update that reserves the space.
+static volatile uint32_t cy_retarget_io_tx_state = 0U;
 
-// Prevent linkage of library functions that use semihosting calls
-__asm(".global __use_no_semihosting\n\t");
+#define CY_RETARGET_IO_TX_RESERVED_Msk      (0x003FFFFFUL)
+#define CY_RETARGET_IO_TX_PREV_LF           (0x00400000UL)
+#define CY_RETARGET_IO_TX_PREV_CR           (0x00800000UL)
+#define CY_RETARGET_IO_TX_PREV_Msk          (0x00C00000UL)
+#define CY_RETARGET_IO_TX_WRITERS_Msk       (0x7F000000UL)
+#define CY_RETARGET_IO_TX_WRITER            (0x01000000UL)
+#define CY_RETARGET_IO_TX_OPEN              (0x80000000UL)
 
-// Enable the linker to select an optimized library that does not include code to handle input
-// arguments to main()
-__asm(".global __ARM_use_no_argv\n\t");
+// High priority lane of the transmit path, used by stderr. Space is reserved with interrupts
+// masked and head only moves to the end of the reserved area once no producer is copying, so it
+// only ever holds complete records. Unused when buffer is NULL.
+static cy_retarget_io_ring_t cy_retarget_io_tx_high_ring;
+static size_t   cy_retarget_io_tx_high_reserved = 0U;
+static uint32_t cy_retarget_io_tx_high_writers  = 0U;
+
+// Lane the last segment was taken from
+static bool cy_retarget_io_tx_high_lane = false;
+
+// Unused area at the end of the transmit ring buffer that the consumer skips. Left behind by
+// cy_retarget_io_reserve when the space up to the end of the buffer was too short.
+static volatile size_t cy_retarget_io_tx_skip_start = 0U;
+static volatile size_t cy_retarget_io_tx_skip_len   = 0U;
+
+// Region handed out by cy_retarget_io_reserve, only used while CY_RETARGET_IO_TX_OPEN is set
+static size_t cy_retarget_io_tx_open_start   = 0U;
+static size_t cy_retarget_io_tx_open_len     = 0U;
+static size_t cy_retarget_io_tx_open_cap     = 0U;
+static size_t cy_retarget_io_tx_open_skip    = 0U;
+static bool   cy_retarget_io_tx_open_locked  = false;
+#if defined(CY_RETARGET_IO_RTOS_WAIT)
+// Task holding the ring open, NULL if an interrupt does
+static cy_thread_t cy_retarget_io_tx_open_owner = NULL;
+// Smallest region the task waiting in cy_retarget_io_reserve needs, it holds the mutex
+static size_t cy_retarget_io_tx_open_min = 0U;
+#endif
+
+// Set while the interrupt is expected to keep draining the transmit ring buffer
+static volatile bool cy_retarget_io_tx_running = false;
+
+// Set while cy_retarget_io_tx_service is moving data out of the transmit ring buffer
+static volatile bool cy_retarget_io_tx_in_service = false;
+
+// Handling of output that does not fit into the transmit ring buffer
+static cy_retarget_io_overflow_policy_t cy_retarget_io_tx_policy = CY_RETARGET_IO_OVERFLOW_BLOCK;
+
+// Bytes dropped by the overflow policy
+static volatile uint32_t cy_retarget_io_tx_dropped = 0U;
+
+// Whether the data sent from the normal lane ends on a record boundary, so the high priority lane
+// can take over without splitting a record
+static bool cy_retarget_io_tx_at_boundary = true;
+
+// Record boundaries in the transmit ring buffer that are not passed by the tail yet, as told by
+// the producers: the end of a chunk that ends a line and the start and end of a binary write. The
+// data itself is never scanned, binary records may contain any byte value. Unordered, only kept
+// for the high priority lane and CY_RETARGET_IO_OVERFLOW_DROP_OLDEST and updated with interrupts
+// masked.
+#define CY_RETARGET_IO_TX_RECORDS           (16U)
+static size_t   cy_retarget_io_tx_records[CY_RETARGET_IO_TX_RECORDS];
+static uint32_t cy_retarget_io_tx_record_count = 0U;
+static bool     cy_retarget_io_tx_track        = false;
+
+// Receive ring buffer, filled by cy_retarget_io_irq_handler. Unused when buffer is NULL.
+static cy_retarget_io_ring_t cy_retarget_io_rx_ring;
+
+// Bytes dropped because the receive ring buffer was full
+static volatile uint32_t cy_retarget_io_rx_ring_overruns = 0U;
+
+// Bytes lost because RBUF was overwritten before the interrupt could read it
+static volatile uint32_t cy_retarget_io_rx_hw_overruns = 0U;
+
+// Frames dropped by cy_retarget_io_read_frame
+static volatile uint32_t cy_retarget_io_rx_bad_frames = 0U;
+
+// Position up to which cy_retarget_io_read_frame searched the receive ring buffer for a delimiter,
+// equal to its tail otherwise. Waiting for received data waits for data after it.
+static size_t cy_retarget_io_rx_seen = 0U;
+
+// Baud rate set by cy_retarget_io_set_baudrate, 0 while the rate configured by the BSP is used
+static uint32_t cy_retarget_io_baudrate = 0U;
+
+// Number of entries of the USIC transmit FIFO, 0 when the FIFO is not configured
+static uint32_t cy_retarget_io_tx_fifo_size = 0U;
+
+// Number of FIFO entries known to be free. The FIFO only drains between two checks, so this value
+// is a safe lower bound and the fill level only has to be read once per burst.
+static uint32_t cy_retarget_io_tx_fifo_space = 0U;
 
 //--------------------------------------------------------------------------------------------------
-// _sys_open
-//
-// Open a file: dummy implementation.
-// Everything goes to the same output, no need to translate the file names
-// (__stdin_name/__stdout_name/__stderr_name) to descriptor numbers
+// cy_retarget_io_tx_fifo_get_space
 //--------------------------------------------------------------------------------------------------
-FILEHANDLE __attribute__((weak)) _sys_open(const char* name, int openmode)
+static inline uint32_t cy_retarget_io_tx_fifo_get_space(XMC_USIC_CH_t* channel)
 {
-    (void)name;
-    (void)openmode;
-    return 1;
+    return cy_retarget_io_tx_fifo_size - XMC_USIC_CH_TXFIFO_GetLevel(channel);
 }
 
 
 //--------------------------------------------------------------------------------------------------
-// _sys_close
-//
-// Close a file: dummy implementation.
+// cy_retarget_io_ring_next
 //--------------------------------------------------------------------------------------------------
-int __attribute__((weak)) _sys_close(FILEHANDLE fh)
+static inline size_t cy_retarget_io_ring_next(const cy_retarget_io_ring_t* ring, size_t index)
 {
-    (void)fh;
-    return 0;
+    // Avoid the modulo operator, Cortex-M0 has no hardware divider
+    return ((index + 1U) == ring->size) ? 0U : (index + 1U);
 }
 
 
 //--------------------------------------------------------------------------------------------------
-// _sys_write
-//
-// Write to a file: dummy implementation.
-// The low-level function fputc retargets output to use UART TX
+// cy_retarget_io_ring_is_empty
 //--------------------------------------------------------------------------------------------------
-int __attribute__((weak)) _sys_write(FILEHANDLE fh, const unsigned char* buf, unsigned len,
-                                     int mode)
+static inline bool cy_retarget_io_ring_is_empty(const cy_retarget_io_ring_t* ring)
 {
-    (void)fh;
-    (void)buf;
-    (void)len;
-    (void)mode;
-    return 0;
+    return ring->head == ring->tail;
 }
 
 
 //--------------------------------------------------------------------------------------------------
-// _sys_read
-//
-// Read from a file: dummy implementation.
-// The low-level function fputc retargets input to use UART RX
+// cy_retarget_io_ring_distance
 //--------------------------------------------------------------------------------------------------
-int __attribute__((weak)) _sys_read(FILEHANDLE fh, unsigned char* buf, unsigned len, int mode)
+static inline size_t cy_retarget_io_ring_distance(const cy_retarget_io_ring_t* ring, size_t from,
+                                                  size_t to)
 {
-    (void)fh;
-    (void)buf;
-    (void)len;
-    (void)mode;
-    return -1;
+    return (to >= from) ? (to - from) : (ring->size - from + to);
 }
 
 
 //--------------------------------------------------------------------------------------------------
-// _ttywrch
+// cy_retarget_io_ring_advance
+//--------------------------------------------------------------------------------------------------
+static inline size_t cy_retarget_io_ring_advance(const cy_retarget_io_ring_t* ring, size_t index,
+                                                 size_t len)
+{
+    index += len;
+    return (index >= ring->size) ? (index - ring->size) : index;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_ring_write
 //
-// Write a character to the output channel: dummy implementation.
+// Copies len bytes into the ring buffer starting at index, wrapping around the end of the buffer.
+// Returns the index following the copied data.
 //--------------------------------------------------------------------------------------------------
-void __attribute__((weak)) _ttywrch(int ch)
+static size_t cy_retarget_io_ring_write(cy_retarget_io_ring_t* ring, size_t index,
+                                        const void* data, size_t len)
 {
-    (void)ch;
+    size_t first = ring->size - index;
+    if (first > len)
+    {
+        first = len;
+    }
+    (void)memcpy(&ring->buffer[index], data, first);
+    (void)memcpy(&ring->buffer[0], (const uint8_t*)data + first, len - first);
+    return cy_retarget_io_ring_advance(ring, index, len);
 }
 
 
+// The output is split at every LF to convert the line terminators or to stamp the lines
+#if defined(CY_RETARGET_IO_CONVERT_LF_TO_CRLF) || defined(CY_RETARGET_IO_LINE_STAMP)
+#define CY_RETARGET_IO_TX_LINES
+#endif
+
+#if defined(CY_RETARGET_IO_TX_LINES)
 //--------------------------------------------------------------------------------------------------
-// _sys_istty
+// cy_retarget_io_find_lf
 //
-// Check if the file is connected to a terminal: dummy implementation
+// Returns the index of the first LF in ptr, or len if there is none. Aligned words are checked
+// four characters at a time: the XOR turns every LF into a zero byte, which is found with the SIMD
+// byte subtraction on cores with the DSP extension and with the classic zero byte test otherwise.
 //--------------------------------------------------------------------------------------------------
-int __attribute__((weak)) _sys_istty(FILEHANDLE fh)
+static size_t cy_retarget_io_find_lf(const char* ptr, size_t len)
 {
-    (void)fh;
-    return 0;
+    size_t i = 0U;
+    while ((i < len) && ((((uintptr_t)&ptr[i]) & 3U) != 0U))
+    {
+        if (ptr[i] == '\n')
+        {
+            return i;
+        }
+        ++i;
+    }
+
+    for (; (i + 4U) <= len; i += 4U)
+    {
+        uint32_t word;
+        (void)memcpy(&word, &ptr[i], sizeof(word));
+        word ^= 0x0A0A0A0AUL;
+        #if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+        // GE flags are set for the non-zero bytes, SEL yields 0xFF for the zero bytes
+        (void)__USUB8(word, 0x01010101UL);
+        uint32_t match = __SEL(0U, 0xFFFFFFFFUL);
+        #else
+        // The lowest set bit always marks the first zero byte, higher ones may be false positives
+        uint32_t match = (word - 0x01010101UL) & ~word & 0x80808080UL;
+        #endif
+        if (match != 0U)
+        {
+            #if (__CORTEX_M >= 3U)
+            // Little endian, the first character is the least significant byte
+            return i + (__CLZ(__RBIT(match)) >> 3U);
+            #else
+            break;
+            #endif
+        }
+    }
+
+    for (; i < len; ++i)
+    {
+        if (ptr[i] == '\n')
+        {
+            break;
+        }
+    }
+    return i;
 }
 
 
+#endif // defined(CY_RETARGET_IO_TX_LINES)
+
 //--------------------------------------------------------------------------------------------------
-// _sys_seek
+// cy_retarget_io_atomic_cas
 //
-// Move the file position to a given offset: dummy implementation
+// Replaces *addr by desired if it still holds expected. Cortex-M3/M4 use exclusive accesses, the
+// STREX fails if any exception occurred since the LDREX. Cortex-M0 has no exclusive accesses and
+// uses a critical section of a few instructions instead.
 //--------------------------------------------------------------------------------------------------
-int __attribute__((weak)) _sys_seek(FILEHANDLE fh, long pos)
+static inline bool cy_retarget_io_atomic_cas(volatile uint32_t* addr, uint32_t expected,
+                                             uint32_t desired)
 {
-    (void)fh;
-    (void)pos;
-    return -1;
+    #if (__CORTEX_M >= 3U)
+    if (__LDREXW(addr) != expected)
+    {
+        __CLREX();
+        return false;
+    }
+    return (__STREXW(desired, addr) == 0U);
+    #else
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bool swapped = (*addr == expected);
+    if (swapped)
+    {
+        *addr = desired;
+    }
+    __set_PRIMASK(primask);
+    return swapped;
+    #endif // if (__CORTEX_M >= 3U)
 }
 
 
 //--------------------------------------------------------------------------------------------------
-// _sys_flen
-// Return the current length of a file: dummy implementation
+// cy_retarget_io_atomic_add
 //--------------------------------------------------------------------------------------------------
-long __attribute__((weak)) _sys_flen(FILEHANDLE fh)
+static inline void cy_retarget_io_atomic_add(volatile uint32_t* addr, uint32_t value)
 {
-    (void)fh;
-    return 0;
+    uint32_t old;
+    do
+    {
+        old = *addr;
+    } while (!cy_retarget_io_atomic_cas(addr, old, old + value));
 }
 
 
 //--------------------------------------------------------------------------------------------------
-// _sys_exit
+// cy_retarget_io_tx_policy_now
 //
-// Terminate the program: dummy implementation
+// Overflow policy for the current context. Interrupts never wait for space: the consumer may be the
+// handler they preempted, so they drop what does not fit instead.
 //--------------------------------------------------------------------------------------------------
-void __attribute__((weak)) _sys_exit(int returncode)
+static inline cy_retarget_io_overflow_policy_t cy_retarget_io_tx_policy_now(void)
 {
-    (void)returncode;
-    for (;;)
+    cy_retarget_io_overflow_policy_t policy = cy_retarget_io_tx_policy;
+    return ((policy == CY_RETARGET_IO_OVERFLOW_BLOCK) && (__get_IPSR() != 0U))
+        ? CY_RETARGET_IO_OVERFLOW_DROP_NEWEST
+        : policy;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_used
+//
+// Number of bytes reserved by producers and not sent yet
+//--------------------------------------------------------------------------------------------------
+static inline size_t cy_retarget_io_tx_used(void)
+{
+    return cy_retarget_io_ring_distance(&cy_retarget_io_tx_ring, cy_retarget_io_tx_ring.tail,
+                                        cy_retarget_io_tx_state & CY_RETARGET_IO_TX_RESERVED_Msk);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_free
+//--------------------------------------------------------------------------------------------------
+static inline size_t cy_retarget_io_tx_free(void)
+{
+    return cy_retarget_io_tx_ring.size - 1U - cy_retarget_io_tx_used();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_mark
+//
+// Producer side: notes a record boundary at index, which the caller has reserved and not completed
+// yet. With the table full the boundary farthest from the tail is replaced if index is farther, so
+// the boundaries closest to the tail and the latest one stay known.
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_tx_mark(size_t index)
+{
+    const cy_retarget_io_ring_t* ring = &cy_retarget_io_tx_ring;
+    if (!cy_retarget_io_tx_track)
     {
-        // Halt here forever
+        return;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    size_t   distance = cy_retarget_io_ring_distance(ring, ring->tail, index);
+    size_t   farthest = 0U;
+    uint32_t slot     = 0U;
+    bool     known    = false;
+    for (uint32_t i = 0U; i < cy_retarget_io_tx_record_count; ++i)
+    {
+        size_t d = cy_retarget_io_ring_distance(ring, ring->tail, cy_retarget_io_tx_records[i]);
+        if (d == distance)
+        {
+            known = true;
+            break;
+        }
+        if (d >= farthest)
+        {
+            farthest = d;
+            slot     = i;
+        }
+    }
+    if (known)
+    {
+        // Shared by the end of one record and the start of the next
+    }
+    else if (cy_retarget_io_tx_record_count < CY_RETARGET_IO_TX_RECORDS)
+    {
+        cy_retarget_io_tx_records[cy_retarget_io_tx_record_count++] = index;
+    }
+    else if (distance > farthest)
+    {
+        cy_retarget_io_tx_records[slot] = index;
     }
+    __set_PRIMASK(primask);
 }
 
 
 //--------------------------------------------------------------------------------------------------
-// _sys_command_string
+// cy_retarget_io_tx_next_record
 //
-// Return a pointer to the command line: dummy implementation
+// Consumer side: returns the distance from the tail to the closest record boundary at most limit
+// bytes away, or SIZE_MAX if none is known
 //--------------------------------------------------------------------------------------------------
-char __attribute__((weak)) *_sys_command_string(char* cmd, int len)
+static size_t cy_retarget_io_tx_next_record(size_t limit)
 {
-    (void)cmd;
-    (void)len;
-    return NULL;
+    const cy_retarget_io_ring_t* ring = &cy_retarget_io_tx_ring;
+    size_t next = SIZE_MAX;
+    if (!cy_retarget_io_tx_track)
+    {
+        return next;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    for (uint32_t i = 0U; i < cy_retarget_io_tx_record_count; ++i)
+    {
+        size_t d = cy_retarget_io_ring_distance(ring, ring->tail, cy_retarget_io_tx_records[i]);
+        if ((d <= limit) && (d < next))
+        {
+            next = d;
+        }
+    }
+    __set_PRIMASK(primask);
+    return next;
 }
 
 
-#endif // ARM-MDK
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_pass
+//
+// Consumer side: moves the tail len bytes on and forgets the record boundaries it passes. Returns
+// true if the new tail is at one of them.
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_tx_pass(size_t len)
+{
+    cy_retarget_io_ring_t* ring = &cy_retarget_io_tx_ring;
+    bool at_record = false;
+    if (!cy_retarget_io_tx_track)
+    {
+        ring->tail = cy_retarget_io_ring_advance(ring, ring->tail, len);
+        return at_record;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t i = 0U;
+    while (i < cy_retarget_io_tx_record_count)
+    {
+        size_t d = cy_retarget_io_ring_distance(ring, ring->tail, cy_retarget_io_tx_records[i]);
+        if (d <= len)
+        {
+            at_record = at_record || (d == len);
+            cy_retarget_io_tx_records[i] =
+                cy_retarget_io_tx_records[--cy_retarget_io_tx_record_count];
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    ring->tail = cy_retarget_io_ring_advance(ring, ring->tail, len);
+    __set_PRIMASK(primask);
+    return at_record;
+}
+
 
 //--------------------------------------------------------------------------------------------------
-// cy_retarget_io_init
+// cy_retarget_io_tx_update_head
+//
+// Consumer side: moves head to the end of the reserved area if no producer is copying. Otherwise
+// head keeps the last known complete position, and the last producer to finish kicks the consumer.
+// Returns the end of the data that can be sent from the tail on, and moves the tail over the
+// unused area at the end of the buffer once it is reached. Must be called before reading the tail.
 //--------------------------------------------------------------------------------------------------
-cy_rslt_t cy_retarget_io_init(XMC_USIC_CH_t* base)
+static inline size_t cy_retarget_io_tx_update_head(void)
 {
-    cy_retarget_io_uart_obj.channel = base;
-    return cy_retarget_io_mutex_init();
+    cy_retarget_io_ring_t* ring = &cy_retarget_io_tx_ring;
+    uint32_t state = cy_retarget_io_tx_state;
+    if ((state & CY_RETARGET_IO_TX_WRITERS_Msk) == 0U)
+    {
+        ring->head = state & CY_RETARGET_IO_TX_RESERVED_Msk;
+    }
+
+    size_t head = ring->head;
+    if (cy_retarget_io_tx_skip_len != 0U)
+    {
+        // Once data after the unused area is complete, head has wrapped around below the tail
+        size_t tail = ring->tail;
+        if (head >= tail)
+        {
+            // Nothing complete after the unused area yet
+        }
+        else if (tail == cy_retarget_io_tx_skip_start)
+        {
+            ring->tail = cy_retarget_io_ring_advance(ring, tail, cy_retarget_io_tx_skip_len);
+            cy_retarget_io_tx_skip_len = 0U;
+        }
+        else
+        {
+            head = cy_retarget_io_tx_skip_start;
+        }
+    }
+    return head;
 }
 
 
 //--------------------------------------------------------------------------------------------------
-// cy_retarget_io_is_tx_active
+// cy_retarget_io_tx_ring_segment
+//
+// Consumer side: returns the next contiguous segment of the ring buffers. The high priority lane is
+// served first, but only once the normal lane is at a record boundary noted by the producers:
+// after a line, before or after a binary write, or when it is empty. While the high priority lane
+// waits, segments of the normal lane end at the next boundary so it can take over as soon as
+// possible.
 //--------------------------------------------------------------------------------------------------
-bool cy_retarget_io_is_tx_active()
+static size_t cy_retarget_io_tx_ring_segment(const uint8_t** data)
 {
-    return (XMC_UART_CH_GetStatusFlag(cy_retarget_io_uart_obj.channel) &
-            XMC_UART_CH_STATUS_FLAG_TRANSFER_STATUS_BUSY) > 0U;
+    cy_retarget_io_ring_t* ring = &cy_retarget_io_tx_ring;
+    cy_retarget_io_ring_t* high = &cy_retarget_io_tx_high_ring;
+    size_t head = cy_retarget_io_tx_update_head();
+    size_t tail = ring->tail;
+    size_t len  = (head >= tail) ? (head - tail) : (ring->size - tail);
+    bool   high_pending = (high->buffer != NULL) && !cy_retarget_io_ring_is_empty(high);
+    size_t next = high_pending ? cy_retarget_io_tx_next_record(len) : SIZE_MAX;
+
+    if (high_pending && (cy_retarget_io_tx_at_boundary || (len == 0U) || (next == 0U)))
+    {
+        size_t high_head = high->head;
+        size_t high_tail = high->tail;
+        cy_retarget_io_tx_high_lane = true;
+        *data = &high->buffer[high_tail];
+        return (high_head >= high_tail) ? (high_head - high_tail) : (high->size - high_tail);
+    }
+
+    if (next != SIZE_MAX)
+    {
+        len = next;
+    }
+    cy_retarget_io_tx_high_lane = false;
+    *data = &ring->buffer[tail];
+    return len;
 }
 
 
 //--------------------------------------------------------------------------------------------------
-// cy_retarget_io_deinit
+// cy_retarget_io_tx_ring_consume
+//
+// Consumer side: releases len bytes of the segment returned by cy_retarget_io_tx_ring_segment
 //--------------------------------------------------------------------------------------------------
-void cy_retarget_io_deinit()
+static void cy_retarget_io_tx_ring_consume(size_t len)
 {
-    // Since the largest hardware buffer would be 256 bytes
-    // it takes about 500 ms to transmit the 256 bytes at 9600 baud.
-    // Thus 1000 ms gives roughly 50% padding to this time.
-    int timeout_remaining_ms = 1000;
-    volatile uint32_t cycle_time_ms = (SystemCoreClock / 1000);
-    while (timeout_remaining_ms > 0)
+    if (len == 0U)
     {
-        if (!cy_retarget_io_is_tx_active())
+        return;
+    }
+    if (cy_retarget_io_tx_high_lane)
+    {
+        cy_retarget_io_ring_t* high = &cy_retarget_io_tx_high_ring;
+        high->tail = cy_retarget_io_ring_advance(high, high->tail, len);
+    }
+    else
+    {
+        cy_retarget_io_tx_at_boundary = cy_retarget_io_tx_pass(len);
+    }
+}
+
+
+#if defined(CY_RETARGET_IO_COMPRESS)
+#if ((CY_RETARGET_IO_COMPRESS_WINDOW & (CY_RETARGET_IO_COMPRESS_WINDOW - 1U)) != 0U) || \
+    (CY_RETARGET_IO_COMPRESS_WINDOW < 512U) || (CY_RETARGET_IO_COMPRESS_WINDOW > 4096U)
+#error "CY_RETARGET_IO_COMPRESS_WINDOW must be a power of two from 512 to 4096"
+#endif
+#if (CY_RETARGET_IO_COMPRESS_SYNC_FRAMES < 1U) || (CY_RETARGET_IO_COMPRESS_SYNC_FRAMES > 255U)
+#error "CY_RETARGET_IO_COMPRESS_SYNC_FRAMES must be from 1 to 255"
+#endif
+
+// Raw bytes encoded into one frame, the payload is at most 2 bytes longer
+#define CY_RETARGET_IO_LZ_BLOCK             (240U)
+#define CY_RETARGET_IO_LZ_FRAME_SIZE        (CY_RETARGET_IO_LZ_BLOCK + 2U + 5U)
+#define CY_RETARGET_IO_LZ_HASH_BITS         (8U)
+#define CY_RETARGET_IO_LZ_MIN_MATCH         (3U)
+#define CY_RETARGET_IO_LZ_MAX_MATCH         (CY_RETARGET_IO_LZ_MIN_MATCH + 7U + 255U)
+#define CY_RETARGET_IO_LZ_MAX_LITERALS      (128U)
+#define CY_RETARGET_IO_LZ_RESET             (0x80U)
+#define CY_RETARGET_IO_LZ_WINDOW_MASK       (CY_RETARGET_IO_COMPRESS_WINDOW - 1U)
+
+// Last bytes taken from the ring buffers, indexed by their position modulo the window size
+static uint8_t cy_retarget_io_lz_window[CY_RETARGET_IO_COMPRESS_WINDOW];
+
+// Low 16 bits of the last position at which each hash of 3 bytes was seen
+static uint16_t cy_retarget_io_lz_table[1U << CY_RETARGET_IO_LZ_HASH_BITS];
+
+// Position of the next byte taken, and the position at which the window was last cleared
+static uint32_t cy_retarget_io_lz_pos  = 0U;
+static uint32_t cy_retarget_io_lz_base = 0U;
+
+// Sequence number of the next frame and frames left before the window is cleared again
+static uint8_t cy_retarget_io_lz_seq        = 0U;
+static uint8_t cy_retarget_io_lz_until_sync = 0U;
+
+// Frame being sent and the number of its bytes sent so far
+static uint8_t cy_retarget_io_lz_frame[CY_RETARGET_IO_LZ_FRAME_SIZE];
+static volatile size_t cy_retarget_io_lz_frame_len  = 0U;
+static volatile size_t cy_retarget_io_lz_frame_sent = 0U;
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_lz_reset
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_lz_reset(void)
+{
+    cy_retarget_io_lz_pos        = 0U;
+    cy_retarget_io_lz_base       = 0U;
+    cy_retarget_io_lz_seq        = 0U;
+    cy_retarget_io_lz_until_sync = 0U;
+    cy_retarget_io_lz_frame_len  = 0U;
+    cy_retarget_io_lz_frame_sent = 0U;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_lz_at
+//--------------------------------------------------------------------------------------------------
+static inline uint8_t cy_retarget_io_lz_at(uint32_t pos)
+{
+    return cy_retarget_io_lz_window[pos & CY_RETARGET_IO_LZ_WINDOW_MASK];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_lz_hash
+//
+// Hashes the 3 bytes starting at pos, which must all have been taken
+//--------------------------------------------------------------------------------------------------
+static inline uint32_t cy_retarget_io_lz_hash(uint32_t pos)
+{
+    uint32_t key = (uint32_t)cy_retarget_io_lz_at(pos) |
+                   ((uint32_t)cy_retarget_io_lz_at(pos + 1U) << 8U) |
+                   ((uint32_t)cy_retarget_io_lz_at(pos + 2U) << 16U);
+    return (uint32_t)(key * 2654435761U) >> (32U - CY_RETARGET_IO_LZ_HASH_BITS);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_lz_take
+//
+// Moves up to CY_RETARGET_IO_LZ_BLOCK bytes from the ring buffers into the window, which releases
+// their space for the producers. Returns the number of bytes taken.
+//--------------------------------------------------------------------------------------------------
+static size_t cy_retarget_io_lz_take(void)
+{
+    size_t taken = 0U;
+    while (taken < CY_RETARGET_IO_LZ_BLOCK)
+    {
+        const uint8_t* data;
+        size_t len = cy_retarget_io_tx_ring_segment(&data);
+        if (len == 0U)
         {
             break;
         }
-        while (--cycle_time_ms > 0)
+        if (len > (CY_RETARGET_IO_LZ_BLOCK - taken))
+        {
+            len = CY_RETARGET_IO_LZ_BLOCK - taken;
+        }
+        uint32_t pos = cy_retarget_io_lz_pos + (uint32_t)taken;
+        for (size_t i = 0U; i < len; ++i)
         {
+            cy_retarget_io_lz_window[(pos + i) & CY_RETARGET_IO_LZ_WINDOW_MASK] = data[i];
         }
-        timeout_remaining_ms--;
+        cy_retarget_io_tx_ring_consume(len);
+        taken += len;
     }
-    CY_ASSERT(timeout_remaining_ms != 0);
-    cy_retarget_io_mutex_deinit();
+    return taken;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_lz_literals
+//
+// Writes a literal token for the count bytes taken at pos and returns the new end of the payload
+//--------------------------------------------------------------------------------------------------
+static uint8_t* cy_retarget_io_lz_literals(uint8_t* out, uint32_t pos, size_t count)
+{
+    if (count != 0U)
+    {
+        *out++ = (uint8_t)(count - 1U);
+        for (size_t i = 0U; i < count; ++i)
+        {
+            *out++ = cy_retarget_io_lz_at(pos + (uint32_t)i);
+        }
+    }
+    return out;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_lz_encode
+//
+// Encodes the bytes taken from start to end into out and returns the end of the payload. Matches
+// are searched at the last position with the same hash only, and refer to bytes taken since the
+// window was cleared that the bytes of this frame have not overwritten.
+//--------------------------------------------------------------------------------------------------
+static uint8_t* cy_retarget_io_lz_encode(uint8_t* out, uint32_t start, uint32_t end)
+{
+    uint32_t literals = start;
+    uint32_t pos      = start;
+    while (pos < end)
+    {
+        uint32_t len = 0U;
+        uint32_t distance = 0U;
+        if ((end - pos) >= CY_RETARGET_IO_LZ_MIN_MATCH)
+        {
+            uint32_t hash  = cy_retarget_io_lz_hash(pos);
+            uint32_t limit = CY_RETARGET_IO_COMPRESS_WINDOW - (end - pos);
+            if (limit > (pos - cy_retarget_io_lz_base))
+            {
+                limit = pos - cy_retarget_io_lz_base;
+            }
+            distance = (uint16_t)((uint16_t)pos - cy_retarget_io_lz_table[hash]);
+            cy_retarget_io_lz_table[hash] = (uint16_t)pos;
+            if ((distance != 0U) && (distance <= limit))
+            {
+                uint32_t max = end - pos;
+                if (max > CY_RETARGET_IO_LZ_MAX_MATCH)
+                {
+                    max = CY_RETARGET_IO_LZ_MAX_MATCH;
+                }
+                while ((len < max) &&
+                       (cy_retarget_io_lz_at(pos + len - distance) ==
+                        cy_retarget_io_lz_at(pos + len)))
+                {
+                    ++len;
+                }
+            }
+        }
+
+        if (len < CY_RETARGET_IO_LZ_MIN_MATCH)
+        {
+            ++pos;
+            if ((pos - literals) == CY_RETARGET_IO_LZ_MAX_LITERALS)
+            {
+                out      = cy_retarget_io_lz_literals(out, literals, pos - literals);
+                literals = pos;
+            }
+        }
+        else
+        {
+            out = cy_retarget_io_lz_literals(out, literals, pos - literals);
+            uint32_t code = len - CY_RETARGET_IO_LZ_MIN_MATCH;
+            uint32_t field = (code < 7U) ? code : 7U;
+            *out++ = (uint8_t)(0x80U | (field << 4U) | ((distance - 1U) >> 8U));
+            *out++ = (uint8_t)(distance - 1U);
+            if (field == 7U)
+            {
+                *out++ = (uint8_t)(code - 7U);
+            }
+            // Index the positions inside the match as well, for the matches of the next lines
+            for (uint32_t i = 1U; (i < len) && ((end - (pos + i)) >= CY_RETARGET_IO_LZ_MIN_MATCH);
+                 ++i)
+            {
+                cy_retarget_io_lz_table[cy_retarget_io_lz_hash(pos + i)] = (uint16_t)(pos + i);
+            }
+            pos     += len;
+            literals = pos;
+        }
+    }
+    return cy_retarget_io_lz_literals(out, literals, pos - literals);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_lz_frame_next
+//
+// Encodes the data waiting in the ring buffers into the next frame. Leaves the frame empty if
+// there is none.
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_lz_frame_next(void)
+{
+    uint8_t* frame = cy_retarget_io_lz_frame;
+    uint32_t start = cy_retarget_io_lz_pos;
+    size_t   taken = cy_retarget_io_lz_take();
+
+    cy_retarget_io_lz_frame_sent = 0U;
+    cy_retarget_io_lz_frame_len  = 0U;
+    if (taken == 0U)
+    {
+        return;
+    }
+
+    uint8_t flags = (uint8_t)(cy_retarget_io_lz_seq & 0x7FU);
+    if (cy_retarget_io_lz_until_sync == 0U)
+    {
+        // Lets a decoder that lost data resume at this frame
+        cy_retarget_io_lz_base       = start;
+        cy_retarget_io_lz_until_sync = CY_RETARGET_IO_COMPRESS_SYNC_FRAMES;
+        flags |= CY_RETARGET_IO_LZ_RESET;
+    }
+    --cy_retarget_io_lz_until_sync;
+    ++cy_retarget_io_lz_seq;
+    cy_retarget_io_lz_pos = start + (uint32_t)taken;
+
+    uint8_t* end = cy_retarget_io_lz_encode(&frame[3], start, cy_retarget_io_lz_pos);
+    size_t   len = (size_t)(end - &frame[3]);
+    frame[0] = CY_RETARGET_IO_COMPRESS_MARKER;
+    frame[1] = flags;
+    frame[2] = (uint8_t)len;
+
+    uint8_t sum   = 0U;
+    uint8_t check = 0U;
+    for (size_t i = 1U; i < (len + 3U); ++i)
+    {
+        sum   = (uint8_t)(sum + frame[i]);
+        check = (uint8_t)(check + sum);
+    }
+    frame[len + 3U] = sum;
+    frame[len + 4U] = check;
+    cy_retarget_io_lz_frame_len = len + 5U;
+    CY_RETARGET_IO_STATS_COUNT(tx_compress_in, taken);
+    CY_RETARGET_IO_STATS_COUNT(tx_compress_out, len + 5U);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_next_segment
+//
+// Consumer side: returns the next contiguous segment to send, the rest of the current frame. Once
+// it has been sent, the data waiting in the ring buffers is encoded into the next frame.
+//--------------------------------------------------------------------------------------------------
+static size_t cy_retarget_io_tx_next_segment(const uint8_t** data)
+{
+    if (cy_retarget_io_lz_frame_sent == cy_retarget_io_lz_frame_len)
+    {
+        cy_retarget_io_lz_frame_next();
+    }
+    *data = &cy_retarget_io_lz_frame[cy_retarget_io_lz_frame_sent];
+    return cy_retarget_io_lz_frame_len - cy_retarget_io_lz_frame_sent;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_consume
+//
+// Consumer side: releases len bytes of the segment returned by cy_retarget_io_tx_next_segment
+//--------------------------------------------------------------------------------------------------
+static inline void cy_retarget_io_tx_consume(size_t len)
+{
+    cy_retarget_io_lz_frame_sent += len;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_frame_pending
+//
+// Consumer side: checks whether a frame is still being sent
+//--------------------------------------------------------------------------------------------------
+static inline bool cy_retarget_io_tx_frame_pending(void)
+{
+    return cy_retarget_io_lz_frame_sent != cy_retarget_io_lz_frame_len;
+}
+
+
+#else // if defined(CY_RETARGET_IO_COMPRESS)
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_next_segment
+//
+// Consumer side: returns the next contiguous segment to send
+//--------------------------------------------------------------------------------------------------
+static inline size_t cy_retarget_io_tx_next_segment(const uint8_t** data)
+{
+    return cy_retarget_io_tx_ring_segment(data);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_consume
+//
+// Consumer side: releases len bytes of the segment returned by cy_retarget_io_tx_next_segment
+//--------------------------------------------------------------------------------------------------
+static inline void cy_retarget_io_tx_consume(size_t len)
+{
+    cy_retarget_io_tx_ring_consume(len);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_frame_pending
+//--------------------------------------------------------------------------------------------------
+static inline bool cy_retarget_io_tx_frame_pending(void)
+{
+    return false;
+}
+
+
+#endif // if defined(CY_RETARGET_IO_COMPRESS)
+
+
+#if defined(CY_RETARGET_IO_RTOS_WAIT)
+// Maximum number of tasks woken up by one signal
+#define CY_RETARGET_IO_WAITER_MAX_TOKENS    (16U)
+
+// Semaphore the tasks block on until the interrupt signals progress
+typedef struct
+{
+    cy_semaphore_t    semaphore;
+    volatile uint32_t waiting;  // Incremented by every task before it blocks, reset by the signal
+    bool              initialized;
+} cy_retarget_io_waiter_t;
+
+static cy_retarget_io_waiter_t cy_retarget_io_tx_waiter;
+static cy_retarget_io_waiter_t cy_retarget_io_tx_high_waiter;
+static cy_retarget_io_waiter_t cy_retarget_io_tx_open_waiter;
+static cy_retarget_io_waiter_t cy_retarget_io_rx_waiter;
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_waiter_init
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_retarget_io_waiter_init(cy_retarget_io_waiter_t* waiter)
+{
+    cy_rslt_t rslt = CY_RSLT_SUCCESS;
+    waiter->waiting = 0U;
+    if (!waiter->initialized)
+    {
+        rslt = cy_rtos_init_semaphore(&waiter->semaphore, CY_RETARGET_IO_WAITER_MAX_TOKENS, 0U);
+        waiter->initialized = (CY_RSLT_SUCCESS == rslt);
+    }
+    return rslt;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_waiter_deinit
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_waiter_deinit(cy_retarget_io_waiter_t* waiter)
+{
+    if (waiter->initialized)
+    {
+        (void)cy_rtos_deinit_semaphore(&waiter->semaphore);
+        waiter->initialized = false;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_waiter_can_block
+//
+// Blocking is only possible from a task with interrupts enabled, ISRs and code running with
+// interrupts masked fall back to polling.
+//--------------------------------------------------------------------------------------------------
+static inline bool cy_retarget_io_waiter_can_block(const cy_retarget_io_waiter_t* waiter)
+{
+    return waiter->initialized && (__get_IPSR() == 0U) && (__get_PRIMASK() == 0U);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_waiter_wait
+//
+// Blocks until signalled or timeout_ms has passed, unless the condition was met meanwhile. The
+// caller re-checks its condition afterwards, so a stale signal, also one left behind by a wait that
+// timed out, only costs one extra check.
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_waiter_wait(cy_retarget_io_waiter_t* waiter, bool (*done)(void),
+                                       cy_time_t timeout_ms)
+{
+    uint32_t waiting;
+    do
+    {
+        waiting = waiter->waiting;
+    } while (!cy_retarget_io_atomic_cas(&waiter->waiting, waiting, waiting + 1U));
+
+    if (!done())
+    {
+        (void)cy_rtos_get_semaphore(&waiter->semaphore, timeout_ms, false);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_waiter_signal
+//--------------------------------------------------------------------------------------------------
+static inline void cy_retarget_io_waiter_signal(cy_retarget_io_waiter_t* waiter)
+{
+    // Also called from tasks, which a task that starts to wait can preempt
+    uint32_t waiting = waiter->waiting;
+    if (waiting > CY_RETARGET_IO_WAITER_MAX_TOKENS)
+    {
+        waiting = CY_RETARGET_IO_WAITER_MAX_TOKENS;
+    }
+    cy_retarget_io_atomic_add(&waiter->waiting, 0U - waiting);
+    bool in_isr = (__get_IPSR() != 0U);
+    for (; waiting > 0U; --waiting)
+    {
+        (void)cy_rtos_set_semaphore(&waiter->semaphore, in_isr);
+    }
+}
+
+
+#endif // defined(CY_RETARGET_IO_RTOS_WAIT)
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_high_used
+//
+// Number of bytes reserved in the high priority lane and not sent yet
+//--------------------------------------------------------------------------------------------------
+static inline size_t cy_retarget_io_tx_high_used(void)
+{
+    return cy_retarget_io_ring_distance(&cy_retarget_io_tx_high_ring,
+                                        cy_retarget_io_tx_high_ring.tail,
+                                        cy_retarget_io_tx_high_reserved);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_notify
+//
+// Wakes up the tasks waiting for transmit space once half of the ring buffer or all of the high
+// priority lane is free, so they are not woken up for every single byte sent.
+//--------------------------------------------------------------------------------------------------
+static inline void cy_retarget_io_tx_notify(void)
+{
+    #if defined(CY_RETARGET_IO_RTOS_WAIT)
+    if ((cy_retarget_io_tx_waiter.waiting != 0U) &&
+        (cy_retarget_io_tx_used() <= (cy_retarget_io_tx_ring.size / 2U)))
+    {
+        cy_retarget_io_waiter_signal(&cy_retarget_io_tx_waiter);
+    }
+    if ((cy_retarget_io_tx_high_waiter.waiting != 0U) &&
+        (cy_retarget_io_tx_high_used() == 0U))
+    {
+        cy_retarget_io_waiter_signal(&cy_retarget_io_tx_high_waiter);
+    }
+    #endif
+}
+
+
+#if (UC_FAMILY == XMC4)
+// Largest block size of a single block GPDMA transfer
+#define CY_RETARGET_IO_DMA_MAX_BLOCK_SIZE   (4095U)
+
+// GPDMA0 channel draining the transmit ring buffer, negative when DMA is not used
+static int8_t cy_retarget_io_dma_channel = -1;
+
+// Length of the block currently transferred by the DMA, 0 when the channel is idle
+static volatile size_t cy_retarget_io_dma_len = 0U;
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_dma_start
+//
+// Hands the next contiguous segment of the ring buffer to the DMA. Must be called with interrupts
+// masked while the DMA channel is idle.
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_dma_start(void)
+{
+    const uint8_t* data;
+    size_t len = cy_retarget_io_tx_next_segment(&data);
+    if (len > CY_RETARGET_IO_DMA_MAX_BLOCK_SIZE)
+    {
+        len = CY_RETARGET_IO_DMA_MAX_BLOCK_SIZE;
+    }
+
+    cy_retarget_io_dma_len    = len;
+    cy_retarget_io_tx_running = (len != 0U);
+    if (len != 0U)
+    {
+        uint8_t channel = (uint8_t)cy_retarget_io_dma_channel;
+        XMC_DMA_CH_SetSourceAddress(XMC_DMA0, channel, (uint32_t)(uintptr_t)data);
+        XMC_DMA_CH_SetBlockSize(XMC_DMA0, channel, (uint32_t)len);
+        XMC_DMA_CH_Enable(XMC_DMA0, channel);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_dma_service
+//
+// Releases the segment of a finished DMA transfer and chains the next one. Safe to call at any
+// time, it does nothing while a transfer is still in progress.
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_dma_service(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    size_t len = cy_retarget_io_dma_len;
+    if ((len != 0U) && !XMC_DMA_CH_IsEnabled(XMC_DMA0, (uint8_t)cy_retarget_io_dma_channel))
+    {
+        cy_retarget_io_tx_consume(len);
+        cy_retarget_io_dma_start();
+        cy_retarget_io_tx_notify();
+    }
+    __set_PRIMASK(primask);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_dma_event_handler
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_dma_event_handler(XMC_DMA_CH_EVENT_t event)
+{
+    (void)event;
+    cy_retarget_io_dma_service();
+}
+
+
+#endif // (UC_FAMILY == XMC4)
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_kick
+//
+// Restarts the interrupt if it stopped draining the ring buffer. Must be called after new data has
+// been completed in the ring buffer, so the interrupt either sees it or has already stopped.
+//--------------------------------------------------------------------------------------------------
+static inline void cy_retarget_io_tx_kick(void)
+{
+    #if (UC_FAMILY == XMC4)
+    if (cy_retarget_io_dma_channel >= 0)
+    {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        if (cy_retarget_io_dma_len == 0U)
+        {
+            cy_retarget_io_dma_start();
+        }
+        __set_PRIMASK(primask);
+        return;
+    }
+    #endif // (UC_FAMILY == XMC4)
+
+    if (!cy_retarget_io_tx_running)
+    {
+        cy_retarget_io_tx_running = true;
+        XMC_USIC_CH_TriggerServiceRequest(cy_retarget_io_uart_obj.channel, CY_RETARGET_IO_SR);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_stop_if_empty
+//
+// Called by the interrupt when it has nothing left to send. The check and the update are done with
+// interrupts masked so a producer preempting the handler cannot commit data without a new kick.
+//--------------------------------------------------------------------------------------------------
+static inline bool cy_retarget_io_tx_stop_if_empty(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    size_t head    = cy_retarget_io_tx_update_head();
+    bool   stopped = (head == cy_retarget_io_tx_ring.tail) &&
+                     ((cy_retarget_io_tx_high_ring.buffer == NULL) ||
+                      cy_retarget_io_ring_is_empty(&cy_retarget_io_tx_high_ring)) &&
+                     !cy_retarget_io_tx_frame_pending();
+    if (stopped)
+    {
+        cy_retarget_io_tx_running = false;
+    }
+    __set_PRIMASK(primask);
+    return stopped;
+}
+
+
+// Measures waiting times in core clock cycles
+typedef struct
+{
+    uint32_t last;    // Counter value at the previous sample
+    uint64_t elapsed; // Cycles counted since the start
+    uint32_t started; // Enable bits set by cy_retarget_io_cycles_start, cleared again at the end
+} cy_retarget_io_cycles_t;
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_cycles_start
+//
+// Cortex-M3/M4 use the DWT cycle counter. Cortex-M0 has none, there SysTick is sampled. If it is
+// not running, it is started without interrupt on the core clock until cy_retarget_io_cycles_stop.
+// Only the enable bits set here are remembered, other code may use the counters meanwhile.
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_cycles_start(cy_retarget_io_cycles_t* cycles)
+{
+    #if (__CORTEX_M >= 3U)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    cycles->started   = (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) ^ DWT_CTRL_CYCCNTENA_Msk;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+    cycles->last      = DWT->CYCCNT;
+    #else
+    cycles->started = 0U;
+    if ((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) == 0U)
+    {
+        SysTick->LOAD   = SysTick_LOAD_RELOAD_Msk;
+        SysTick->VAL    = 0U;
+        SysTick->CTRL   = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+        cycles->started = SysTick_CTRL_ENABLE_Msk;
+    }
+    cycles->last = SysTick->VAL;
+    #endif // if (__CORTEX_M >= 3U)
+    cycles->elapsed = 0U;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_cycles_sample
+//
+// Returns the cycles elapsed since cy_retarget_io_cycles_start. Must be called more often than the
+// counter wraps around, which is at least every 2^24 cycles with SysTick.
+//--------------------------------------------------------------------------------------------------
+static uint64_t cy_retarget_io_cycles_sample(cy_retarget_io_cycles_t* cycles)
+{
+    #if (__CORTEX_M >= 3U)
+    uint32_t now = DWT->CYCCNT;
+    cycles->elapsed += (uint32_t)(now - cycles->last);
+    #else
+    // SysTick counts down from LOAD to 0
+    uint32_t now = SysTick->VAL;
+    cycles->elapsed += (now <= cycles->last)
+        ? (cycles->last - now)
+        : ((cycles->last + (SysTick->LOAD & SysTick_LOAD_RELOAD_Msk) + 1U) - now);
+    #endif // if (__CORTEX_M >= 3U)
+    cycles->last = now;
+    return cycles->elapsed;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_cycles_stop
+//
+// Stops the counters cy_retarget_io_cycles_start started. SysTick is left running if it was set up
+// for another use meanwhile, e.g. by an RTOS that was started.
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_cycles_stop(const cy_retarget_io_cycles_t* cycles)
+{
+    #if (__CORTEX_M >= 3U)
+    DWT->CTRL &= ~cycles->started;
+    #else
+    const uint32_t own = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+    if ((cycles->started != 0U) &&
+        ((SysTick->CTRL & (own | SysTick_CTRL_TICKINT_Msk)) == own) &&
+        ((SysTick->LOAD & SysTick_LOAD_RELOAD_Msk) == SysTick_LOAD_RELOAD_Msk))
+    {
+        SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    }
+    #endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_us_to_cycles
+//
+// Converts microseconds into core clock cycles, exact for clocks that are no whole MHz. The parts
+// are multiplied separately, so that 2^32 ms at any clock do not overflow.
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t cy_retarget_io_us_to_cycles(uint64_t us)
+{
+    return (us * (SystemCoreClock / 1000000U)) +
+           ((us * (SystemCoreClock % 1000000U)) / 1000000U);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_cycles_to_us
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t cy_retarget_io_cycles_to_us(uint64_t cycles)
+{
+    return ((cycles / SystemCoreClock) * 1000000U) +
+           (((cycles % SystemCoreClock) * 1000000U) / SystemCoreClock);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_sleep
+//
+// Sleeps until the next interrupt while the transmit interrupt or the DMA drains the ring buffers,
+// instead of polling. The check is done with interrupts masked, and WFI wakes up on a pending
+// interrupt even then, so the interrupt that ends the transmission cannot be missed. Not done in
+// interrupts or with the interrupt masked by BASEPRI, where it may not be able to wake the core.
+// cycles, if not NULL, is sampled right before the sleep. A wait that the SysTick interrupt ends
+// then lasts less than a SysTick period, which the count of Cortex-M0 can tell from no time.
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_tx_sleep(cy_retarget_io_cycles_t* cycles)
+{
+    #if !defined(CY_RETARGET_IO_NO_SLEEP)
+    #if (__CORTEX_M >= 3U)
+    bool masked = (__get_BASEPRI() != 0U);
+    #else
+    bool masked = false;
+    #endif
+    if ((__get_IPSR() == 0U) && (__get_PRIMASK() == 0U) && !masked)
+    {
+        __disable_irq();
+        bool draining = cy_retarget_io_tx_running;
+        #if (UC_FAMILY == XMC4)
+        draining = draining || (cy_retarget_io_dma_len != 0U);
+        #endif
+        if (draining)
+        {
+            if (cycles != NULL)
+            {
+                (void)cy_retarget_io_cycles_sample(cycles);
+            }
+            __WFI();
+        }
+        __enable_irq();
+    }
+    #else
+    (void)cycles;
+    #endif // !defined(CY_RETARGET_IO_NO_SLEEP)
+}
+
+
+static void cy_retarget_io_tx_service(void);
+static void cy_retarget_io_rx_service(void);
+
+#if defined(CY_RETARGET_IO_RTOS_WAIT)
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_has_space
+//
+// Writes are split into chunks of at most half the ring buffer, so any chunk fits once half of the
+// ring buffer is free.
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_tx_has_space(void)
+{
+    return cy_retarget_io_tx_used() <= (cy_retarget_io_tx_ring.size / 2U);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_high_is_empty
+//
+// A chunk of the high priority lane may take all of it, so its writers wait until it is empty. The
+// lane is sent first, that only takes as long as sending its own backlog.
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_tx_high_is_empty(void)
+{
+    return cy_retarget_io_tx_high_used() == 0U;
+}
+
+
+#endif // defined(CY_RETARGET_IO_RTOS_WAIT)
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_is_drained
+//
+// Whether the ring buffers hold no more output of the buffered mode, the USIC channel may still be
+// sending the last characters
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_tx_is_drained(void)
+{
+    return (cy_retarget_io_tx_used() == 0U) &&
+           ((cy_retarget_io_tx_high_ring.buffer == NULL) ||
+            cy_retarget_io_ring_is_empty(&cy_retarget_io_tx_high_ring)) &&
+           !cy_retarget_io_tx_frame_pending();
+}
+
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_rx_has_data
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_rx_has_data(void)
+{
+    return cy_retarget_io_rx_ring.head != cy_retarget_io_rx_seen;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_reserve
+//
+// Claims len contiguous bytes of the transmit ring buffer and registers the caller as an active
+// producer. Returns false without side effects if there is not enough space.
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_tx_reserve(size_t len, size_t* start)
+{
+    const cy_retarget_io_ring_t* ring = &cy_retarget_io_tx_ring;
+    uint32_t state;
+    uint32_t next;
+    do
+    {
+        state = cy_retarget_io_tx_state;
+        if ((state & CY_RETARGET_IO_TX_OPEN) != 0U)
+        {
+            return false;
+        }
+        size_t reserved = state & CY_RETARGET_IO_TX_RESERVED_Msk;
+        size_t used     = cy_retarget_io_ring_distance(ring, ring->tail, reserved);
+        if ((ring->size - 1U - used) < len)
+        {
+            return false;
+        }
+        *start = reserved;
+        next   = ((state & ~CY_RETARGET_IO_TX_RESERVED_Msk) + CY_RETARGET_IO_TX_WRITER) |
+                 (uint32_t)cy_retarget_io_ring_advance(ring, reserved, len);
+    } while (!cy_retarget_io_atomic_cas(&cy_retarget_io_tx_state, state, next));
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_complete
+//
+// Unregisters the caller as an active producer. The last producer to finish makes all reserved
+// data visible to the consumer, so none of them ever has to wait for another one.
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_tx_complete(void)
+{
+    uint32_t state;
+
+    // The copied data must be in memory before the consumer can see it
+    __DMB();
+    do
+    {
+        state = cy_retarget_io_tx_state;
+    } while (!cy_retarget_io_atomic_cas(&cy_retarget_io_tx_state, state,
+                                        state - CY_RETARGET_IO_TX_WRITER));
+
+    if (((state - CY_RETARGET_IO_TX_WRITER) & CY_RETARGET_IO_TX_WRITERS_Msk) == 0U)
+    {
+        cy_retarget_io_tx_kick();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_wait
+//
+// Waits until the consumer has freed space in the transmit ring buffer
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_tx_wait(void)
+{
+    CY_RETARGET_IO_STATS_START(start);
+    #if defined(CY_RETARGET_IO_RTOS_WAIT)
+    if (cy_retarget_io_waiter_can_block(&cy_retarget_io_tx_waiter))
+    {
+        cy_retarget_io_waiter_wait(&cy_retarget_io_tx_waiter, cy_retarget_io_tx_has_space,
+                                   CY_RTOS_NEVER_TIMEOUT);
+    }
+    else
+    #endif
+    // If interrupts are masked by the caller the handler cannot run, so drain the channel directly
+    if (__get_PRIMASK() != 0U)
+    {
+        cy_retarget_io_tx_service();
+    }
+    else
+    {
+        cy_retarget_io_tx_sleep(NULL);
+    }
+    CY_RETARGET_IO_STATS_CYCLES(tx_blocked_cycles, start);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_drop_oldest
+//
+// Discards the oldest complete records in the transmit ring buffer so that at least len bytes
+// become free. Only whole records up to a boundary noted by the producers are discarded: a line,
+// or a binary write as a whole. If the tail is inside a record already partly sent, its rest is
+// kept and moved up to the discarded space, so the receiver never sees a record cut short. This
+// moves the tail, so it is only done while the consumer is not using it: not while
+// cy_retarget_io_tx_service is running (the caller may have preempted it) and not while a DMA
+// transfer is reading from the tail. Returns false if nothing was discarded, also if the noted
+// boundaries do not cover enough space.
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_tx_drop_oldest(size_t len)
+{
+    cy_retarget_io_ring_t* ring = &cy_retarget_io_tx_ring;
+    bool     dropped = false;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    bool idle = !cy_retarget_io_tx_in_service;
+    #if (UC_FAMILY == XMC4)
+    idle = idle && (cy_retarget_io_dma_len == 0U);
+    #endif
+    size_t head = idle ? cy_retarget_io_tx_update_head() : 0U;
+    size_t tail = ring->tail;
+    size_t used = cy_retarget_io_ring_distance(ring, tail, head);
+    size_t free = cy_retarget_io_tx_free();
+    size_t keep = 0U;
+    size_t end  = SIZE_MAX;
+    if (idle && (free < len))
+    {
+        // The rest of the record being sent ends at the closest boundary, and the discarded records
+        // at the closest one that makes enough space after it
+        size_t need = len - free;
+        if (!cy_retarget_io_tx_at_boundary)
+        {
+            keep = cy_retarget_io_tx_next_record(used);
+        }
+        for (uint32_t i = 0U; (keep != SIZE_MAX) && (i < cy_retarget_io_tx_record_count); ++i)
+        {
+            size_t d = cy_retarget_io_ring_distance(ring, tail, cy_retarget_io_tx_records[i]);
+            if ((d <= used) && (d >= (keep + need)) && (d < end))
+            {
+                end = d;
+            }
+        }
+    }
+    if (end != SIZE_MAX)
+    {
+        for (size_t i = keep; i > 0U; --i)
+        {
+            ring->buffer[cy_retarget_io_ring_advance(ring, tail, (end - keep) + i - 1U)] =
+                ring->buffer[cy_retarget_io_ring_advance(ring, tail, i - 1U)];
+        }
+        uint32_t i = 0U;
+        while (i < cy_retarget_io_tx_record_count)
+        {
+            size_t d = cy_retarget_io_ring_distance(ring, tail, cy_retarget_io_tx_records[i]);
+            // The boundary at end stays the end of the moved rest, if there is one
+            if ((d < end) || ((d == end) && (keep == 0U)))
+            {
+                cy_retarget_io_tx_records[i] =
+                    cy_retarget_io_tx_records[--cy_retarget_io_tx_record_count];
+            }
+            else
+            {
+                ++i;
+            }
+        }
+        ring->tail = cy_retarget_io_ring_advance(ring, tail, end - keep);
+        cy_retarget_io_tx_at_boundary = (keep == 0U);
+        cy_retarget_io_atomic_add(&cy_retarget_io_tx_dropped, (uint32_t)(end - keep));
+        dropped = true;
+    }
+
+    __set_PRIMASK(primask);
+    return dropped;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_can_reserve
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_tx_can_reserve(void)
+{
+    return (cy_retarget_io_tx_state & CY_RETARGET_IO_TX_OPEN) == 0U;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_set_owner
+//
+// Notes the caller as the holder of the ring with held set, clears the holder otherwise. Called
+// after the ring is opened and before it is reopened, meanwhile a stale holder is never the caller.
+//--------------------------------------------------------------------------------------------------
+static inline void cy_retarget_io_tx_set_owner(bool held)
+{
+    #if defined(CY_RETARGET_IO_RTOS_WAIT)
+    cy_thread_t self = NULL;
+    if (held && (__get_IPSR() == 0U) && (cy_rtos_get_thread_handle(&self) != CY_RSLT_SUCCESS))
+    {
+        self = NULL;
+    }
+    cy_retarget_io_tx_open_owner = self;
+    #else
+    (void)held;
+    #endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_open_notify
+//
+// Wakes up the tasks waiting for the ring to be reopened, called once CY_RETARGET_IO_TX_OPEN is
+// cleared
+//--------------------------------------------------------------------------------------------------
+static inline void cy_retarget_io_tx_open_notify(void)
+{
+    #if defined(CY_RETARGET_IO_RTOS_WAIT)
+    if (cy_retarget_io_tx_open_waiter.waiting != 0U)
+    {
+        cy_retarget_io_waiter_signal(&cy_retarget_io_tx_open_waiter);
+    }
+    #endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_wait_open
+//
+// Waits until the region handed out by cy_retarget_io_reserve is committed or the ring closed by
+// cy_retarget_io_set_baudrate is reopened. Tasks block on a semaphore signalled then, which does
+// not depend on the mutex, itself a no-op with some toolchains. Returns false if the caller cannot
+// wait and has to drop its output: in an interrupt, which may have preempted the holder, with
+// interrupts masked, without an RTOS where no other task can reopen the ring, and in the task
+// holding the ring itself.
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_tx_wait_open(void)
+{
+    #if defined(CY_RETARGET_IO_RTOS_WAIT)
+    cy_thread_t self = NULL;
+    if (cy_retarget_io_waiter_can_block(&cy_retarget_io_tx_open_waiter) &&
+        (cy_rtos_get_thread_handle(&self) == CY_RSLT_SUCCESS) &&
+        (self != cy_retarget_io_tx_open_owner))
+    {
+        cy_retarget_io_waiter_wait(&cy_retarget_io_tx_open_waiter, cy_retarget_io_tx_can_reserve,
+                                   CY_RTOS_NEVER_TIMEOUT);
+        return true;
+    }
+    #endif
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_wait_open_unlocked
+//
+// cy_retarget_io_tx_wait_open for a caller holding the mutex, which is released meanwhile: the
+// task that reopens a ring closed by cy_retarget_io_set_baudrate takes it again first
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_tx_wait_open_unlocked(void)
+{
+    cy_retarget_io_mutex_release();
+    bool opened = cy_retarget_io_tx_wait_open();
+    cy_retarget_io_mutex_acquire();
+    return opened;
+}
+
+
+// Every output path runs the data through the same pipeline: the transform stage converts the
+// line terminators and stamps the lines, the enqueue stage copies the result into a ring buffer or
+// the USIC channel and the drain stage is the interrupt, the DMA or the polling caller. The
+// transform is specialised at compile time, without conversion and stamps the whole input is a
+// single span and its code is removed.
+#ifdef CY_RETARGET_IO_CONVERT_LF_TO_CRLF
+#define CY_RETARGET_IO_TX_CONVERT           (true)
+#else
+#define CY_RETARGET_IO_TX_CONVERT           (false)
+#endif
+#if defined(CY_RETARGET_IO_TX_LINES)
+#define CY_RETARGET_IO_TX_TRANSFORM         (true)
+#else
+#define CY_RETARGET_IO_TX_TRANSFORM         (false)
+#endif
+
+// Smallest transmit ring buffer, a line stamp must fit together with a CR & LF
+#if defined(CY_RETARGET_IO_LINE_STAMP)
+#define CY_RETARGET_IO_TX_MIN_SIZE          (4U + CY_RETARGET_IO_LINE_STAMP_SIZE)
+#else
+#define CY_RETARGET_IO_TX_MIN_SIZE          (4U)
+#endif
+
+// State of the transform stage for one write
+typedef struct
+{
+    char prev;                                   // Character before the data
+    #if defined(CY_RETARGET_IO_LINE_STAMP)
+    char header[CY_RETARGET_IO_LINE_STAMP_SIZE]; // Inserted at the start of each line
+    #endif
+} cy_retarget_io_out_t;
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_out_span
+//
+// Transform stage: returns the length of the span at the start of ptr that is sent unchanged.
+// Unless the span reaches len, it is followed by an LF that is replaced by cy_retarget_io_out_eol.
+//--------------------------------------------------------------------------------------------------
+static inline size_t cy_retarget_io_out_span(const char* ptr, size_t len)
+{
+    #if defined(CY_RETARGET_IO_TX_LINES)
+    return cy_retarget_io_find_lf(ptr, len);
+    #else
+    (void)ptr;
+    return len;
+    #endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_out_eol
+//
+// Transform stage: returns the line terminator sent for an LF that follows the character before,
+// *len is set to its length. No CR is added if the LF already follows one.
+//--------------------------------------------------------------------------------------------------
+static inline const char* cy_retarget_io_out_eol(char before, size_t* len)
+{
+    static const char crlf[] = "\r\n";
+    *len = (CY_RETARGET_IO_TX_CONVERT && (before != '\r')) ? 2U : 1U;
+    return &crlf[2U - *len];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_out_begin
+//
+// Transform stage: sets up a write that follows the character prev. The line stamp is taken here,
+// so all lines started by the write carry the time it was called.
+//--------------------------------------------------------------------------------------------------
+static inline void cy_retarget_io_out_begin(cy_retarget_io_out_t* out, char prev)
+{
+    out->prev = prev;
+    #if defined(CY_RETARGET_IO_LINE_STAMP)
+    uint32_t stamp = cy_retarget_io_get_timestamp();
+    #if ((CY_RETARGET_IO_LINE_STAMP + 0) == CY_RETARGET_IO_LINE_STAMP_BINARY)
+    out->header[0] = (char)CY_RETARGET_IO_LINE_STAMP_MARKER;
+    for (size_t i = 1U; i < CY_RETARGET_IO_LINE_STAMP_SIZE; ++i)
+    {
+        out->header[i] = (char)(uint8_t)stamp;
+        stamp        >>= 8U;
+    }
+    #else
+    static const char digits[] = "0123456789abcdef";
+    for (size_t i = CY_RETARGET_IO_LINE_STAMP_SIZE - 1U; i > 0U; --i)
+    {
+        out->header[i - 1U] = digits[stamp & 0xFU];
+        stamp             >>= 4U;
+    }
+    out->header[CY_RETARGET_IO_LINE_STAMP_SIZE - 1U] = ' ';
+    #endif
+    #endif // defined(CY_RETARGET_IO_LINE_STAMP)
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_out_header
+//
+// Transform stage: returns the header inserted before ptr[i], *len is set to its length, 0 unless
+// ptr[i] starts a line
+//--------------------------------------------------------------------------------------------------
+static inline const char* cy_retarget_io_out_header(const cy_retarget_io_out_t* out,
+                                                    const char* ptr, size_t i, size_t* len)
+{
+    #if defined(CY_RETARGET_IO_LINE_STAMP)
+    *len = ((((i > 0U) ? ptr[i - 1U] : out->prev) == '\n')) ? CY_RETARGET_IO_LINE_STAMP_SIZE : 0U;
+    return out->header;
+    #else
+    (void)out;
+    (void)ptr;
+    (void)i;
+    *len = 0U;
+    return NULL;
+    #endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_out_track
+//
+// Transform stage: remembers the last character written to a stream, the next write depends on it
+//--------------------------------------------------------------------------------------------------
+static inline void cy_retarget_io_out_track(char* prev, const char* ptr, size_t len)
+{
+    if (CY_RETARGET_IO_TX_TRANSFORM && (len > 0U))
+    {
+        *prev = ptr[len - 1U];
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_out_measure
+//
+// Shortens *len to the longest prefix whose transformed length fits into max bytes and returns the
+// transformed length of that prefix. A header is only taken together with the first character or
+// line terminator of its line, and at least that much is always taken.
+//--------------------------------------------------------------------------------------------------
+static size_t cy_retarget_io_out_measure(const char* ptr, size_t* len,
+                                         const cy_retarget_io_out_t* out, size_t max)
+{
+    size_t total = 0U;
+    size_t i     = 0U;
+    while (i < *len)
+    {
+        size_t head;
+        size_t eol = 0U;
+        (void)cy_retarget_io_out_header(out, ptr, i, &head);
+        size_t lf  = i + cy_retarget_io_out_span(&ptr[i], *len - i);
+        size_t run = lf - i;
+        if (lf < *len)
+        {
+            (void)cy_retarget_io_out_eol((lf > 0U) ? ptr[lf - 1U] : out->prev, &eol);
+        }
+        if (((total + head + ((run > 0U) ? 1U : eol)) > max) && (i > 0U))
+        {
+            break;
+        }
+        if ((run > 0U) && ((total + head + run) > max))
+        {
+            size_t fit = (max > (total + head)) ? (max - total - head) : 1U;
+            *len = i + fit;
+            return total + head + fit;
+        }
+        total += head + run;
+        i      = lf;
+        if (i == *len)
+        {
+            break;
+        }
+
+        if ((run > 0U) && ((total + eol) > max))
+        {
+            break;
+        }
+        total += eol;
+        ++i;
+    }
+    *len = i;
+    return total;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_out_ring_write
+//
+// Copies len characters into a transmit ring buffer, converting the line terminators and inserting
+// the headers. The spans between two LFs are copied as a whole. Returns the index following the
+// copied data.
+//--------------------------------------------------------------------------------------------------
+static size_t cy_retarget_io_out_ring_write(cy_retarget_io_ring_t* ring, size_t index,
+                                            const char* ptr, size_t len,
+                                            const cy_retarget_io_out_t* out)
+{
+    size_t i = 0U;
+    while (i < len)
+    {
+        size_t      n;
+        const char* header = cy_retarget_io_out_header(out, ptr, i, &n);
+        if (n > 0U)
+        {
+            index = cy_retarget_io_ring_write(ring, index, header, n);
+        }
+        size_t lf = i + cy_retarget_io_out_span(&ptr[i], len - i);
+        index = cy_retarget_io_ring_write(ring, index, &ptr[i], lf - i);
+        if (lf == len)
+        {
+            break;
+        }
+
+        const char* eol = cy_retarget_io_out_eol((lf > 0U) ? ptr[lf - 1U] : out->prev, &n);
+        index = cy_retarget_io_ring_write(ring, index, eol, n);
+        i     = lf + 1U;
+    }
+    return index;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_out_fit
+//
+// Transform stage of the ring buffers: shortens *len to the input whose output fits into max bytes
+// and returns the length of that output. Binary data is passed with convert set to false.
+//--------------------------------------------------------------------------------------------------
+static inline size_t cy_retarget_io_out_fit(const char* ptr, size_t* len,
+                                            const cy_retarget_io_out_t* out, size_t max,
+                                            bool convert)
+{
+    if (CY_RETARGET_IO_TX_TRANSFORM && convert)
+    {
+        return cy_retarget_io_out_measure(ptr, len, out, max);
+    }
+    if (*len > max)
+    {
+        *len = max;
+    }
+    return *len;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_out_enqueue
+//
+// Enqueue stage of the ring buffers: copies the input measured by cy_retarget_io_out_fit to index
+// and returns the index following it.
+//--------------------------------------------------------------------------------------------------
+static inline size_t cy_retarget_io_out_enqueue(cy_retarget_io_ring_t* ring, size_t index,
+                                                const char* ptr, size_t len,
+                                                const cy_retarget_io_out_t* out, bool convert)
+{
+    if (CY_RETARGET_IO_TX_TRANSFORM && convert)
+    {
+        return cy_retarget_io_out_ring_write(ring, index, ptr, len, out);
+    }
+    return cy_retarget_io_ring_write(ring, index, ptr, len);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_out_expand
+//
+// Transforms the first *len characters of buf in place, buf holds cap bytes. Characters moved past
+// cap are dropped. Returns the transformed length and sets *len to the characters kept.
+//--------------------------------------------------------------------------------------------------
+static size_t cy_retarget_io_out_expand(char* buf, size_t* len, size_t cap,
+                                        const cy_retarget_io_out_t* out)
+{
+    if (!CY_RETARGET_IO_TX_TRANSFORM)
+    {
+        return *len;
+    }
+    size_t total = cy_retarget_io_out_measure(buf, len, out, cap);
+    if (total > cap)
+    {
+        // A single line start or LF that does not fit together with its header or CR
+        *len = 0U;
+        return 0U;
+    }
+
+    // Move the characters to their final position from the end on, until nothing is left to insert
+    size_t src = *len;
+    size_t dst = total;
+    while (dst > src)
+    {
+        char   c = buf[--src];
+        size_t n;
+        buf[--dst] = c;
+        if (c == '\n')
+        {
+            // Everything before the LF of the line terminator
+            const char* eol = cy_retarget_io_out_eol((src > 0U) ? buf[src - 1U] : out->prev, &n);
+            for (; n > 1U; --n)
+            {
+                buf[--dst] = eol[n - 2U];
+            }
+        }
+        const char* header = cy_retarget_io_out_header(out, buf, src, &n);
+        for (; n > 0U; --n)
+        {
+            buf[--dst] = header[n - 1U];
+        }
+    }
+    return total;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_prev_char
+//
+// Returns a character of the class the PREV bits of the producer state record
+//--------------------------------------------------------------------------------------------------
+static inline char cy_retarget_io_tx_prev_char(uint32_t state)
+{
+    char prev = ' ';
+    if ((state & CY_RETARGET_IO_TX_PREV_LF) != 0U)
+    {
+        prev = '\n';
+    }
+    else if ((state & CY_RETARGET_IO_TX_PREV_CR) != 0U)
+    {
+        prev = '\r';
+    }
+    return prev;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_prev_bits
+//
+// Returns the producer state word next with the PREV bits of the last character c written
+//--------------------------------------------------------------------------------------------------
+static inline uint32_t cy_retarget_io_tx_prev_bits(uint32_t next, char c)
+{
+    next &= ~CY_RETARGET_IO_TX_PREV_Msk;
+    if (c == '\n')
+    {
+        next |= CY_RETARGET_IO_TX_PREV_LF;
+    }
+    else if (c == '\r')
+    {
+        next |= CY_RETARGET_IO_TX_PREV_CR;
+    }
+    return next;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_reserve_text
+//
+// Like cy_retarget_io_tx_reserve, for the longest prefix of the *len characters at ptr whose output
+// fits into max bytes. The text is converted against the character the reserved area ends with,
+// which changes in the same compare-and-swap, so a writer that preempts another one can never
+// convert against a stale character. Sets out->prev, *len and *out_len for the prefix, also if
+// there is not enough space for it.
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_tx_reserve_text(const char* ptr, size_t* len, cy_retarget_io_out_t* out,
+                                           size_t max, size_t* out_len, size_t* start)
+{
+    const cy_retarget_io_ring_t* ring = &cy_retarget_io_tx_ring;
+    size_t   total    = *len;
+    bool     measured = false;
+    uint32_t state;
+    uint32_t next;
+    do
+    {
+        state = cy_retarget_io_tx_state;
+        char prev = cy_retarget_io_tx_prev_char(state);
+        if (!measured || (prev != out->prev))
+        {
+            // Only measured again if another writer changed what the text follows
+            out->prev = prev;
+            *len      = total;
+            *out_len  = cy_retarget_io_out_fit(ptr, len, out, max, true);
+            measured  = true;
+        }
+        if ((state & CY_RETARGET_IO_TX_OPEN) != 0U)
+        {
+            return false;
+        }
+        size_t reserved = state & CY_RETARGET_IO_TX_RESERVED_Msk;
+        size_t used     = cy_retarget_io_ring_distance(ring, ring->tail, reserved);
+        if ((ring->size - 1U - used) < *out_len)
+        {
+            return false;
+        }
+        *start = reserved;
+        next   = ((state & ~CY_RETARGET_IO_TX_RESERVED_Msk) + CY_RETARGET_IO_TX_WRITER) |
+                 (uint32_t)cy_retarget_io_ring_advance(ring, reserved, *out_len);
+        if (CY_RETARGET_IO_TX_TRANSFORM)
+        {
+            next = cy_retarget_io_tx_prev_bits(next, ptr[*len - 1U]);
+        }
+    } while (!cy_retarget_io_atomic_cas(&cy_retarget_io_tx_state, state, next));
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_write
+//
+// Buffered output path, safe to call from any number of tasks and interrupts without a lock. Each
+// chunk of at most half the ring buffer is reserved and copied as a whole, so the output of
+// concurrent writers is never interleaved within a chunk. Returns the number of bytes accepted,
+// the rest is dropped according to policy. Binary data is written with convert set to false.
+//--------------------------------------------------------------------------------------------------
+static size_t cy_retarget_io_tx_write(const char* ptr, size_t len,
+                                      cy_retarget_io_overflow_policy_t policy, bool convert)
+{
+    cy_retarget_io_ring_t* ring = &cy_retarget_io_tx_ring;
+    size_t max_chunk = (ring->size - 1U) / 2U;
+    size_t done      = 0U;
+    bool   full      = false;
+    cy_retarget_io_out_t out;
+    cy_retarget_io_out_begin(&out, cy_retarget_io_tx_prev_char(cy_retarget_io_tx_state));
+    while ((done < len) && !full)
+    {
+        size_t max = max_chunk;
+        size_t in_len;
+        size_t out_len;
+        size_t index;
+        for (;;)
+        {
+            in_len = len - done;
+            bool reserved;
+            if (convert)
+            {
+                reserved = cy_retarget_io_tx_reserve_text(&ptr[done], &in_len, &out, max, &out_len,
+                                                          &index);
+            }
+            else
+            {
+                out_len  = cy_retarget_io_out_fit(&ptr[done], &in_len, &out, max, false);
+                reserved = cy_retarget_io_tx_reserve(out_len, &index);
+            }
+            if (reserved)
+            {
+                break;
+            }
+
+            size_t free = cy_retarget_io_tx_free();
+            if ((cy_retarget_io_tx_state & CY_RETARGET_IO_TX_OPEN) != 0U)
+            {
+                if ((policy != CY_RETARGET_IO_OVERFLOW_BLOCK) || !cy_retarget_io_tx_wait_open())
+                {
+                    full = true;
+                    break;
+                }
+            }
+            else if (free >= out_len)
+            {
+                // Lost a race against another producer or the consumer, retry
+            }
+            else if (policy == CY_RETARGET_IO_OVERFLOW_BLOCK)
+            {
+                cy_retarget_io_tx_wait();
+            }
+            else if ((policy == CY_RETARGET_IO_OVERFLOW_DROP_OLDEST) &&
+                     cy_retarget_io_tx_drop_oldest(out_len))
+            {
+                // Space was made, retry the reservation
+            }
+            else if ((policy == CY_RETARGET_IO_OVERFLOW_TRUNCATE) && (free > 0U) && (free < max))
+            {
+                max = free;
+            }
+            else
+            {
+                full = true;
+                break;
+            }
+        }
+        if (!full)
+        {
+            size_t end = cy_retarget_io_out_enqueue(ring, index, &ptr[done], in_len, &out, convert);
+            if (!convert && (done == 0U))
+            {
+                cy_retarget_io_tx_mark(index);
+            }
+            if (convert ? (ptr[(done + in_len) - 1U] == '\n') : ((done + in_len) == len))
+            {
+                cy_retarget_io_tx_mark(end);
+            }
+            CY_RETARGET_IO_STATS_HIGH_WATER(tx_high_water, cy_retarget_io_tx_used());
+            cy_retarget_io_tx_complete();
+            done += in_len;
+            // A truncated chunk ends the write
+            full = (max != max_chunk);
+        }
+    }
+
+    if (done < len)
+    {
+        cy_retarget_io_atomic_add(&cy_retarget_io_tx_dropped, (uint32_t)(len - done));
+    }
+    return done;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_high_reserve
+//
+// Claims len contiguous bytes of the high priority lane for the in_len characters at ptr and
+// registers the caller as an active producer. The output was measured against out->prev, which must
+// still be the last character written to stderr, it is updated together with the reservation.
+// Interrupts are only masked for the update, the data is copied afterwards. Returns false without
+// side effects if there is not enough space or another writer came first.
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_tx_high_reserve(size_t len, size_t* start,
+                                           const cy_retarget_io_out_t* out, const char* ptr,
+                                           size_t in_len)
+{
+    const cy_retarget_io_ring_t* ring = &cy_retarget_io_tx_high_ring;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bool reserved = ((ring->size - 1U - cy_retarget_io_tx_high_used()) >= len) &&
+                    (out->prev == cy_retarget_io_stderr_prev_char);
+    if (reserved)
+    {
+        cy_retarget_io_out_track(&cy_retarget_io_stderr_prev_char, ptr, in_len);
+        *start = cy_retarget_io_tx_high_reserved;
+        cy_retarget_io_tx_high_reserved = cy_retarget_io_ring_advance(ring, *start, len);
+        ++cy_retarget_io_tx_high_writers;
+        CY_RETARGET_IO_STATS_HIGH_WATER(tx_high_lane_high_water, cy_retarget_io_tx_high_used());
+    }
+    __set_PRIMASK(primask);
+    return reserved;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_high_complete
+//
+// Unregisters the caller as an active producer of the high priority lane. The last producer to
+// finish makes all reserved data visible to the consumer.
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_tx_high_complete(void)
+{
+    // The copied data must be in memory before the consumer can see it
+    __DMB();
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bool last = (--cy_retarget_io_tx_high_writers == 0U);
+    if (last)
+    {
+        cy_retarget_io_tx_high_ring.head = cy_retarget_io_tx_high_reserved;
+    }
+    __set_PRIMASK(primask);
+    if (last)
+    {
+        cy_retarget_io_tx_kick();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_high_wait
+//
+// Waits until the consumer has freed space in the high priority lane
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_tx_high_wait(void)
+{
+    CY_RETARGET_IO_STATS_START(start);
+    #if defined(CY_RETARGET_IO_RTOS_WAIT)
+    if (cy_retarget_io_waiter_can_block(&cy_retarget_io_tx_high_waiter))
+    {
+        cy_retarget_io_waiter_wait(&cy_retarget_io_tx_high_waiter,
+                                   cy_retarget_io_tx_high_is_empty, CY_RTOS_NEVER_TIMEOUT);
+    }
+    else
+    #endif
+    // If interrupts are masked by the caller the handler cannot run, so drain the channel directly
+    if (__get_PRIMASK() != 0U)
+    {
+        cy_retarget_io_tx_service();
+    }
+    else
+    {
+        cy_retarget_io_tx_sleep(NULL);
+    }
+    CY_RETARGET_IO_STATS_CYCLES(tx_blocked_cycles, start);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_high_write
+//
+// Writes to the high priority lane, handling output that does not fit according to the overflow
+// policy. The lane is sent before the normal lane, so waiting for space only takes as long as
+// sending its own backlog. Data already in the lane is never discarded: with
+// CY_RETARGET_IO_OVERFLOW_DROP_OLDEST the new output is dropped, the first message of a fault is
+// usually the one that explains it. Returns the number of bytes accepted.
+//--------------------------------------------------------------------------------------------------
+static size_t cy_retarget_io_tx_high_write(const char* ptr, size_t len)
+{
+    cy_retarget_io_ring_t* ring = &cy_retarget_io_tx_high_ring;
+    cy_retarget_io_overflow_policy_t policy = cy_retarget_io_tx_policy_now();
+    size_t max_chunk = ring->size - 1U;
+    size_t max       = max_chunk;
+    size_t done      = 0U;
+    cy_retarget_io_out_t out;
+    cy_retarget_io_out_begin(&out, cy_retarget_io_stderr_prev_char);
+    while (done < len)
+    {
+        out.prev = cy_retarget_io_stderr_prev_char;
+        size_t in_len  = len - done;
+        size_t out_len = cy_retarget_io_out_fit(&ptr[done], &in_len, &out, max, true);
+        size_t index;
+        if (cy_retarget_io_tx_high_reserve(out_len, &index, &out, &ptr[done], in_len))
+        {
+            (void)cy_retarget_io_out_enqueue(ring, index, &ptr[done], in_len, &out, true);
+            cy_retarget_io_tx_high_complete();
+            done += in_len;
+            if (max != max_chunk)
+            {
+                // A truncated chunk ends the write
+                break;
+            }
+            continue;
+        }
+
+        size_t free = max_chunk - cy_retarget_io_tx_high_used();
+        if (free >= out_len)
+        {
+            // The consumer made space meanwhile or another writer came first, retry
+        }
+        else if (policy == CY_RETARGET_IO_OVERFLOW_BLOCK)
+        {
+            cy_retarget_io_tx_high_wait();
+        }
+        else if ((policy == CY_RETARGET_IO_OVERFLOW_TRUNCATE) && (free > 0U) && (free < max))
+        {
+            max = free;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (done < len)
+    {
+        cy_retarget_io_atomic_add(&cy_retarget_io_tx_dropped, (uint32_t)(len - done));
+    }
+    return done;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_capture_write
+//
+// Appends to the trace capture log, overwriting the oldest output to make space, so it never waits.
+// Each chunk is measured and copied with interrupts masked, so chunks of concurrent writers are
+// never mixed and each one follows the last character really written. Text is taken in chunks of
+// at most CY_RETARGET_IO_CAPTURE_CHUNK bytes to bound the time interrupts are masked. Binary data,
+// only the short log records, is written with convert set to false and kept in one chunk.
+//--------------------------------------------------------------------------------------------------
+static size_t cy_retarget_io_capture_write(const char* ptr, size_t len, bool convert)
+{
+    cy_retarget_io_capture_t* capture = &cy_retarget_io_capture;
+    // The ring buffer helpers only use the buffer and its size
+    cy_retarget_io_ring_t ring;
+    ring.buffer = capture->buffer;
+    ring.size   = capture->size;
+    ring.head   = 0U;
+    ring.tail   = 0U;
+
+    size_t max_used  = ring.size - 1U;
+    size_t max_chunk = convert ? CY_RETARGET_IO_CAPTURE_CHUNK : len;
+    size_t done      = 0U;
+    if (max_chunk > max_used)
+    {
+        max_chunk = max_used;
+    }
+    cy_retarget_io_out_t out;
+    cy_retarget_io_out_begin(&out, cy_retarget_io_stdout_prev_char);
+    while (done < len)
+    {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        out.prev = cy_retarget_io_stdout_prev_char;
+        size_t in_len  = len - done;
+        size_t out_len = cy_retarget_io_out_fit(&ptr[done], &in_len, &out, max_chunk, convert);
+        size_t free = max_used - cy_retarget_io_ring_distance(&ring, capture->tail, capture->head);
+        if (free < out_len)
+        {
+            capture->tail = cy_retarget_io_ring_advance(&ring, capture->tail, out_len - free);
+        }
+        capture->head = cy_retarget_io_out_enqueue(&ring, capture->head, &ptr[done], in_len, &out,
+                                                   convert);
+        if (convert)
+        {
+            cy_retarget_io_out_track(&cy_retarget_io_stdout_prev_char, &ptr[done], in_len);
+        }
+        __set_PRIMASK(primask);
+        done += in_len;
+    }
+    return len;
+}
+
+
+// Set after a CR was delivered as LF, so that the LF of a CR & LF pair is dropped
+static bool cy_retarget_io_rx_prev_cr = false;
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_rx_wait
+//
+// Waits until the receive ring buffer holds data
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_rx_wait(void)
+{
+    while (!cy_retarget_io_rx_has_data())
+    {
+        #if defined(CY_RETARGET_IO_RTOS_WAIT)
+        if (cy_retarget_io_waiter_can_block(&cy_retarget_io_rx_waiter))
+        {
+            cy_retarget_io_waiter_wait(&cy_retarget_io_rx_waiter, cy_retarget_io_rx_has_data,
+                                       CY_RTOS_NEVER_TIMEOUT);
+            continue;
+        }
+        #endif
+        // The interrupt cannot run while masked by the caller, so poll the channel directly
+        if (__get_PRIMASK() != 0U)
+        {
+            cy_retarget_io_rx_service();
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_poll_ready
+//--------------------------------------------------------------------------------------------------
+static inline bool cy_retarget_io_poll_ready(XMC_USIC_CH_t* channel)
+{
+    return (XMC_UART_CH_GetStatusFlag(channel) &
+            (XMC_UART_CH_STATUS_FLAG_RECEIVE_INDICATION |
+             XMC_UART_CH_STATUS_FLAG_ALTERNATIVE_RECEIVE_INDICATION)) != 0U;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_rx_ready
+//
+// Checks for received data in the receive ring buffer if channel is NULL, in the channel otherwise
+//--------------------------------------------------------------------------------------------------
+static inline bool cy_retarget_io_rx_ready(XMC_USIC_CH_t* channel)
+{
+    return (channel == NULL) ? cy_retarget_io_rx_has_data() : cy_retarget_io_poll_ready(channel);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_rx_wait_for
+//
+// Waits until cy_retarget_io_rx_ready, at most for what is left of timeout_ms after *waited_us.
+// Adds the time waited to *waited_us. Returns false if the time is up without data.
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_rx_wait_for(XMC_USIC_CH_t* channel, uint32_t timeout_ms,
+                                       uint64_t* waited_us)
+{
+    if (timeout_ms == CY_RETARGET_IO_WAIT_FOREVER)
+    {
+        if (channel == NULL)
+        {
+            cy_retarget_io_rx_wait();
+        }
+        while ((channel != NULL) && !cy_retarget_io_poll_ready(channel))
+        {
+            // Block indefinitely waiting for data in the receive buffer
+        }
+        return true;
+    }
+    if (cy_retarget_io_rx_ready(channel))
+    {
+        return true;
+    }
+    uint64_t timeout_us = (uint64_t)timeout_ms * 1000U;
+    if (*waited_us >= timeout_us)
+    {
+        return false;
+    }
+    uint64_t left_us = timeout_us - *waited_us;
+
+    #if defined(CY_RETARGET_IO_RTOS_WAIT)
+    if ((channel == NULL) && cy_retarget_io_waiter_can_block(&cy_retarget_io_rx_waiter))
+    {
+        // Rounded up, a timeout of 0 would not block at all
+        cy_time_t wait_ms = (cy_time_t)((left_us + 999U) / 1000U);
+        cy_time_t start;
+        cy_time_t now;
+        (void)cy_rtos_get_time(&start);
+        cy_retarget_io_waiter_wait(&cy_retarget_io_rx_waiter, cy_retarget_io_rx_has_data,
+                                   wait_ms);
+        (void)cy_rtos_get_time(&now);
+        *waited_us += (uint64_t)(cy_time_t)(now - start) * 1000U;
+        return cy_retarget_io_rx_has_data();
+    }
+    #endif // if defined(CY_RETARGET_IO_RTOS_WAIT)
+
+    uint64_t limit = cy_retarget_io_us_to_cycles(left_us);
+    cy_retarget_io_cycles_t cycles;
+    bool ready;
+    cy_retarget_io_cycles_start(&cycles);
+    do
+    {
+        ready = cy_retarget_io_rx_ready(channel);
+        // The interrupt cannot run while masked by the caller, so poll the channel directly
+        if (!ready && (channel == NULL) && (__get_PRIMASK() != 0U))
+        {
+            cy_retarget_io_rx_service();
+        }
+    } while (!ready && (cy_retarget_io_cycles_sample(&cycles) < limit));
+    cy_retarget_io_cycles_stop(&cycles);
+    *waited_us += cy_retarget_io_cycles_to_us(cycles.elapsed);
+    return ready;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_rx_convert
+//
+// Applies the input conversion selected by flags to c. Returns false if c is dropped, which is the
+// LF of a CR & LF pair.
+//--------------------------------------------------------------------------------------------------
+static inline bool cy_retarget_io_rx_convert(char* c, uint32_t flags)
+{
+    if ((flags & CY_RETARGET_IO_READ_CRLF_TO_LF) != 0U)
+    {
+        bool prev_cr = cy_retarget_io_rx_prev_cr;
+        cy_retarget_io_rx_prev_cr = (*c == '\r');
+        if (*c == '\r')
+        {
+            *c = '\n';
+        }
+        else if ((*c == '\n') && prev_cr)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_rx_take
+//
+// Copies the data received so far, up to len bytes, from the receive ring buffer if channel is NULL
+// or from the channel. In line mode, stops after a line terminator and sets *eol. Returns the
+// number of bytes stored.
+//--------------------------------------------------------------------------------------------------
+static size_t cy_retarget_io_rx_take(XMC_USIC_CH_t* channel, char* ptr, size_t len, uint32_t flags,
+                                     bool* eol)
+{
+    cy_retarget_io_ring_t* ring = &cy_retarget_io_rx_ring;
+    size_t nChars = 0U;
+    size_t tail   = ring->tail;
+    size_t head   = ring->head;
+    while ((nChars < len) && !*eol)
+    {
+        char c;
+        if (channel == NULL)
+        {
+            if (tail == head)
+            {
+                break;
+            }
+            c    = (char)ring->buffer[tail];
+            tail = cy_retarget_io_ring_next(ring, tail);
+        }
+        else
+        {
+            if (!cy_retarget_io_poll_ready(channel))
+            {
+                break;
+            }
+            c = (char)XMC_UART_CH_GetReceivedData(channel);
+            XMC_UART_CH_ClearStatusFlag(channel,
+                                        XMC_UART_CH_STATUS_FLAG_ALTERNATIVE_RECEIVE_INDICATION |
+                                        XMC_UART_CH_STATUS_FLAG_RECEIVE_INDICATION);
+        }
+        if (cy_retarget_io_rx_convert(&c, flags))
+        {
+            ptr[nChars++] = c;
+            *eol = ((flags & CY_RETARGET_IO_READ_LINE) != 0U) && ((c == '\n') || (c == '\r'));
+        }
+    }
+    if (channel == NULL)
+    {
+        ring->tail             = tail;
+        cy_retarget_io_rx_seen = tail;
+    }
+    return nChars;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_putchar
+//--------------------------------------------------------------------------------------------------
+static inline cy_rslt_t cy_retarget_io_putchar(char c)
+{
+    if (cy_retarget_io_tx_fifo_size != 0U)
+    {
+        // Refill the free space count only when the last burst has used it up
+        while (cy_retarget_io_tx_fifo_space == 0U)
+        {
+            cy_retarget_io_tx_fifo_space =
+                cy_retarget_io_tx_fifo_get_space(cy_retarget_io_uart_obj.channel);
+        }
+        XMC_USIC_CH_TXFIFO_PutData(cy_retarget_io_uart_obj.channel, (uint16_t)(uint8_t)c);
+        --cy_retarget_io_tx_fifo_space;
+        return CY_RSLT_SUCCESS;
+    }
+
+    // Send single character to the transmit buffer
+    XMC_UART_CH_Transmit(cy_retarget_io_uart_obj.channel, c);
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_putchar_to
+//--------------------------------------------------------------------------------------------------
+static inline void cy_retarget_io_putchar_to(XMC_USIC_CH_t* channel, char c)
+{
+    if (channel == cy_retarget_io_uart_obj.channel)
+    {
+        // cy_retarget_io_putchar never fails, it waits until the character is accepted
+        (void)cy_retarget_io_putchar(c);
+    }
+    else
+    {
+        XMC_UART_CH_Transmit(channel, (uint16_t)(uint8_t)c);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_poll_drop
+//
+// Interrupts do not send by polling. Without the mutex their characters would be mixed into those
+// of the task they preempted, and they would wait for the line. Their output is dropped and counted
+// instead, except after a panic flush, when the fault handler owns the channel. Returns true if the
+// caller drops len bytes.
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_poll_drop(size_t len)
+{
+    bool drop = (__get_IPSR() != 0U) && !cy_retarget_io_in_panic;
+    if (drop)
+    {
+        cy_retarget_io_atomic_add(&cy_retarget_io_tx_dropped, (uint32_t)len);
+    }
+    return drop;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_poll_write
+//
+// Enqueue stage of the unbuffered output path. With LF to CR & LF conversion the spans between two
+// LFs are sent without checking every character, and the previous character is only looked at for
+// each LF. *prev is updated as the characters are sent, so an interrupt that writes in between
+// follows what is already on the line.
+//--------------------------------------------------------------------------------------------------
+static size_t cy_retarget_io_poll_write(XMC_USIC_CH_t* channel, char* prev, const char* ptr,
+                                        size_t len)
+{
+    CY_RETARGET_IO_STATS_START(start);
+    cy_retarget_io_out_t out;
+    cy_retarget_io_out_begin(&out, '\n');
+    // Read after the stamp is taken, an interrupt may have written in between
+    out.prev = *prev;
+    size_t i = 0U;
+    while (i < len)
+    {
+        size_t      n;
+        const char* header = cy_retarget_io_out_header(&out, ptr, i, &n);
+        for (size_t k = 0U; k < n; ++k)
+        {
+            cy_retarget_io_putchar_to(channel, header[k]);
+        }
+        size_t lf = i + cy_retarget_io_out_span(&ptr[i], len - i);
+        for (; i < lf; ++i)
+        {
+            cy_retarget_io_putchar_to(channel, ptr[i]);
+        }
+        cy_retarget_io_out_track(prev, ptr, lf);
+        if (lf == len)
+        {
+            break;
+        }
+
+        const char* eol = cy_retarget_io_out_eol((lf > 0U) ? ptr[lf - 1U] : out.prev, &n);
+        for (size_t k = 0U; k < n; ++k)
+        {
+            cy_retarget_io_putchar_to(channel, eol[k]);
+        }
+        ++i;
+        cy_retarget_io_out_track(prev, ptr, i);
+    }
+    CY_RETARGET_IO_STATS_CYCLES(tx_blocked_cycles, start);
+    return len;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_raw_write
+//
+// Sends binary data on the main channel without any conversion, through the transmit ring buffer
+// if there is one
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_raw_write(const char* ptr, size_t len)
+{
+    if (cy_retarget_io_tx_ring.buffer != NULL)
+    {
+        (void)cy_retarget_io_tx_write(ptr, len, cy_retarget_io_tx_policy_now(), false);
+    }
+    else
+    {
+        cy_retarget_io_mutex_acquire();
+        for (size_t i = 0U; i < len; ++i)
+        {
+            (void)cy_retarget_io_putchar(ptr[i]);
+        }
+        cy_retarget_io_mutex_release();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_stream_send
+//
+// Writes to the channel the stream is routed to, selects the capture log or the buffered or polling
+// path of the main channel otherwise
+//--------------------------------------------------------------------------------------------------
+static size_t cy_retarget_io_stream_send(int fd, const char* ptr, size_t len)
+{
+    cy_retarget_io_route_t* route = cy_retarget_io_get_route(fd);
+    size_t nChars = 0U;
+    if (route != NULL)
+    {
+        if (!cy_retarget_io_poll_drop(len))
+        {
+            cy_retarget_io_route_lock(route);
+            nChars = cy_retarget_io_poll_write(route->channel, &route->prev_char, ptr, len);
+            cy_retarget_io_route_unlock(route);
+        }
+    }
+    else if ((cy_retarget_io_capture.buffer != NULL) && !cy_retarget_io_in_panic)
+    {
+        nChars = cy_retarget_io_capture_write(ptr, len, true);
+    }
+    else if ((fd == CY_RETARGET_IO_STDERR) && (cy_retarget_io_tx_high_ring.buffer != NULL))
+    {
+        nChars = cy_retarget_io_tx_high_write(ptr, len);
+    }
+    else if (cy_retarget_io_tx_ring.buffer != NULL)
+    {
+        // The buffered mode does not need the mutex, concurrent writers reserve their own space
+        nChars = cy_retarget_io_tx_write(ptr, len, cy_retarget_io_tx_policy_now(), true);
+    }
+    else if (!cy_retarget_io_poll_drop(len))
+    {
+        cy_retarget_io_mutex_acquire();
+        nChars = cy_retarget_io_poll_write(cy_retarget_io_uart_obj.channel,
+                                           &cy_retarget_io_stdout_prev_char, ptr, len);
+        cy_retarget_io_mutex_release();
+    }
+    return nChars;
+}
+
+
+#if defined(CY_RETARGET_IO_TASK_LINES)
+// Line assembly buffer of a task, taken from a fixed pool. A buffer is owned by a task while it
+// holds a partial line and returned to the pool once it is empty, or by
+// cy_retarget_io_line_release before the task is deleted.
+typedef struct
+{
+    cy_thread_t owner; // NULL if the buffer is free
+    size_t      len;
+    char        data[CY_RETARGET_IO_LINE_BUFFER_SIZE];
+} cy_retarget_io_line_t;
+
+static cy_retarget_io_line_t cy_retarget_io_lines[CY_RETARGET_IO_LINE_BUFFERS];
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_line_get
+//
+// Returns the line buffer of the calling task, claims a free one if claim is set. Returns NULL in
+// interrupts, before the scheduler runs, after a panic flush and if the pool is exhausted.
+//--------------------------------------------------------------------------------------------------
+static cy_retarget_io_line_t* cy_retarget_io_line_get(bool claim)
+{
+    cy_thread_t self = NULL;
+    if (cy_retarget_io_in_panic || (__get_IPSR() != 0U) ||
+        (cy_rtos_get_thread_handle(&self) != CY_RSLT_SUCCESS) || (self == NULL))
+    {
+        return NULL;
+    }
+
+    cy_retarget_io_line_t* line = NULL;
+    cy_retarget_io_line_t* free_line = NULL;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    for (size_t i = 0U; (i < CY_RETARGET_IO_LINE_BUFFERS) && (line == NULL); ++i)
+    {
+        if (cy_retarget_io_lines[i].owner == self)
+        {
+            line = &cy_retarget_io_lines[i];
+        }
+        else if ((free_line == NULL) && (cy_retarget_io_lines[i].owner == NULL))
+        {
+            free_line = &cy_retarget_io_lines[i];
+        }
+    }
+    if ((line == NULL) && claim && (free_line != NULL))
+    {
+        free_line->owner = self;
+        free_line->len   = 0U;
+        line             = free_line;
+    }
+    __set_PRIMASK(primask);
+    return line;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_line_send
+//
+// Sends the first len bytes of a line buffer, returns the buffer to the pool once it is empty
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_line_send(cy_retarget_io_line_t* line, size_t len)
+{
+    if (len > 0U)
+    {
+        (void)cy_retarget_io_stream_send(CY_RETARGET_IO_STDOUT, line->data, len);
+        line->len -= len;
+        (void)memmove(line->data, &line->data[len], line->len);
+    }
+    if (line->len == 0U)
+    {
+        line->owner = NULL;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_line_flush
+//
+// Sends the partial line of the calling task
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_line_flush(void)
+{
+    cy_retarget_io_line_t* line = cy_retarget_io_line_get(false);
+    if (line != NULL)
+    {
+        cy_retarget_io_line_send(line, line->len);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_line_flush_all
+//
+// Sends the partial lines of all tasks, for deinit and panic flush
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_line_flush_all(void)
+{
+    for (size_t i = 0U; i < CY_RETARGET_IO_LINE_BUFFERS; ++i)
+    {
+        if (cy_retarget_io_lines[i].owner != NULL)
+        {
+            cy_retarget_io_line_send(&cy_retarget_io_lines[i], cy_retarget_io_lines[i].len);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_line_write
+//
+// Collects stdout in the line buffer of the calling task. Everything up to the last LF is sent with
+// one write, and so is a full buffer. Whole lines written to an empty buffer are sent without
+// copying. Output is sent directly if no line buffer is available.
+//--------------------------------------------------------------------------------------------------
+static size_t cy_retarget_io_line_write(const char* ptr, size_t len)
+{
+    cy_retarget_io_line_t* line = cy_retarget_io_line_get(true);
+    if (line == NULL)
+    {
+        return cy_retarget_io_stream_send(CY_RETARGET_IO_STDOUT, ptr, len);
+    }
+
+    size_t done = 0U;
+    if (line->len == 0U)
+    {
+        size_t end = len;
+        while ((end > 0U) && (ptr[end - 1U] != '\n'))
+        {
+            --end;
+        }
+        if (end > 0U)
+        {
+            (void)cy_retarget_io_stream_send(CY_RETARGET_IO_STDOUT, ptr, end);
+            done = end;
+        }
+    }
+    while (done < len)
+    {
+        size_t n = CY_RETARGET_IO_LINE_BUFFER_SIZE - line->len;
+        if (n > (len - done))
+        {
+            n = len - done;
+        }
+        (void)memcpy(&line->data[line->len], &ptr[done], n);
+        line->len += n;
+        done      += n;
+
+        size_t end = line->len;
+        while ((end > (line->len - n)) && (line->data[end - 1U] != '\n'))
+        {
+            --end;
+        }
+        if ((end == (line->len - n)) && (line->len == CY_RETARGET_IO_LINE_BUFFER_SIZE))
+        {
+            end = line->len;
+        }
+        cy_retarget_io_line_send(line, (end > (line->len - n)) ? end : 0U);
+        if ((line->len == 0U) && (done < len))
+        {
+            // Returned to the pool, the rest starts in a new buffer
+            line = cy_retarget_io_line_get(true);
+            if (line == NULL)
+            {
+                return done + cy_retarget_io_stream_send(CY_RETARGET_IO_STDOUT, &ptr[done],
+                                                         len - done);
+            }
+        }
+    }
+    cy_retarget_io_line_send(line, 0U);
+    return len;
+}
+
+
+#endif // defined(CY_RETARGET_IO_TASK_LINES)
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_stream_write
+//
+// Output entry point of all toolchains
+//--------------------------------------------------------------------------------------------------
+static size_t cy_retarget_io_stream_write(int fd, const char* ptr, size_t len)
+{
+    CY_RETARGET_IO_STATS_START(start);
+    #if defined(CY_RETARGET_IO_TASK_LINES)
+    size_t nChars = (fd == CY_RETARGET_IO_STDOUT)
+        ? cy_retarget_io_line_write(ptr, len)
+        : cy_retarget_io_stream_send(fd, ptr, len);
+    #else
+    size_t nChars = cy_retarget_io_stream_send(fd, ptr, len);
+    #endif
+    CY_RETARGET_IO_STATS_COUNT(write_calls, 1U);
+    CY_RETARGET_IO_STATS_COUNT(bytes_written, nChars);
+    CY_RETARGET_IO_STATS_WRITE_DONE(start);
+    return nChars;
+}
+
+
+#if defined(__ARMCC_VERSION) // ARM-MDK
+#if defined(__MICROLIB)
+// MicroLib has no _sys_write, every character is written through fputc. The standard ARM C
+// library buffers the streams and hands complete blocks to _sys_write instead.
+//--------------------------------------------------------------------------------------------------
+// fputc
+//--------------------------------------------------------------------------------------------------
+__attribute__((weak)) int fputc(int ch, FILE* f)
+{
+    char c = (char)ch;
+    (void)cy_retarget_io_stream_write((f == stderr) ? CY_RETARGET_IO_STDERR : CY_RETARGET_IO_STDOUT,
+                                      &c, 1U);
+    return ch;
+}
+
+
+#endif // defined(__MICROLIB)
+
+#elif defined (__ICCARM__) // IAR
+    #include <yfuns.h>
+
+//--------------------------------------------------------------------------------------------------
+// __write
+//--------------------------------------------------------------------------------------------------
+__weak size_t __write(int handle, const unsigned char* buffer, size_t size)
+{
+    size_t nChars = 0;
+    // This template only writes to "standard out" and "standard err", for all other file handles
+    // it returns failure.
+    if ((handle != _LLIO_STDOUT) && (handle != _LLIO_STDERR))
+    {
+        return (_LLIO_ERROR);
+    }
+    if (buffer != NULL)
+    {
+        nChars = cy_retarget_io_stream_write(handle, (const char*)buffer, size);
+    }
+    return (nChars);
+}
+
+
+#else // (__GNUC__)  GCC
+#if !defined(CY_RETARGET_IO_NO_FLOAT)
+// Add an explicit reference to the floating point printf library to allow the usage of floating
+// point conversion specifier.
+__asm(".global _printf_float");
+#endif
+//--------------------------------------------------------------------------------------------------
+// _write
+//--------------------------------------------------------------------------------------------------
+__attribute__((weak)) int _write(int fd, const char* ptr, int len)
+{
+    int nChars = 0;
+    if ((ptr != NULL) && (len > 0))
+    {
+        nChars = (int)cy_retarget_io_stream_write(fd, ptr, (size_t)len);
+    }
+    return (nChars);
+}
+
+
+#endif // if defined(__ARMCC_VERSION)
+
+
+// Flags of cy_retarget_io_read used by the standard input functions
+#ifdef CY_RETARGET_IO_CONVERT_CRLF_TO_LF
+#define CY_RETARGET_IO_STDIN_FLAGS  (CY_RETARGET_IO_READ_LINE | CY_RETARGET_IO_READ_CRLF_TO_LF)
+#else
+#define CY_RETARGET_IO_STDIN_FLAGS  (CY_RETARGET_IO_READ_LINE)
+#endif
+
+#if defined(__ARMCC_VERSION) // ARM-MDK
+#if defined(__MICROLIB)
+// MicroLib has no _sys_read, the standard ARM C library reads blocks through _sys_read instead
+//--------------------------------------------------------------------------------------------------
+// fgetc
+//--------------------------------------------------------------------------------------------------
+__attribute__((weak)) int fgetc(FILE* f)
+{
+    (void)f;
+    char c;
+    size_t nChars = cy_retarget_io_read(&c, 1U, CY_RETARGET_IO_WAIT_FOREVER,
+                                        CY_RETARGET_IO_STDIN_FLAGS);
+    return (nChars == 1U) ? c : EOF;
+}
+
+
+#endif // defined(__MICROLIB)
+
+#elif defined (__ICCARM__) // IAR
+//--------------------------------------------------------------------------------------------------
+// __read
+//--------------------------------------------------------------------------------------------------
+__weak size_t __read(int handle, unsigned char* buffer, size_t size)
+{
+    // This template only reads from "standard in", for all other file handles it returns failure.
+    if ((handle != _LLIO_STDIN) || (buffer == NULL))
+    {
+        return (_LLIO_ERROR);
+    }
+    else
+    {
+        // Hands back a whole line, or as much of it as fits, so that the library does not call
+        // back for every character
+        return cy_retarget_io_read(buffer, size, CY_RETARGET_IO_WAIT_FOREVER,
+                                   CY_RETARGET_IO_STDIN_FLAGS);
+    }
+}
+
+
+#else // (__GNUC__)  GCC
+#if !defined(CY_RETARGET_IO_NO_FLOAT)
+// Add an explicit reference to the floating point scanf library to allow the usage of floating
+// point conversion specifier.
+__asm(".global _scanf_float");
+#endif
+//--------------------------------------------------------------------------------------------------
+// _read
+//--------------------------------------------------------------------------------------------------
+__attribute__((weak)) int _read(int fd, char* ptr, int len)
+{
+    // Only standard input is supported
+    (void)fd;
+    if ((ptr == NULL) || (len <= 0))
+    {
+        return 0;
+    }
+    return (int)cy_retarget_io_read(ptr, (size_t)len, CY_RETARGET_IO_WAIT_FOREVER,
+                                    CY_RETARGET_IO_STDIN_FLAGS);
+}
+
+
+#endif // if defined(__ARMCC_VERSION)
+
+#if defined(__ARMCC_VERSION) // ARM-MDK
+// Include _sys_* prototypes provided by ARM Compiler runtime library
+    #include <rt_sys.h>
+
+// Prevent linkage of library functions that use semihosting calls
+__asm(".global __use_no_semihosting\n\t");
+
+// Enable the linker to select an optimized library that does not include code to handle input
+// arguments to main()
+__asm(".global __ARM_use_no_argv\n\t");
+
+//--------------------------------------------------------------------------------------------------
+// _sys_open
+//
+// Open a file: translates the file names of the standard streams
+// (__stdin_name/__stdout_name/__stderr_name) to the descriptor numbers used for the routing
+//--------------------------------------------------------------------------------------------------
+FILEHANDLE __attribute__((weak)) _sys_open(const char* name, int openmode)
+{
+    (void)openmode;
+    if (strcmp(name, __stdin_name) == 0)
+    {
+        return CY_RETARGET_IO_STDIN;
+    }
+    return (strcmp(name, __stderr_name) == 0) ? CY_RETARGET_IO_STDERR : CY_RETARGET_IO_STDOUT;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// _sys_close
+//
+// Close a file: dummy implementation.
+//--------------------------------------------------------------------------------------------------
+int __attribute__((weak)) _sys_close(FILEHANDLE fh)
+{
+    (void)fh;
+    return 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// _sys_write
+//
+// Write to a file: writes the block to the standard output or error stream. Returns the number of
+// bytes not written.
+//--------------------------------------------------------------------------------------------------
+int __attribute__((weak)) _sys_write(FILEHANDLE fh, const unsigned char* buf, unsigned len,
+                                     int mode)
+{
+    (void)mode;
+    if (((fh != CY_RETARGET_IO_STDOUT) && (fh != CY_RETARGET_IO_STDERR)) || (buf == NULL))
+    {
+        return -1;
+    }
+    size_t nChars = cy_retarget_io_stream_write((int)fh, (const char*)buf, (size_t)len);
+    return (int)(len - (unsigned)nChars);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// _sys_read
+//
+// Read from a file: reads a line, or as much of it as fits, from the standard input stream.
+// Returns the number of bytes not read.
+//--------------------------------------------------------------------------------------------------
+int __attribute__((weak)) _sys_read(FILEHANDLE fh, unsigned char* buf, unsigned len, int mode)
+{
+    (void)mode;
+    if ((fh != CY_RETARGET_IO_STDIN) || (buf == NULL))
+    {
+        return -1;
+    }
+    size_t nChars = cy_retarget_io_read(buf, (size_t)len, CY_RETARGET_IO_WAIT_FOREVER,
+                                        CY_RETARGET_IO_STDIN_FLAGS);
+    return (int)(len - (unsigned)nChars);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// _ttywrch
+//
+// Write a character to the output channel: used by the library for error messages, which go to
+// the standard error stream.
+//--------------------------------------------------------------------------------------------------
+void __attribute__((weak)) _ttywrch(int ch)
+{
+    char c = (char)ch;
+    (void)cy_retarget_io_stream_write(CY_RETARGET_IO_STDERR, &c, 1U);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// _sys_istty
+//
+// Check if the file is connected to a terminal: the standard streams are, so that the library
+// line buffers them instead of holding back output until its buffer is full.
+//--------------------------------------------------------------------------------------------------
+int __attribute__((weak)) _sys_istty(FILEHANDLE fh)
+{
+    return ((fh >= CY_RETARGET_IO_STDIN) && (fh <= CY_RETARGET_IO_STDERR)) ? 1 : 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// _sys_seek
+//
+// Move the file position to a given offset: dummy implementation
+//--------------------------------------------------------------------------------------------------
+int __attribute__((weak)) _sys_seek(FILEHANDLE fh, long pos)
+{
+    (void)fh;
+    (void)pos;
+    return -1;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// _sys_flen
+// Return the current length of a file: dummy implementation
+//--------------------------------------------------------------------------------------------------
+long __attribute__((weak)) _sys_flen(FILEHANDLE fh)
+{
+    (void)fh;
+    return 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// _sys_exit
+//
+// Terminate the program: dummy implementation
+//--------------------------------------------------------------------------------------------------
+void __attribute__((weak)) _sys_exit(int returncode)
+{
+    (void)returncode;
+    for (;;)
+    {
+        // Halt here forever
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// _sys_command_string
+//
+// Return a pointer to the command line: dummy implementation
+//--------------------------------------------------------------------------------------------------
+char __attribute__((weak)) *_sys_command_string(char* cmd, int len)
+{
+    (void)cmd;
+    (void)len;
+    return NULL;
+}
+
+
+#endif // ARM-MDK
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_init
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_retarget_io_init(XMC_USIC_CH_t* base)
+{
+    cy_retarget_io_uart_obj.channel = base;
+
+    // Use the transmit FIFO for burst writes if the BSP has configured it
+    uint32_t fifo_size_code = (base->TBCTR & USIC_CH_TBCTR_SIZE_Msk) >> USIC_CH_TBCTR_SIZE_Pos;
+    cy_retarget_io_tx_fifo_size  = (fifo_size_code == 0U) ? 0U : (1UL << fifo_size_code);
+    cy_retarget_io_tx_fifo_space = 0U;
+    cy_retarget_io_baudrate      = 0U;
+    cy_retarget_io_stdout_prev_char = '\n';
+    cy_retarget_io_stderr_prev_char = '\n';
+    cy_retarget_io_tx_dropped       = 0U;
+    #if defined(CY_RETARGET_IO_STATS)
+    cy_retarget_io_stats_init();
+    #endif
+
+    return cy_retarget_io_mutex_init();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_get_irqn
+//--------------------------------------------------------------------------------------------------
+static IRQn_Type cy_retarget_io_get_irqn(const XMC_USIC_CH_t* channel)
+{
+    #if defined(CY_RETARGET_IO_IRQN)
+    (void)channel;
+    return (IRQn_Type)(CY_RETARGET_IO_IRQN);
+    #else
+    #if defined(USIC1)
+    if ((channel == XMC_USIC1_CH0) || (channel == XMC_USIC1_CH1))
+    {
+        return (IRQn_Type)((int32_t)USIC1_0_IRQn + (int32_t)CY_RETARGET_IO_SR);
+    }
+    #endif
+    #if defined(USIC2)
+    if ((channel == XMC_USIC2_CH0) || (channel == XMC_USIC2_CH1))
+    {
+        return (IRQn_Type)((int32_t)USIC2_0_IRQn + (int32_t)CY_RETARGET_IO_SR);
+    }
+    #endif
+    (void)channel;
+    return (IRQn_Type)((int32_t)USIC0_0_IRQn + (int32_t)CY_RETARGET_IO_SR);
+    #endif // if defined(CY_RETARGET_IO_IRQN)
+}
+
+
+#if (UC_FAMILY == XMC4)
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_dma_init
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_retarget_io_dma_init(XMC_USIC_CH_t* channel,
+                                         const cy_retarget_io_dma_cfg_t* dma)
+{
+    XMC_DMA_CH_CONFIG_t config;
+    (void)memset(&config, 0, sizeof(config));
+    config.enable_interrupt       = true;
+    config.src_transfer_width     = XMC_DMA_CH_TRANSFER_WIDTH_8;
+    config.dst_transfer_width     = XMC_DMA_CH_TRANSFER_WIDTH_8;
+    config.src_address_count_mode = XMC_DMA_CH_ADDRESS_COUNT_MODE_INCREMENT;
+    config.dst_address_count_mode = XMC_DMA_CH_ADDRESS_COUNT_MODE_NO_CHANGE;
+    config.src_burst_length       = XMC_DMA_CH_BURST_LENGTH_1;
+    config.dst_burst_length       = XMC_DMA_CH_BURST_LENGTH_1;
+    config.transfer_flow          = XMC_DMA_CH_TRANSFER_FLOW_M2P_DMA;
+    config.transfer_type          = XMC_DMA_CH_TRANSFER_TYPE_SINGLE_BLOCK;
+    config.priority               = XMC_DMA_CH_PRIORITY_0;
+    config.dst_addr               = (uint32_t)(uintptr_t)&channel->TBUF[0];
+    config.dst_handshaking        = XMC_DMA_CH_DST_HANDSHAKING_HARDWARE;
+    config.dst_peripheral_request = dma->request;
+
+    if (!XMC_DMA_IsEnabled(XMC_DMA0))
+    {
+        XMC_DMA_Init(XMC_DMA0);
+    }
+    if (XMC_DMA_CH_Init(XMC_DMA0, dma->channel, &config) != XMC_DMA_CH_STATUS_OK)
+    {
+        return CY_RETARGET_IO_RSLT_BAD_PARAM;
+    }
+    XMC_DMA_CH_SetEventHandler(XMC_DMA0, dma->channel, cy_retarget_io_dma_event_handler);
+    XMC_DMA_CH_EnableEvent(XMC_DMA0, dma->channel, XMC_DMA_CH_EVENT_TRANSFER_COMPLETE);
+    NVIC_SetPriority(GPDMA0_0_IRQn, CY_RETARGET_IO_IRQ_PRIORITY);
+    NVIC_EnableIRQ(GPDMA0_0_IRQn);
+
+    cy_retarget_io_dma_len     = 0U;
+    cy_retarget_io_dma_channel = (int8_t)dma->channel;
+
+    // Every transmit buffer event requests one DMA transfer. The request line router keeps a
+    // request pending while the channel is disabled, so the event following the last byte of a
+    // block starts the next block. Prime the line once so the first block can start as well.
+    XMC_UART_CH_SelectInterruptNodePointer(
+        channel, XMC_UART_CH_INTERRUPT_NODE_POINTER_TRANSMIT_BUFFER, dma->service_request);
+    XMC_UART_CH_EnableEvent(channel, XMC_UART_CH_EVENT_TRANSMIT_BUFFER);
+    while (XMC_USIC_CH_GetTransmitBufferStatus(channel) == XMC_USIC_CH_TBUF_STATUS_BUSY)
+    {
+        // Wait for any character written in polling mode to leave TBUF
+    }
+    XMC_USIC_CH_TriggerServiceRequest(channel, dma->service_request);
+    return CY_RSLT_SUCCESS;
+}
+
+
+#endif // (UC_FAMILY == XMC4)
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_init
+//
+// Sets up the buffered transmit path, use_irq is set if the USIC interrupt is needed
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_retarget_io_tx_init(const cy_retarget_io_config_t* config, bool* use_irq)
+{
+    XMC_USIC_CH_t* channel = config->channel;
+    cy_retarget_io_tx_ring.buffer      = config->tx_buffer;
+    cy_retarget_io_tx_ring.size        = config->tx_buffer_size;
+    cy_retarget_io_tx_ring.head        = 0U;
+    cy_retarget_io_tx_ring.tail        = 0U;
+    cy_retarget_io_tx_state            = CY_RETARGET_IO_TX_PREV_LF;
+    cy_retarget_io_tx_skip_len         = 0U;
+    cy_retarget_io_tx_running          = false;
+    cy_retarget_io_tx_policy           = config->overflow_policy;
+    cy_retarget_io_tx_high_ring.buffer = config->tx_high_buffer;
+    cy_retarget_io_tx_high_ring.size   = config->tx_high_buffer_size;
+    cy_retarget_io_tx_high_ring.head   = 0U;
+    cy_retarget_io_tx_high_ring.tail   = 0U;
+    cy_retarget_io_tx_high_reserved    = 0U;
+    cy_retarget_io_tx_high_writers     = 0U;
+    cy_retarget_io_tx_high_lane        = false;
+    cy_retarget_io_tx_at_boundary      = true;
+    cy_retarget_io_tx_record_count     = 0U;
+    cy_retarget_io_tx_track            = (cy_retarget_io_tx_high_ring.buffer != NULL) ||
+                                         (config->overflow_policy ==
+                                          CY_RETARGET_IO_OVERFLOW_DROP_OLDEST);
+    #if defined(CY_RETARGET_IO_COMPRESS)
+    cy_retarget_io_lz_reset();
+    #endif
+
+    #if (UC_FAMILY == XMC4)
+    cy_retarget_io_dma_channel = -1;
+    if (config->dma.enable)
+    {
+        // The DMA writes TBUF directly, which is not possible with the transmit FIFO enabled
+        return (cy_retarget_io_tx_fifo_size != 0U)
+            ? CY_RETARGET_IO_RSLT_UNSUPPORTED
+            : cy_retarget_io_dma_init(channel, &config->dma);
+    }
+    #endif // (UC_FAMILY == XMC4)
+
+    if (cy_retarget_io_tx_fifo_size != 0U)
+    {
+        // The standard transmit buffer event fires when the fill level drops below the limit.
+        // A limit of 0 would never fire, and a full FIFO must be able to reach the limit.
+        uint32_t limit = (channel->TBCTR & USIC_CH_TBCTR_LIMIT_Msk) >> USIC_CH_TBCTR_LIMIT_Pos;
+        if ((limit == 0U) || (limit >= cy_retarget_io_tx_fifo_size))
+        {
+            limit = cy_retarget_io_tx_fifo_size / 2U;
+            channel->TBCTR = (channel->TBCTR & ~USIC_CH_TBCTR_LIMIT_Msk) |
+                             (limit << USIC_CH_TBCTR_LIMIT_Pos);
+        }
+        XMC_USIC_CH_TXFIFO_SetInterruptNodePointer(
+            channel, XMC_USIC_CH_TXFIFO_INTERRUPT_NODE_POINTER_STANDARD, CY_RETARGET_IO_SR);
+        XMC_USIC_CH_TXFIFO_EnableEvent(channel, XMC_USIC_CH_TXFIFO_EVENT_CONF_STANDARD);
+    }
+    else
+    {
+        XMC_UART_CH_SelectInterruptNodePointer(
+            channel, XMC_UART_CH_INTERRUPT_NODE_POINTER_TRANSMIT_BUFFER, CY_RETARGET_IO_SR);
+        XMC_UART_CH_EnableEvent(channel, XMC_UART_CH_EVENT_TRANSMIT_BUFFER);
+    }
+    *use_irq = true;
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_rx_init
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_rx_init(const cy_retarget_io_config_t* config)
+{
+    XMC_USIC_CH_t* channel = config->channel;
+    cy_retarget_io_rx_ring.buffer   = config->rx_buffer;
+    cy_retarget_io_rx_ring.size     = config->rx_buffer_size;
+    cy_retarget_io_rx_ring.head     = 0U;
+    cy_retarget_io_rx_ring.tail     = 0U;
+    cy_retarget_io_rx_ring_overruns = 0U;
+    cy_retarget_io_rx_hw_overruns   = 0U;
+    cy_retarget_io_rx_seen          = 0U;
+    cy_retarget_io_rx_bad_frames    = 0U;
+
+    if ((channel->RBCTR & USIC_CH_RBCTR_SIZE_Msk) != 0U)
+    {
+        // With a limit of 0 the standard receive buffer event fires for the first word entering
+        // the empty FIFO, so every burst is picked up immediately.
+        channel->RBCTR &= ~USIC_CH_RBCTR_LIMIT_Msk;
+        XMC_USIC_CH_RXFIFO_SetInterruptNodePointer(
+            channel, XMC_USIC_CH_RXFIFO_INTERRUPT_NODE_POINTER_STANDARD, CY_RETARGET_IO_SR);
+        XMC_USIC_CH_RXFIFO_SetInterruptNodePointer(
+            channel, XMC_USIC_CH_RXFIFO_INTERRUPT_NODE_POINTER_ALTERNATE, CY_RETARGET_IO_SR);
+        XMC_USIC_CH_RXFIFO_EnableEvent(channel, XMC_USIC_CH_RXFIFO_EVENT_CONF_STANDARD |
+                                       XMC_USIC_CH_RXFIFO_EVENT_CONF_ALTERNATE);
+    }
+    else
+    {
+        XMC_UART_CH_SelectInterruptNodePointer(
+            channel, XMC_UART_CH_INTERRUPT_NODE_POINTER_RECEIVE, CY_RETARGET_IO_SR);
+        XMC_UART_CH_SelectInterruptNodePointer(
+            channel, XMC_UART_CH_INTERRUPT_NODE_POINTER_ALTERNATE_RECEIVE, CY_RETARGET_IO_SR);
+        XMC_UART_CH_EnableEvent(channel, XMC_UART_CH_EVENT_STANDARD_RECEIVE |
+                                XMC_UART_CH_EVENT_ALTERNATIVE_RECEIVE);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_stdio_init
+//
+// Hands the stdout buffer of the application to the C library, so that every write carries a
+// whole line and the library does not allocate one. The receive ring buffer already buffers stdin.
+//--------------------------------------------------------------------------------------------------
+static cy_rslt_t cy_retarget_io_stdio_init(const cy_retarget_io_config_t* config)
+{
+    #if defined(__ARMCC_VERSION) && defined(__MICROLIB)
+    // MicroLib does not buffer the standard streams
+    (void)config;
+    return CY_RSLT_SUCCESS;
+    #else
+    int mode = (config->stdio_buffering == CY_RETARGET_IO_STDIO_LINE) ? _IOLBF : _IOFBF;
+    if ((0 != setvbuf(stdout, config->stdout_buffer, mode, config->stdout_buffer_size)) ||
+        (0 != setvbuf(stderr, NULL, _IONBF, 0U)) ||
+        ((config->rx_buffer != NULL) && (0 != setvbuf(stdin, NULL, _IONBF, 0U))))
+    {
+        // The caller may reuse the buffer after the failure
+        (void)setvbuf(stdout, NULL, _IONBF, 0U);
+        return CY_RETARGET_IO_RSLT_UNSUPPORTED;
+    }
+    return CY_RSLT_SUCCESS;
+    #endif // if defined(__ARMCC_VERSION) && defined(__MICROLIB)
+}
+
+
+static void cy_retarget_io_teardown(void);
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_init_cfg
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_retarget_io_init_cfg(const cy_retarget_io_config_t* config)
+{
+    if ((config == NULL) || (config->channel == NULL) ||
+        ((config->tx_buffer != NULL) && ((config->tx_buffer_size < CY_RETARGET_IO_TX_MIN_SIZE) ||
+                                          (config->tx_buffer_size >
+                                           CY_RETARGET_IO_TX_RESERVED_Msk))) ||
+        ((config->tx_high_buffer != NULL) && ((config->tx_buffer == NULL) ||
+                                               (config->tx_high_buffer_size <
+                                                CY_RETARGET_IO_TX_MIN_SIZE))) ||
+        ((config->rx_buffer != NULL) && (config->rx_buffer_size < 2U)) ||
+        ((config->capture_buffer != NULL) &&
+         (config->capture_buffer_size < CY_RETARGET_IO_TX_MIN_SIZE)) ||
+        ((config->stdio_buffering != CY_RETARGET_IO_STDIO_DEFAULT) &&
+         ((config->stdout_buffer == NULL) || (config->stdout_buffer_size == 0U))))
+    {
+        return CY_RETARGET_IO_RSLT_BAD_PARAM;
+    }
+
+    XMC_USIC_CH_t* channel = config->channel;
+    cy_rslt_t rslt = cy_retarget_io_init(channel);
+    bool use_irq = false;
+    #if defined(CY_RETARGET_IO_RTOS_WAIT)
+    if ((CY_RSLT_SUCCESS == rslt) && (config->tx_buffer != NULL))
+    {
+        rslt = cy_retarget_io_waiter_init(&cy_retarget_io_tx_waiter);
+    }
+    if ((CY_RSLT_SUCCESS == rslt) && (config->tx_buffer != NULL))
+    {
+        rslt = cy_retarget_io_waiter_init(&cy_retarget_io_tx_open_waiter);
+    }
+    if ((CY_RSLT_SUCCESS == rslt) && (config->tx_buffer != NULL) &&
+        (config->tx_high_buffer != NULL))
+    {
+        rslt = cy_retarget_io_waiter_init(&cy_retarget_io_tx_high_waiter);
+    }
+    if ((CY_RSLT_SUCCESS == rslt) && (config->rx_buffer != NULL))
+    {
+        rslt = cy_retarget_io_waiter_init(&cy_retarget_io_rx_waiter);
+    }
+    #endif // defined(CY_RETARGET_IO_RTOS_WAIT)
+    if ((CY_RSLT_SUCCESS == rslt) && (config->tx_buffer != NULL))
+    {
+        rslt = cy_retarget_io_tx_init(config, &use_irq);
+    }
+    if ((CY_RSLT_SUCCESS == rslt) && (config->rx_buffer != NULL))
+    {
+        cy_retarget_io_rx_init(config);
+        use_irq = true;
+    }
+    if ((CY_RSLT_SUCCESS == rslt) && (config->stdio_buffering != CY_RETARGET_IO_STDIO_DEFAULT))
+    {
+        rslt = cy_retarget_io_stdio_init(config);
+    }
+    if (CY_RSLT_SUCCESS != rslt)
+    {
+        // Nothing of a failed initialization stays enabled or allocated
+        cy_retarget_io_teardown();
+        return rslt;
+    }
+
+    cy_retarget_io_capture.size   = config->capture_buffer_size;
+    cy_retarget_io_capture.head   = 0U;
+    cy_retarget_io_capture.tail   = 0U;
+    cy_retarget_io_capture.buffer = config->capture_buffer;
+    if (use_irq)
+    {
+        IRQn_Type irqn = cy_retarget_io_get_irqn(channel);
+        NVIC_SetPriority(irqn, CY_RETARGET_IO_IRQ_PRIORITY);
+        NVIC_EnableIRQ(irqn);
+    }
+    return rslt;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_set_route
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_retarget_io_set_route(int fd, XMC_USIC_CH_t* channel)
+{
+    if ((fd < CY_RETARGET_IO_STDIN) || (fd > CY_RETARGET_IO_STDERR))
+    {
+        return CY_RETARGET_IO_RSLT_BAD_PARAM;
+    }
+
+    cy_retarget_io_route_t* route = &cy_retarget_io_routes[fd];
+    if ((channel == NULL) || (channel == cy_retarget_io_uart_obj.channel))
+    {
+        route->channel = NULL;
+        return CY_RSLT_SUCCESS;
+    }
+
+    cy_rslt_t rslt = cy_retarget_io_route_lock_init(route);
+    if (rslt == CY_RSLT_SUCCESS)
+    {
+        route->prev_char = '\n';
+        route->channel = channel;
+    }
+    return rslt;
+}
+
+
+// Time given to pending output to drain if the baud rate is not known
+#define CY_RETARGET_IO_DRAIN_TIMEOUT_US     (1000000UL)
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_drain_timeout_us
+//
+// Time needed to send the content of all buffers at the current baud rate, with 50% padding
+//--------------------------------------------------------------------------------------------------
+static uint32_t cy_retarget_io_drain_timeout_us(void)
+{
+    if (cy_retarget_io_baudrate == 0U)
+    {
+        return CY_RETARGET_IO_DRAIN_TIMEOUT_US;
+    }
+    // Ring buffers, FIFO, transmit buffer and shift register, 10 bits per frame
+    uint64_t bytes = (uint64_t)cy_retarget_io_tx_fifo_size + 2U;
+    if (cy_retarget_io_tx_ring.buffer != NULL)
+    {
+        bytes += cy_retarget_io_tx_ring.size;
+    }
+    if (cy_retarget_io_tx_high_ring.buffer != NULL)
+    {
+        bytes += cy_retarget_io_tx_high_ring.size;
+    }
+    #if defined(CY_RETARGET_IO_COMPRESS)
+    // The frame being sent, the few bytes incompressible data grows by are within the margin
+    bytes += CY_RETARGET_IO_LZ_FRAME_SIZE;
+    #endif
+    uint64_t timeout_us = ((bytes * 10U * 1000000U) / cy_retarget_io_baudrate) * 3U / 2U;
+    return (timeout_us > UINT32_MAX) ? UINT32_MAX : (uint32_t)timeout_us;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_close
+//
+// Makes producers of the buffered mode fail to reserve space, like while a region handed out by
+// cy_retarget_io_reserve is open: tasks wait until it is reopened and interrupts drop their output.
+// Returns false if a region is open. Must be called with the mutex held.
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_tx_close(void)
+{
+    uint32_t state;
+    do
+    {
+        state = cy_retarget_io_tx_state;
+        if ((state & CY_RETARGET_IO_TX_OPEN) != 0U)
+        {
+            return false;
+        }
+    } while (!cy_retarget_io_atomic_cas(&cy_retarget_io_tx_state, state,
+                                        state | CY_RETARGET_IO_TX_OPEN));
+    cy_retarget_io_tx_set_owner(true);
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_reopen
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_tx_reopen(void)
+{
+    uint32_t state;
+    cy_retarget_io_tx_set_owner(false);
+    do
+    {
+        state = cy_retarget_io_tx_state;
+    } while (!cy_retarget_io_atomic_cas(&cy_retarget_io_tx_state, state,
+                                        state & ~CY_RETARGET_IO_TX_OPEN));
+    cy_retarget_io_tx_open_notify();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_set_baudrate
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_retarget_io_set_baudrate(uint32_t baudrate)
+{
+    XMC_USIC_CH_t* channel = cy_retarget_io_uart_obj.channel;
+    if ((channel == NULL) || (baudrate == 0U))
+    {
+        return CY_RETARGET_IO_RSLT_BAD_PARAM;
+    }
+
+    // The polling mode writes with the mutex held, so does the holder of a reserved region
+    cy_retarget_io_mutex_acquire();
+    #if defined(CY_RETARGET_IO_TASK_LINES)
+    // Send the partial line of the caller while the ring is open, the flush below would find it
+    // closed by this caller and drop the line
+    cy_retarget_io_line_flush();
+    #endif
+    bool buffered = (cy_retarget_io_tx_ring.buffer != NULL);
+    bool closed   = buffered && cy_retarget_io_tx_close();
+    // A region or a concurrent call holds the ring, wait until it is reopened
+    while (buffered && !closed && cy_retarget_io_tx_wait_open_unlocked())
+    {
+        closed = cy_retarget_io_tx_close();
+    }
+
+    cy_rslt_t rslt = CY_RETARGET_IO_RSLT_UNSUPPORTED;
+    if (closed)
+    {
+        // The closed ring keeps the writers out while it drains, the mutex is released meanwhile
+        // so that tasks calling cy_retarget_io_reserve wait for the ring without holding it
+        cy_retarget_io_mutex_release();
+        rslt = cy_retarget_io_flush(cy_retarget_io_drain_timeout_us());
+        cy_retarget_io_mutex_acquire();
+    }
+    else if (!buffered)
+    {
+        // Only the transmit FIFO and the shift register are left to wait for
+        rslt = cy_retarget_io_flush(cy_retarget_io_drain_timeout_us());
+    }
+
+    if (CY_RSLT_SUCCESS == rslt)
+    {
+        // Keep the oversampling configured by the BSP
+        uint32_t oversampling =
+            ((channel->BRG & USIC_CH_BRG_DCTQ_Msk) >> USIC_CH_BRG_DCTQ_Pos) + 1U;
+        if (XMC_UART_CH_SetBaudrate(channel, baudrate, oversampling) == XMC_UART_CH_STATUS_OK)
+        {
+            cy_retarget_io_baudrate = baudrate;
+        }
+        else
+        {
+            rslt = CY_RETARGET_IO_RSLT_UNSUPPORTED;
+        }
+    }
+
+    if (closed)
+    {
+        cy_retarget_io_tx_reopen();
+    }
+    cy_retarget_io_mutex_release();
+    return rslt;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_init_buffered
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_retarget_io_init_buffered(XMC_USIC_CH_t* channel, uint8_t* buffer, size_t size)
+{
+    if (buffer == NULL)
+    {
+        return CY_RETARGET_IO_RSLT_BAD_PARAM;
+    }
+
+    cy_retarget_io_config_t config;
+    (void)memset(&config, 0, sizeof(config));
+    config.channel        = channel;
+    config.tx_buffer      = buffer;
+    config.tx_buffer_size = size;
+    return cy_retarget_io_init_cfg(&config);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_rx_service
+//
+// Moves all received data from the USIC channel into the receive ring buffer
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_rx_service(void)
+{
+    XMC_USIC_CH_t* channel = cy_retarget_io_uart_obj.channel;
+    cy_retarget_io_ring_t* ring = &cy_retarget_io_rx_ring;
+    size_t head = ring->head;
+    bool use_fifo = ((channel->RBCTR & USIC_CH_RBCTR_SIZE_Msk) != 0U);
+    uint16_t data;
+
+    if (use_fifo)
+    {
+        XMC_USIC_CH_RXFIFO_ClearEvent(channel, XMC_USIC_CH_RXFIFO_EVENT_STANDARD |
+                                      XMC_USIC_CH_RXFIFO_EVENT_ALTERNATE);
+    }
+    for (;;)
+    {
+        if (use_fifo)
+        {
+            if (XMC_USIC_CH_RXFIFO_IsEmpty(channel))
+            {
+                break;
+            }
+            data = XMC_USIC_CH_RXFIFO_GetData(channel);
+        }
+        else
+        {
+            uint32_t status = XMC_UART_CH_GetStatusFlag(channel);
+            if ((status & XMC_UART_CH_STATUS_FLAG_DATA_LOST_INDICATION) != 0U)
+            {
+                ++cy_retarget_io_rx_hw_overruns;
+                XMC_UART_CH_ClearStatusFlag(channel, XMC_UART_CH_STATUS_FLAG_DATA_LOST_INDICATION);
+            }
+            if ((status & (XMC_UART_CH_STATUS_FLAG_RECEIVE_INDICATION |
+                           XMC_UART_CH_STATUS_FLAG_ALTERNATIVE_RECEIVE_INDICATION)) == 0U)
+            {
+                break;
+            }
+            data = XMC_UART_CH_GetReceivedData(channel);
+            XMC_UART_CH_ClearStatusFlag(channel,
+                                        XMC_UART_CH_STATUS_FLAG_ALTERNATIVE_RECEIVE_INDICATION |
+                                        XMC_UART_CH_STATUS_FLAG_RECEIVE_INDICATION);
+        }
+
+        size_t next = cy_retarget_io_ring_next(ring, head);
+        if (next == ring->tail)
+        {
+            // Keep the data already buffered, drop the new byte
+            ++cy_retarget_io_rx_ring_overruns;
+        }
+        else
+        {
+            ring->buffer[head] = (uint8_t)data;
+            head = next;
+        }
+    }
+    ring->head = head;
+    CY_RETARGET_IO_STATS_HIGH_WATER(rx_high_water,
+                                    cy_retarget_io_ring_distance(ring, ring->tail, head));
+
+    #if defined(CY_RETARGET_IO_RTOS_WAIT)
+    if (!cy_retarget_io_ring_is_empty(ring))
+    {
+        cy_retarget_io_waiter_signal(&cy_retarget_io_rx_waiter);
+    }
+    #endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_irq_handler
+//--------------------------------------------------------------------------------------------------
+void cy_retarget_io_irq_handler(void)
+{
+    if (cy_retarget_io_rx_ring.buffer != NULL)
+    {
+        cy_retarget_io_rx_service();
+    }
+    if (cy_retarget_io_tx_ring.buffer != NULL)
+    {
+        cy_retarget_io_tx_service();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_service
+//
+// Moves pending data from the transmit ring buffer to the USIC channel
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_tx_service(void)
+{
+    XMC_USIC_CH_t* channel = cy_retarget_io_uart_obj.channel;
+    const uint8_t* data;
+    size_t len;
+    cy_retarget_io_tx_in_service = true;
+
+    #if (UC_FAMILY == XMC4)
+    if (cy_retarget_io_dma_channel >= 0)
+    {
+        // Only reached when draining with interrupts masked, the DMA event chains otherwise
+        cy_retarget_io_dma_service();
+    }
+    else
+    #endif // (UC_FAMILY == XMC4)
+    if (cy_retarget_io_tx_fifo_size != 0U)
+    {
+        XMC_USIC_CH_TXFIFO_ClearEvent(channel, XMC_USIC_CH_TXFIFO_EVENT_STANDARD);
+
+        // Fill the FIFO with one status read. If data is left in the ring buffer afterwards the
+        // FIFO is full and the next standard transmit buffer event resumes the transfer.
+        uint32_t space = cy_retarget_io_tx_fifo_get_space(channel);
+        do
+        {
+            len = cy_retarget_io_tx_next_segment(&data);
+            if (len > space)
+            {
+                len = space;
+            }
+            for (size_t i = 0U; i < len; ++i)
+            {
+                XMC_USIC_CH_TXFIFO_PutData(channel, data[i]);
+            }
+            cy_retarget_io_tx_consume(len);
+            space -= (uint32_t)len;
+        } while ((space > 0U) && !cy_retarget_io_tx_stop_if_empty());
+    }
+    // A busy TBUF raises the transmit buffer event again once it is moved to the shift register
+    else if (XMC_USIC_CH_GetTransmitBufferStatus(channel) == XMC_USIC_CH_TBUF_STATUS_IDLE)
+    {
+        len = cy_retarget_io_tx_next_segment(&data);
+        if ((len == 0U) && !cy_retarget_io_tx_stop_if_empty())
+        {
+            // Data was completed after the segment was taken
+            len = cy_retarget_io_tx_next_segment(&data);
+        }
+        if (len != 0U)
+        {
+            XMC_UART_CH_ClearStatusFlag(channel,
+                                        XMC_UART_CH_STATUS_FLAG_TRANSMIT_BUFFER_INDICATION);
+            XMC_USIC_CH_WriteTransmitBuffer(channel, data[0]);
+            cy_retarget_io_tx_consume(1U);
+        }
+    }
+    cy_retarget_io_tx_in_service = false;
+    cy_retarget_io_tx_notify();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_hw_active
+//
+// Checks whether the DMA, the transmit FIFO or the shift register still hold output
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_tx_hw_active(void)
+{
+    #if (UC_FAMILY == XMC4)
+    if (cy_retarget_io_dma_len != 0U)
+    {
+        return true;
+    }
+    #endif // (UC_FAMILY == XMC4)
+
+    // The channel may be idle for a moment between two frames taken from the FIFO
+    if ((cy_retarget_io_tx_fifo_size != 0U) &&
+        !XMC_USIC_CH_TXFIFO_IsEmpty(cy_retarget_io_uart_obj.channel))
+    {
+        return true;
+    }
+    return (XMC_UART_CH_GetStatusFlag(cy_retarget_io_uart_obj.channel) &
+            XMC_UART_CH_STATUS_FLAG_TRANSFER_STATUS_BUSY) > 0U;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_is_tx_active
+//--------------------------------------------------------------------------------------------------
+bool cy_retarget_io_is_tx_active()
+{
+    if ((cy_retarget_io_tx_ring.buffer != NULL) && !cy_retarget_io_tx_is_drained())
+    {
+        return true;
+    }
+    return cy_retarget_io_tx_hw_active();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_flush_wait
+//
+// Waits for the buffered transmit path to make progress and returns the cycles elapsed since
+// cy_retarget_io_cycles_start. limit is the timeout in core clock cycles. A task blocks until the
+// ring buffers are drained or the time is up, the wait is measured with the RTOS time as the
+// cycle count may wrap around meanwhile. Without an RTOS the core sleeps until the next
+// interrupt, but only while SysTick interrupts end the sleep in time: a line that stalls does not
+// raise the interrupt that ends it otherwise. With interrupts masked the handler cannot run, so
+// the channel is drained here. Returns at once otherwise, the caller polls.
+//--------------------------------------------------------------------------------------------------
+static uint64_t cy_retarget_io_flush_wait(cy_retarget_io_cycles_t* cycles, uint64_t limit)
+{
+    #if defined(CY_RETARGET_IO_RTOS_WAIT)
+    uint32_t cycles_per_ms = SystemCoreClock / 1000U;
+    uint64_t left_ms       = (limit - cycles->elapsed) / cycles_per_ms;
+    #else
+    (void)limit;
+    #endif
+    if (cy_retarget_io_tx_ring.buffer == NULL)
+    {
+        // The polling mode only waits for the last characters in the USIC channel
+    }
+    else if (__get_PRIMASK() != 0U)
+    {
+        cy_retarget_io_tx_service();
+    }
+    #if defined(CY_RETARGET_IO_RTOS_WAIT)
+    else if (cy_retarget_io_waiter_can_block(&cy_retarget_io_tx_waiter) && (left_ms > 0U))
+    {
+        uint64_t  elapsed = cy_retarget_io_cycles_sample(cycles);
+        cy_time_t start;
+        cy_time_t now;
+        (void)cy_rtos_get_time(&start);
+        // At most 2^32 us, so never CY_RTOS_NEVER_TIMEOUT
+        cy_retarget_io_waiter_wait(&cy_retarget_io_tx_waiter, cy_retarget_io_tx_is_drained,
+                                   (cy_time_t)left_ms);
+        (void)cy_rtos_get_time(&now);
+        (void)cy_retarget_io_cycles_sample(cycles);
+        cycles->elapsed = elapsed + ((uint64_t)(cy_time_t)(now - start) * cycles_per_ms);
+        return cycles->elapsed;
+    }
+    #endif
+    else if ((SysTick->CTRL & SysTick_CTRL_TICKINT_Msk) != 0U)
+    {
+        cy_retarget_io_tx_sleep(cycles);
+    }
+    return cy_retarget_io_cycles_sample(cycles);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_flush
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_retarget_io_flush(uint32_t timeout_us)
+{
+    cy_rslt_t rslt  = CY_RETARGET_IO_RSLT_TIMEOUT;
+    uint64_t  limit = cy_retarget_io_us_to_cycles(timeout_us);
+    cy_retarget_io_cycles_t cycles;
+
+    #if defined(CY_RETARGET_IO_TASK_LINES)
+    cy_retarget_io_line_flush();
+    #endif
+    cy_retarget_io_cycles_start(&cycles);
+    do
+    {
+        if (!cy_retarget_io_is_tx_active())
+        {
+            rslt = CY_RSLT_SUCCESS;
+            break;
+        }
+    } while (cy_retarget_io_flush_wait(&cycles, limit) < limit);
+    cy_retarget_io_cycles_stop(&cycles);
+    return rslt;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_line_release
+//--------------------------------------------------------------------------------------------------
+void cy_retarget_io_line_release(void* thread)
+{
+    #if defined(CY_RETARGET_IO_TASK_LINES)
+    cy_thread_t owner = (cy_thread_t)thread;
+    if (((owner == NULL) && (cy_rtos_get_thread_handle(&owner) != CY_RSLT_SUCCESS)) ||
+        (owner == NULL))
+    {
+        return;
+    }
+
+    cy_retarget_io_line_t* line = NULL;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    for (size_t i = 0U; (i < CY_RETARGET_IO_LINE_BUFFERS) && (line == NULL); ++i)
+    {
+        if (cy_retarget_io_lines[i].owner == owner)
+        {
+            line = &cy_retarget_io_lines[i];
+        }
+    }
+    __set_PRIMASK(primask);
+    if (line != NULL)
+    {
+        // Sending the whole rest returns the buffer to the pool
+        cy_retarget_io_line_send(line, line->len);
+    }
+    #else
+    (void)thread;
+    #endif // defined(CY_RETARGET_IO_TASK_LINES)
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_open_space
+//
+// Contiguous free space after the reserved area of state, or at the start of the buffer if the
+// space up to its end is shorter than max and less than the space at the start. In that case skip
+// is set to the length of the unused end.
+//--------------------------------------------------------------------------------------------------
+static size_t cy_retarget_io_tx_open_space(uint32_t state, size_t max, size_t* start, size_t* skip)
+{
+    const cy_retarget_io_ring_t* ring = &cy_retarget_io_tx_ring;
+    size_t end  = state & CY_RETARGET_IO_TX_RESERVED_Msk;
+    size_t tail = ring->tail;
+    size_t cap;
+    *start = end;
+    *skip  = 0U;
+    if (end >= tail)
+    {
+        // One byte always stays free, so the end of the buffer can only be used up if the tail is
+        // not at its start
+        cap = ring->size - end - ((tail == 0U) ? 1U : 0U);
+        size_t wrap = (tail > 0U) ? (tail - 1U) : 0U;
+        if ((cap < max) && (wrap > cap) && (cy_retarget_io_tx_skip_len == 0U))
+        {
+            *start = 0U;
+            *skip  = ring->size - end;
+            cap    = wrap;
+        }
+    }
+    else
+    {
+        cap = tail - end - 1U;
+    }
+    return cap;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_open
+//
+// Hands out the contiguous free space after the reserved area, at least min_len bytes, see
+// cy_retarget_io_tx_open_space. Returns the usable length, 0 if not enough space is free or
+// another region is open.
+//--------------------------------------------------------------------------------------------------
+static size_t cy_retarget_io_tx_open(size_t min_len, size_t max, void** ptr)
+{
+    cy_retarget_io_ring_t* ring = &cy_retarget_io_tx_ring;
+    uint32_t state;
+    size_t   start;
+    size_t   cap;
+    size_t   skip;
+    do
+    {
+        state = cy_retarget_io_tx_state;
+        if ((state & CY_RETARGET_IO_TX_OPEN) != 0U)
+        {
+            return 0U;
+        }
+        cap = cy_retarget_io_tx_open_space(state, max, &start, &skip);
+        if ((cap == 0U) || (cap < min_len))
+        {
+            return 0U;
+        }
+    } while (!cy_retarget_io_atomic_cas(&cy_retarget_io_tx_state, state,
+                                        state | CY_RETARGET_IO_TX_OPEN));
+    cy_retarget_io_tx_set_owner(true);
+
+    cy_retarget_io_tx_open_start = start;
+    cy_retarget_io_tx_open_cap   = cap;
+    cy_retarget_io_tx_open_skip  = skip;
+    cy_retarget_io_tx_open_len   = (cap < max) ? cap : max;
+    *ptr = &ring->buffer[start];
+    return cy_retarget_io_tx_open_len;
+}
+
+
+#if defined(CY_RETARGET_IO_RTOS_WAIT)
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_can_open
+//
+// Whether cy_retarget_io_tx_open can hand out cy_retarget_io_tx_open_min bytes, or has to wait for
+// the ring to be reopened instead. Asking for no more than that takes the start of the buffer
+// whenever the end is too short, like any larger request would.
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_tx_can_open(void)
+{
+    uint32_t state = cy_retarget_io_tx_state;
+    size_t   start;
+    size_t   skip;
+    return ((state & CY_RETARGET_IO_TX_OPEN) != 0U) ||
+           (cy_retarget_io_tx_open_space(state, cy_retarget_io_tx_open_min, &start, &skip) >=
+            cy_retarget_io_tx_open_min);
+}
+
+
+#endif // defined(CY_RETARGET_IO_RTOS_WAIT)
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_wait_region
+//
+// Waits until min_len contiguous bytes are free. Half of the ring buffer being free, which the
+// writers wait for, is not enough: the free space may be split by the end of the buffer, and
+// waiting for that would return at once until the tail wraps.
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_tx_wait_region(size_t min_len)
+{
+    #if defined(CY_RETARGET_IO_RTOS_WAIT)
+    if (cy_retarget_io_waiter_can_block(&cy_retarget_io_tx_waiter))
+    {
+        CY_RETARGET_IO_STATS_START(start);
+        cy_retarget_io_tx_open_min = min_len;
+        cy_retarget_io_waiter_wait(&cy_retarget_io_tx_waiter, cy_retarget_io_tx_can_open,
+                                   CY_RTOS_NEVER_TIMEOUT);
+        CY_RETARGET_IO_STATS_CYCLES(tx_blocked_cycles, start);
+    }
+    else
+    #else
+    (void)min_len;
+    #endif
+    {
+        cy_retarget_io_tx_wait();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_reserve
+//--------------------------------------------------------------------------------------------------
+size_t cy_retarget_io_reserve(size_t max, void** ptr)
+{
+    cy_retarget_io_ring_t* ring = &cy_retarget_io_tx_ring;
+    if ((ring->buffer == NULL) || (ptr == NULL) || (max == 0U))
+    {
+        return 0U;
+    }
+
+    // Serializes the tasks using the region, interrupts cannot take the mutex
+    bool locked = (__get_IPSR() == 0U);
+    if (locked)
+    {
+        cy_retarget_io_mutex_acquire();
+    }
+
+    // Waiting is only possible for the amount a writer could wait for
+    size_t max_chunk = (ring->size - 1U) / 2U;
+    size_t min_len   = (cy_retarget_io_tx_policy == CY_RETARGET_IO_OVERFLOW_BLOCK)
+        ? ((max < max_chunk) ? max : max_chunk)
+        : 1U;
+    size_t len = cy_retarget_io_tx_open(min_len, max, ptr);
+    while ((len == 0U) && locked && (cy_retarget_io_tx_policy == CY_RETARGET_IO_OVERFLOW_BLOCK))
+    {
+        if (cy_retarget_io_tx_can_reserve())
+        {
+            cy_retarget_io_tx_wait_region(min_len);
+        }
+        else if (!cy_retarget_io_tx_wait_open_unlocked())
+        {
+            break;
+        }
+        len = cy_retarget_io_tx_open(min_len, max, ptr);
+    }
+
+    if (len == 0U)
+    {
+        if (locked)
+        {
+            cy_retarget_io_mutex_release();
+        }
+    }
+    else
+    {
+        cy_retarget_io_tx_open_locked = locked;
+    }
+    return len;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_commit
+//--------------------------------------------------------------------------------------------------
+void cy_retarget_io_commit(size_t used)
+{
+    cy_retarget_io_ring_t* ring = &cy_retarget_io_tx_ring;
+    if ((cy_retarget_io_tx_state & CY_RETARGET_IO_TX_OPEN) == 0U)
+    {
+        return;
+    }
+    if (used > cy_retarget_io_tx_open_len)
+    {
+        used = cy_retarget_io_tx_open_len;
+    }
+
+    // The CRs and headers are inserted into the space that was handed out but not used. The region
+    // holds off all other producers, so the PREV bits cannot change until it is closed.
+    cy_retarget_io_out_t out;
+    cy_retarget_io_out_begin(&out, cy_retarget_io_tx_prev_char(cy_retarget_io_tx_state));
+    char*  data = (char*)&ring->buffer[cy_retarget_io_tx_open_start];
+    size_t kept = used;
+    size_t len  = cy_retarget_io_out_expand(data, &kept, cy_retarget_io_tx_open_cap, &out);
+    if (kept < used)
+    {
+        cy_retarget_io_atomic_add(&cy_retarget_io_tx_dropped, (uint32_t)(used - kept));
+    }
+
+    uint32_t state;
+    uint32_t next;
+    if ((len > 0U) && (data[len - 1U] == '\n'))
+    {
+        cy_retarget_io_tx_mark(cy_retarget_io_ring_advance(ring, cy_retarget_io_tx_open_start,
+                                                          len));
+    }
+    if ((len > 0U) && (cy_retarget_io_tx_open_skip != 0U))
+    {
+        cy_retarget_io_tx_skip_start = cy_retarget_io_tx_state & CY_RETARGET_IO_TX_RESERVED_Msk;
+        cy_retarget_io_tx_skip_len   = cy_retarget_io_tx_open_skip;
+    }
+
+    // The data and the unused area must be in memory before the consumer can see them
+    cy_retarget_io_tx_set_owner(false);
+    __DMB();
+    do
+    {
+        state = cy_retarget_io_tx_state;
+        next  = state & ~CY_RETARGET_IO_TX_OPEN;
+        if (len > 0U)
+        {
+            next = (next & ~CY_RETARGET_IO_TX_RESERVED_Msk) |
+                   (uint32_t)cy_retarget_io_ring_advance(ring, cy_retarget_io_tx_open_start, len);
+            if (CY_RETARGET_IO_TX_TRANSFORM)
+            {
+                next = cy_retarget_io_tx_prev_bits(next, data[len - 1U]);
+            }
+        }
+    } while (!cy_retarget_io_atomic_cas(&cy_retarget_io_tx_state, state, next));
+    CY_RETARGET_IO_STATS_COUNT(bytes_written, len);
+    CY_RETARGET_IO_STATS_HIGH_WATER(tx_high_water, cy_retarget_io_tx_used());
+    cy_retarget_io_tx_open_notify();
+
+    if ((len > 0U) && ((next & CY_RETARGET_IO_TX_WRITERS_Msk) == 0U))
+    {
+        cy_retarget_io_tx_kick();
+    }
+    if (cy_retarget_io_tx_open_locked)
+    {
+        cy_retarget_io_tx_open_locked = false;
+        cy_retarget_io_mutex_release();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_write_nb
+//--------------------------------------------------------------------------------------------------
+size_t cy_retarget_io_write_nb(const void* data, size_t len)
+{
+    if ((data == NULL) || (cy_retarget_io_tx_ring.buffer == NULL))
+    {
+        return 0U;
+    }
+    cy_retarget_io_overflow_policy_t policy = (cy_retarget_io_tx_policy ==
+                                               CY_RETARGET_IO_OVERFLOW_BLOCK)
+        ? CY_RETARGET_IO_OVERFLOW_DROP_NEWEST
+        : cy_retarget_io_tx_policy;
+    size_t nChars = cy_retarget_io_tx_write((const char*)data, len, policy, true);
+    CY_RETARGET_IO_STATS_COUNT(bytes_written, nChars);
+    return nChars;
+}
+
+
+// Bytes taken from the trace capture log at a time by cy_retarget_io_dump
+#define CY_RETARGET_IO_DUMP_CHUNK           (64U)
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_dump
+//--------------------------------------------------------------------------------------------------
+size_t cy_retarget_io_dump(void)
+{
+    cy_retarget_io_capture_t* capture = &cy_retarget_io_capture;
+    if (capture->buffer == NULL)
+    {
+        return 0U;
+    }
+    cy_retarget_io_ring_t ring;
+    ring.buffer = capture->buffer;
+    ring.size   = capture->size;
+    ring.head   = 0U;
+    ring.tail   = 0U;
+
+    // Writers are only held off while a chunk is taken, meanwhile they overwrite the oldest output
+    // as before. Only the output captured so far is sent, so writers cannot keep the call busy.
+    char   chunk[CY_RETARGET_IO_DUMP_CHUNK];
+    size_t total = 0U;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    size_t left = cy_retarget_io_ring_distance(&ring, capture->tail, capture->head);
+    __set_PRIMASK(primask);
+    while (left > 0U)
+    {
+        size_t len = 0U;
+        primask = __get_PRIMASK();
+        __disable_irq();
+        while ((len < left) && (len < sizeof(chunk)) && (capture->tail != capture->head))
+        {
+            chunk[len]    = (char)capture->buffer[capture->tail];
+            capture->tail = cy_retarget_io_ring_next(&ring, capture->tail);
+            ++len;
+        }
+        __set_PRIMASK(primask);
+        if (len == 0U)
+        {
+            break;
+        }
+        cy_retarget_io_raw_write(chunk, len);
+        total += len;
+        left  -= len;
+    }
+    return total;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_read
+//--------------------------------------------------------------------------------------------------
+size_t cy_retarget_io_read(void* buf, size_t len, uint32_t timeout_ms, uint32_t flags)
+{
+    char*    ptr       = (char*)buf;
+    size_t   nChars    = 0U;
+    bool     eol       = false;
+    uint64_t waited_us = 0U;
+    if ((ptr == NULL) || (len == 0U))
+    {
+        return 0U;
+    }
+
+    #if defined(CY_RETARGET_IO_TASK_LINES)
+    // A prompt without LF must be visible before the task waits for the answer
+    cy_retarget_io_line_flush();
+    #endif
+    CY_RETARGET_IO_STATS_START(start);
+    // The receive ring buffer is selected by a NULL channel
+    cy_retarget_io_route_t* route = cy_retarget_io_get_route(CY_RETARGET_IO_STDIN);
+    XMC_USIC_CH_t* channel = (route != NULL) ? route->channel :
+                             ((cy_retarget_io_rx_ring.buffer != NULL)
+                              ? NULL : cy_retarget_io_uart_obj.channel);
+    if (route != NULL)
+    {
+        cy_retarget_io_route_lock(route);
+    }
+    // In raw mode, only wait until the first data is available
+    do
+    {
+        nChars += cy_retarget_io_rx_take(channel, &ptr[nChars], len - nChars, flags, &eol);
+    } while (!eol && (nChars < len) &&
+             ((nChars == 0U) || ((flags & CY_RETARGET_IO_READ_LINE) != 0U)) &&
+             cy_retarget_io_rx_wait_for(channel, timeout_ms, &waited_us));
+    if (route != NULL)
+    {
+        cy_retarget_io_route_unlock(route);
+    }
+    CY_RETARGET_IO_STATS_CYCLES(rx_blocked_cycles, start);
+    CY_RETARGET_IO_STATS_COUNT(bytes_read, nChars);
+    return nChars;
+}
+
+
+// Initial value of the frame CRC
+#define CY_RETARGET_IO_FRAME_CRC_INIT       (0xFFFFU)
+
+// Most non-zero bytes of a COBS block, whose code byte is one more
+#define CY_RETARGET_IO_FRAME_BLOCK          (254U)
+
+// Byte ending a frame, COBS removes it from the encoded data
+#define CY_RETARGET_IO_FRAME_DELIMITER      (0x00U)
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_frame_crc_table
+//
+// CRC-16/CCITT-FALSE of each byte value: polynomial 0x1021, initial value 0xFFFF, not reflected
+//--------------------------------------------------------------------------------------------------
+static const uint16_t cy_retarget_io_frame_crc_table[256] =
+{
+    0x0000U, 0x1021U, 0x2042U, 0x3063U, 0x4084U, 0x50A5U, 0x60C6U, 0x70E7U,
+    0x8108U, 0x9129U, 0xA14AU, 0xB16BU, 0xC18CU, 0xD1ADU, 0xE1CEU, 0xF1EFU,
+    0x1231U, 0x0210U, 0x3273U, 0x2252U, 0x52B5U, 0x4294U, 0x72F7U, 0x62D6U,
+    0x9339U, 0x8318U, 0xB37BU, 0xA35AU, 0xD3BDU, 0xC39CU, 0xF3FFU, 0xE3DEU,
+    0x2462U, 0x3443U, 0x0420U, 0x1401U, 0x64E6U, 0x74C7U, 0x44A4U, 0x5485U,
+    0xA56AU, 0xB54BU, 0x8528U, 0x9509U, 0xE5EEU, 0xF5CFU, 0xC5ACU, 0xD58DU,
+    0x3653U, 0x2672U, 0x1611U, 0x0630U, 0x76D7U, 0x66F6U, 0x5695U, 0x46B4U,
+    0xB75BU, 0xA77AU, 0x9719U, 0x8738U, 0xF7DFU, 0xE7FEU, 0xD79DU, 0xC7BCU,
+    0x48C4U, 0x58E5U, 0x6886U, 0x78A7U, 0x0840U, 0x1861U, 0x2802U, 0x3823U,
+    0xC9CCU, 0xD9EDU, 0xE98EU, 0xF9AFU, 0x8948U, 0x9969U, 0xA90AU, 0xB92BU,
+    0x5AF5U, 0x4AD4U, 0x7AB7U, 0x6A96U, 0x1A71U, 0x0A50U, 0x3A33U, 0x2A12U,
+    0xDBFDU, 0xCBDCU, 0xFBBFU, 0xEB9EU, 0x9B79U, 0x8B58U, 0xBB3BU, 0xAB1AU,
+    0x6CA6U, 0x7C87U, 0x4CE4U, 0x5CC5U, 0x2C22U, 0x3C03U, 0x0C60U, 0x1C41U,
+    0xEDAEU, 0xFD8FU, 0xCDECU, 0xDDCDU, 0xAD2AU, 0xBD0BU, 0x8D68U, 0x9D49U,
+    0x7E97U, 0x6EB6U, 0x5ED5U, 0x4EF4U, 0x3E13U, 0x2E32U, 0x1E51U, 0x0E70U,
+    0xFF9FU, 0xEFBEU, 0xDFDDU, 0xCFFCU, 0xBF1BU, 0xAF3AU, 0x9F59U, 0x8F78U,
+    0x9188U, 0x81A9U, 0xB1CAU, 0xA1EBU, 0xD10CU, 0xC12DU, 0xF14EU, 0xE16FU,
+    0x1080U, 0x00A1U, 0x30C2U, 0x20E3U, 0x5004U, 0x4025U, 0x7046U, 0x6067U,
+    0x83B9U, 0x9398U, 0xA3FBU, 0xB3DAU, 0xC33DU, 0xD31CU, 0xE37FU, 0xF35EU,
+    0x02B1U, 0x1290U, 0x22F3U, 0x32D2U, 0x4235U, 0x5214U, 0x6277U, 0x7256U,
+    0xB5EAU, 0xA5CBU, 0x95A8U, 0x8589U, 0xF56EU, 0xE54FU, 0xD52CU, 0xC50DU,
+    0x34E2U, 0x24C3U, 0x14A0U, 0x0481U, 0x7466U, 0x6447U, 0x5424U, 0x4405U,
+    0xA7DBU, 0xB7FAU, 0x8799U, 0x97B8U, 0xE75FU, 0xF77EU, 0xC71DU, 0xD73CU,
+    0x26D3U, 0x36F2U, 0x0691U, 0x16B0U, 0x6657U, 0x7676U, 0x4615U, 0x5634U,
+    0xD94CU, 0xC96DU, 0xF90EU, 0xE92FU, 0x99C8U, 0x89E9U, 0xB98AU, 0xA9ABU,
+    0x5844U, 0x4865U, 0x7806U, 0x6827U, 0x18C0U, 0x08E1U, 0x3882U, 0x28A3U,
+    0xCB7DU, 0xDB5CU, 0xEB3FU, 0xFB1EU, 0x8BF9U, 0x9BD8U, 0xABBBU, 0xBB9AU,
+    0x4A75U, 0x5A54U, 0x6A37U, 0x7A16U, 0x0AF1U, 0x1AD0U, 0x2AB3U, 0x3A92U,
+    0xFD2EU, 0xED0FU, 0xDD6CU, 0xCD4DU, 0xBDAAU, 0xAD8BU, 0x9DE8U, 0x8DC9U,
+    0x7C26U, 0x6C07U, 0x5C64U, 0x4C45U, 0x3CA2U, 0x2C83U, 0x1CE0U, 0x0CC1U,
+    0xEF1FU, 0xFF3EU, 0xCF5DU, 0xDF7CU, 0xAF9BU, 0xBFBAU, 0x8FD9U, 0x9FF8U,
+    0x6E17U, 0x7E36U, 0x4E55U, 0x5E74U, 0x2E93U, 0x3EB2U, 0x0ED1U, 0x1EF0U
+};
+
+// A payload being encoded, followed by its CRC once the payload has been encoded
+typedef struct
+{
+    const uint8_t* data;    // Payload
+    size_t         len;     // Length of the payload
+    size_t         crc_len; // Bytes of the payload included in crc so far
+    uint16_t       crc;     // CRC of the first crc_len bytes
+} cy_retarget_io_frame_enc_t;
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_frame_crc
+//--------------------------------------------------------------------------------------------------
+static inline uint16_t cy_retarget_io_frame_crc(uint16_t crc, uint8_t value)
+{
+    return (uint16_t)((uint16_t)(crc << 8U) ^
+                      cy_retarget_io_frame_crc_table[(uint8_t)(crc >> 8U) ^ value]);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_frame_max_size
+//
+// Largest encoded size of a payload of len bytes: the delimiters, a code byte per COBS block and
+// the CRC
+//--------------------------------------------------------------------------------------------------
+static inline size_t cy_retarget_io_frame_max_size(size_t len)
+{
+    return (len + 2U) + ((len + 2U) / CY_RETARGET_IO_FRAME_BLOCK) + 3U;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_frame_byte
+//
+// Returns byte i of the payload followed by its CRC, low byte first. Bytes are first requested in
+// order, which adds each payload byte to the CRC once; the CRC bytes are only requested after all
+// payload bytes.
+//--------------------------------------------------------------------------------------------------
+static uint8_t cy_retarget_io_frame_byte(cy_retarget_io_frame_enc_t* enc, size_t i)
+{
+    if (i < enc->len)
+    {
+        uint8_t value = enc->data[i];
+        if (i == enc->crc_len)
+        {
+            enc->crc = cy_retarget_io_frame_crc(enc->crc, value);
+            ++enc->crc_len;
+        }
+        return value;
+    }
+    return (i == enc->len) ? (uint8_t)enc->crc : (uint8_t)(enc->crc >> 8U);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_frame_emit
+//
+// Stores an encoded byte in the transmit ring buffer at *index, or sends it in the polling mode if
+// ring is NULL
+//--------------------------------------------------------------------------------------------------
+static inline void cy_retarget_io_frame_emit(cy_retarget_io_ring_t* ring, size_t* index,
+                                             uint8_t value)
+{
+    if (ring != NULL)
+    {
+        ring->buffer[*index] = value;
+        *index = cy_retarget_io_ring_next(ring, *index);
+    }
+    else
+    {
+        (void)cy_retarget_io_putchar((char)value);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_frame_encode
+//
+// COBS encodes the payload and its CRC between two delimiters. Each block is looked at before its
+// code byte is written, which also computes the CRC, so the payload is copied once and no buffer
+// is needed. Returns the number of bytes emitted.
+//--------------------------------------------------------------------------------------------------
+static size_t cy_retarget_io_frame_encode(cy_retarget_io_ring_t* ring, size_t index,
+                                          cy_retarget_io_frame_enc_t* enc)
+{
+    size_t total = enc->len + 2U;
+    size_t pos   = 0U;
+    size_t count = 2U;
+    cy_retarget_io_frame_emit(ring, &index, CY_RETARGET_IO_FRAME_DELIMITER);
+    // A zero follows the last byte, so the last block always ends with a code byte below 0xFF
+    while (pos <= total)
+    {
+        size_t n = 0U;
+        while (((pos + n) < total) && (n < CY_RETARGET_IO_FRAME_BLOCK) &&
+               (cy_retarget_io_frame_byte(enc, pos + n) != 0U))
+        {
+            ++n;
+        }
+        cy_retarget_io_frame_emit(ring, &index, (uint8_t)(n + 1U));
+        for (size_t i = 0U; i < n; ++i)
+        {
+            cy_retarget_io_frame_emit(ring, &index, cy_retarget_io_frame_byte(enc, pos + i));
+        }
+        count += n + 1U;
+        // Skip the zero ending the block, a full block ends without one
+        pos += (n == CY_RETARGET_IO_FRAME_BLOCK) ? n : (n + 1U);
+    }
+    cy_retarget_io_frame_emit(ring, &index, CY_RETARGET_IO_FRAME_DELIMITER);
+    return count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_tx_reserve_all
+//
+// Reserves len bytes of the transmit ring buffer in one piece for a record that must not be split,
+// waiting or making space as the overflow policy allows. Returns false if the record is dropped.
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_tx_reserve_all(size_t len, size_t* index)
+{
+    cy_retarget_io_overflow_policy_t policy = cy_retarget_io_tx_policy_now();
+    while (!cy_retarget_io_tx_reserve(len, index))
+    {
+        if ((cy_retarget_io_tx_state & CY_RETARGET_IO_TX_OPEN) != 0U)
+        {
+            if ((policy != CY_RETARGET_IO_OVERFLOW_BLOCK) || !cy_retarget_io_tx_wait_open())
+            {
+                return false;
+            }
+        }
+        else if (cy_retarget_io_tx_free() >= len)
+        {
+            // Lost a race against another producer or the consumer, retry
+        }
+        else if (policy == CY_RETARGET_IO_OVERFLOW_BLOCK)
+        {
+            cy_retarget_io_tx_wait();
+        }
+        else if ((policy != CY_RETARGET_IO_OVERFLOW_DROP_OLDEST) ||
+                 !cy_retarget_io_tx_drop_oldest(len))
+        {
+            // A truncated frame would be useless
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_write_frame
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_retarget_io_write_frame(const void* data, size_t len)
+{
+    cy_retarget_io_ring_t* ring = &cy_retarget_io_tx_ring;
+    size_t max = cy_retarget_io_frame_max_size(len);
+    if ((data == NULL) && (len != 0U))
+    {
+        return CY_RETARGET_IO_RSLT_BAD_PARAM;
+    }
+
+    cy_retarget_io_frame_enc_t enc;
+    enc.data    = (const uint8_t*)data;
+    enc.len     = len;
+    enc.crc_len = 0U;
+    enc.crc     = CY_RETARGET_IO_FRAME_CRC_INIT;
+
+    if (ring->buffer != NULL)
+    {
+        size_t index;
+        if (max > (ring->size - 1U))
+        {
+            return CY_RETARGET_IO_RSLT_BAD_PARAM;
+        }
+        if (!cy_retarget_io_tx_reserve_all(max, &index))
+        {
+            cy_retarget_io_atomic_add(&cy_retarget_io_tx_dropped, (uint32_t)len);
+            return CY_RETARGET_IO_RSLT_DROPPED;
+        }
+        cy_retarget_io_tx_mark(index);
+        size_t count = cy_retarget_io_frame_encode(ring, index, &enc);
+        // The rest of the worst case reservation is sent as empty frames, which are ignored
+        for (index = cy_retarget_io_ring_advance(ring, index, count); count < max; ++count)
+        {
+            ring->buffer[index] = CY_RETARGET_IO_FRAME_DELIMITER;
+            index = cy_retarget_io_ring_next(ring, index);
+        }
+        cy_retarget_io_tx_mark(index);
+        CY_RETARGET_IO_STATS_HIGH_WATER(tx_high_water, cy_retarget_io_tx_used());
+        cy_retarget_io_tx_complete();
+    }
+    else if (cy_retarget_io_poll_drop(len))
+    {
+        return CY_RETARGET_IO_RSLT_DROPPED;
+    }
+    else
+    {
+        cy_retarget_io_mutex_acquire();
+        (void)cy_retarget_io_frame_encode(NULL, 0U, &enc);
+        cy_retarget_io_mutex_release();
+    }
+    CY_RETARGET_IO_STATS_COUNT(bytes_written, len);
+    return CY_RSLT_SUCCESS;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_frame_decode
+//
+// Decodes the frame from index from to the delimiter at index to in the receive ring buffer into
+// buf. The last two decoded bytes are held back, at the end they are the CRC. Returns false if the
+// frame is empty, malformed, fails the CRC or does not fit into buf.
+//--------------------------------------------------------------------------------------------------
+static bool cy_retarget_io_frame_decode(size_t from, size_t to, uint8_t* buf, size_t size,
+                                        size_t* len)
+{
+    const cy_retarget_io_ring_t* ring = &cy_retarget_io_rx_ring;
+    uint16_t crc     = CY_RETARGET_IO_FRAME_CRC_INIT;
+    uint8_t  held[2] = { 0U, 0U };
+    size_t   count   = 0U;
+    size_t   pos     = from;
+    while (pos != to)
+    {
+        uint32_t code = ring->buffer[pos];
+        pos = cy_retarget_io_ring_next(ring, pos);
+        for (uint32_t i = 0U; i < code; ++i)
+        {
+            uint8_t value;
+            if ((i + 1U) < code)
+            {
+                if (pos == to)
+                {
+                    return false;
+                }
+                value = ring->buffer[pos];
+                pos   = cy_retarget_io_ring_next(ring, pos);
+            }
+            else if ((code != 0xFFU) && (pos != to))
+            {
+                value = 0U;
+            }
+            else
+            {
+                break;
+            }
+            if (count >= 2U)
+            {
+                if ((count - 2U) >= size)
+                {
+                    return false;
+                }
+                buf[count - 2U] = held[0];
+                crc = cy_retarget_io_frame_crc(crc, held[0]);
+            }
+            held[0] = held[1];
+            held[1] = value;
+            ++count;
+        }
+    }
+    if ((count < 2U) || (crc != ((uint16_t)held[0] | (uint16_t)((uint16_t)held[1] << 8U))))
+    {
+        return false;
+    }
+    *len = count - 2U;
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_read_frame
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_retarget_io_read_frame(void* buf, size_t size, size_t* len, uint32_t timeout_ms)
+{
+    cy_retarget_io_ring_t* ring = &cy_retarget_io_rx_ring;
+    uint64_t waited_us = 0U;
+    if (((buf == NULL) && (size != 0U)) || (len == NULL))
+    {
+        return CY_RETARGET_IO_RSLT_BAD_PARAM;
+    }
+    if (ring->buffer == NULL)
+    {
+        return CY_RETARGET_IO_RSLT_UNSUPPORTED;
+    }
+
+    for (;;)
+    {
+        size_t head = ring->head;
+        size_t pos  = cy_retarget_io_rx_seen;
+        while ((pos != head) && (ring->buffer[pos] != CY_RETARGET_IO_FRAME_DELIMITER))
+        {
+            pos = cy_retarget_io_ring_next(ring, pos);
+        }
+
+        if (pos != head)
+        {
+            size_t tail    = ring->tail;
+            bool   decoded = cy_retarget_io_frame_decode(tail, pos, (uint8_t*)buf, size, len);
+            ring->tail = cy_retarget_io_ring_next(ring, pos);
+            cy_retarget_io_rx_seen = ring->tail;
+            if (decoded)
+            {
+                CY_RETARGET_IO_STATS_COUNT(bytes_read, *len);
+                return CY_RSLT_SUCCESS;
+            }
+            if (tail != pos)
+            {
+                ++cy_retarget_io_rx_bad_frames;
+            }
+        }
+        else
+        {
+            cy_retarget_io_rx_seen = pos;
+            if (cy_retarget_io_ring_next(ring, head) == ring->tail)
+            {
+                // The ring buffer is full without a delimiter, the frame can never complete
+                ring->tail = head;
+                cy_retarget_io_rx_seen = head;
+                ++cy_retarget_io_rx_bad_frames;
+            }
+            if (!cy_retarget_io_rx_wait_for(NULL, timeout_ms, &waited_us))
+            {
+                return CY_RETARGET_IO_RSLT_TIMEOUT;
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_get_timestamp
+//--------------------------------------------------------------------------------------------------
+#if defined(__ICCARM__)
+__weak
+#else
+__attribute__((weak))
+#endif
+uint32_t cy_retarget_io_get_timestamp(void)
+{
+    return 0U;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_put_u32
+//--------------------------------------------------------------------------------------------------
+static inline void cy_retarget_io_put_u32(uint8_t* dst, uint32_t value)
+{
+    dst[0] = (uint8_t)value;
+    dst[1] = (uint8_t)(value >> 8U);
+    dst[2] = (uint8_t)(value >> 16U);
+    dst[3] = (uint8_t)(value >> 24U);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_log_write
+//--------------------------------------------------------------------------------------------------
+void cy_retarget_io_log_write(const char* fmt, const uint32_t* args, size_t count)
+{
+    uint8_t record[CY_RETARGET_IO_LOG_HEADER_SIZE + (4U * CY_RETARGET_IO_LOG_MAX_ARGS)];
+    if (count > CY_RETARGET_IO_LOG_MAX_ARGS)
+    {
+        count = CY_RETARGET_IO_LOG_MAX_ARGS;
+    }
+
+    record[0] = CY_RETARGET_IO_LOG_MARKER;
+    record[1] = (uint8_t)count;
+    cy_retarget_io_put_u32(&record[2], (uint32_t)(uintptr_t)fmt);
+    cy_retarget_io_put_u32(&record[6], cy_retarget_io_get_timestamp());
+    for (size_t i = 0U; i < count; ++i)
+    {
+        cy_retarget_io_put_u32(&record[CY_RETARGET_IO_LOG_HEADER_SIZE + (4U * i)], args[i]);
+    }
+    size_t len = CY_RETARGET_IO_LOG_HEADER_SIZE + (4U * count);
+
+    if ((cy_retarget_io_capture.buffer != NULL) && !cy_retarget_io_in_panic)
+    {
+        (void)cy_retarget_io_capture_write((const char*)record, len, false);
+    }
+    else if ((cy_retarget_io_tx_ring.buffer == NULL) && cy_retarget_io_poll_drop(len))
+    {
+        return;
+    }
+    else
+    {
+        cy_retarget_io_raw_write((const char*)record, len);
+    }
+    CY_RETARGET_IO_STATS_COUNT(bytes_written, len);
+}
+
+
+#if defined(CY_RETARGET_IO_PRINTF_LONG_LONG)
+typedef unsigned long long cy_retarget_io_printf_uint_t;
+#else
+typedef unsigned long cy_retarget_io_printf_uint_t;
+#endif
+
+// Conversion flags of cy_retarget_io_vprintf
+#define CY_RETARGET_IO_PRINTF_LEFT          (1U << 0U) // '-'
+#define CY_RETARGET_IO_PRINTF_ZERO          (1U << 1U) // '0'
+#define CY_RETARGET_IO_PRINTF_PLUS          (1U << 2U) // '+'
+#define CY_RETARGET_IO_PRINTF_SPACE         (1U << 3U) // ' '
+#define CY_RETARGET_IO_PRINTF_ALT           (1U << 4U) // '#'
+#define CY_RETARGET_IO_PRINTF_UPPER         (1U << 5U) // 'X'
+
+// Digits of the largest value in octal, the integer part, point and decimals of %f fit as well
+#define CY_RETARGET_IO_PRINTF_DIGITS        ((((sizeof(cy_retarget_io_printf_uint_t) * 8U) + 2U) \
+                                              / 3U) + CY_RETARGET_IO_PRINTF_MAX_PRECISION + 1U)
+
+// Output of cy_retarget_io_vprintf, collected on the stack
+typedef struct
+{
+    char   buf[CY_RETARGET_IO_PRINTF_BUFFER_SIZE];
+    size_t len;
+    int    count;
+} cy_retarget_io_printf_out_t;
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_printf_flush
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_printf_flush(cy_retarget_io_printf_out_t* out)
+{
+    if (out->len > 0U)
+    {
+        (void)cy_retarget_io_stream_write(CY_RETARGET_IO_STDOUT, out->buf, out->len);
+        out->len = 0U;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_printf_flush_lines
+//
+// Writes the complete lines of the full buffer and keeps the partial line for the next write, so
+// that a line that fits the buffer reaches the transmit path in one write. Without a line
+// terminator the whole buffer is written.
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_printf_flush_lines(cy_retarget_io_printf_out_t* out)
+{
+    size_t end = out->len;
+    while ((end > 0U) && (out->buf[end - 1U] != '\n'))
+    {
+        --end;
+    }
+    if (end == 0U)
+    {
+        cy_retarget_io_printf_flush(out);
+    }
+    else
+    {
+        (void)cy_retarget_io_stream_write(CY_RETARGET_IO_STDOUT, out->buf, end);
+        out->len -= end;
+        (void)memmove(out->buf, &out->buf[end], out->len);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_printf_put
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_printf_put(cy_retarget_io_printf_out_t* out, const char* ptr,
+                                      size_t len)
+{
+    out->count += (int)len;
+    while (len > 0U)
+    {
+        size_t part = CY_RETARGET_IO_PRINTF_BUFFER_SIZE - out->len;
+        if (part > len)
+        {
+            part = len;
+        }
+        (void)memcpy(&out->buf[out->len], ptr, part);
+        out->len += part;
+        ptr      += part;
+        len      -= part;
+        if (out->len == CY_RETARGET_IO_PRINTF_BUFFER_SIZE)
+        {
+            cy_retarget_io_printf_flush_lines(out);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_printf_fill
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_printf_fill(cy_retarget_io_printf_out_t* out, char c, size_t count)
+{
+    for (; count > 0U; --count)
+    {
+        cy_retarget_io_printf_put(out, &c, 1U);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_printf_field
+//
+// Writes a converted value as prefix (sign or 0x), leading zeros and body, padded to the width
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_printf_field(cy_retarget_io_printf_out_t* out, const char* prefix,
+                                        size_t zeros, const char* body, size_t len, size_t width,
+                                        uint32_t flags)
+{
+    size_t prefix_len = strlen(prefix);
+    size_t used       = prefix_len + zeros + len;
+    size_t pad        = (width > used) ? (width - used) : 0U;
+    if ((flags & CY_RETARGET_IO_PRINTF_LEFT) == 0U)
+    {
+        if ((flags & CY_RETARGET_IO_PRINTF_ZERO) != 0U)
+        {
+            zeros += pad;
+        }
+        else
+        {
+            cy_retarget_io_printf_fill(out, ' ', pad);
+        }
+        pad = 0U;
+    }
+    cy_retarget_io_printf_put(out, prefix, prefix_len);
+    cy_retarget_io_printf_fill(out, '0', zeros);
+    cy_retarget_io_printf_put(out, body, len);
+    cy_retarget_io_printf_fill(out, ' ', pad);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_printf_digits
+//
+// Writes the digits of value backwards, ending before end, and returns their number
+//--------------------------------------------------------------------------------------------------
+static size_t cy_retarget_io_printf_digits(char* end, cy_retarget_io_printf_uint_t value,
+                                           uint32_t base, uint32_t flags)
+{
+    const char* digits = ((flags & CY_RETARGET_IO_PRINTF_UPPER) != 0U)
+        ? "0123456789ABCDEF" : "0123456789abcdef";
+    size_t count = 0U;
+    do
+    {
+        ++count;
+        *(end - count) = digits[value % base];
+        value /= base;
+    } while (value != 0U);
+    return count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_printf_sign
+//--------------------------------------------------------------------------------------------------
+static inline const char* cy_retarget_io_printf_sign(bool negative, uint32_t flags)
+{
+    return negative ? "-" : (((flags & CY_RETARGET_IO_PRINTF_PLUS) != 0U) ? "+" :
+                             (((flags & CY_RETARGET_IO_PRINTF_SPACE) != 0U) ? " " : ""));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_printf_int
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_printf_int(cy_retarget_io_printf_out_t* out,
+                                      cy_retarget_io_printf_uint_t value, bool negative,
+                                      uint32_t base, int precision, size_t width, uint32_t flags)
+{
+    char   body[CY_RETARGET_IO_PRINTF_DIGITS];
+    char*  end = &body[sizeof(body)];
+    size_t len = 0U;
+    // A precision of 0 prints no digits for the value 0
+    if ((value != 0U) || (precision != 0))
+    {
+        len = cy_retarget_io_printf_digits(end, value, base, flags);
+    }
+
+    const char* prefix = cy_retarget_io_printf_sign(negative, flags);
+    size_t      zeros  = 0U;
+    if ((flags & CY_RETARGET_IO_PRINTF_ALT) != 0U)
+    {
+        if ((base == 16U) && (value != 0U))
+        {
+            prefix = ((flags & CY_RETARGET_IO_PRINTF_UPPER) != 0U) ? "0X" : "0x";
+        }
+        else if ((base == 8U) && ((len == 0U) || (*(end - len) != '0')))
+        {
+            zeros = 1U;
+        }
+    }
+    if (precision >= 0)
+    {
+        // The 0 flag is ignored when a precision is given
+        if ((size_t)precision > (len + zeros))
+        {
+            zeros = (size_t)precision - len;
+        }
+        flags &= ~CY_RETARGET_IO_PRINTF_ZERO;
+    }
+    cy_retarget_io_printf_field(out, prefix, zeros, end - len, len, width, flags);
+}
+
+
+#if defined(CY_RETARGET_IO_PRINTF_FLOAT)
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_printf_float
+//
+// Prints in fixed point, magnitudes beyond the integer type are printed as inf
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_printf_float(cy_retarget_io_printf_out_t* out, double value,
+                                        int precision, size_t width, uint32_t flags)
+{
+    static const uint32_t pow10[CY_RETARGET_IO_PRINTF_MAX_PRECISION + 1U] =
+    {
+        1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL,
+        1000000000UL
+    };
+    char   body[CY_RETARGET_IO_PRINTF_DIGITS];
+    char*  end      = &body[sizeof(body)];
+    bool   negative = (value < 0.0);
+    if (negative)
+    {
+        value = -value;
+    }
+    if (value != value)
+    {
+        flags &= ~CY_RETARGET_IO_PRINTF_ZERO;
+        cy_retarget_io_printf_field(out, "", 0U, "nan", 3U, width, flags);
+        return;
+    }
+    if (value >= (double)(cy_retarget_io_printf_uint_t)-1)
+    {
+        flags &= ~CY_RETARGET_IO_PRINTF_ZERO;
+        cy_retarget_io_printf_field(out, cy_retarget_io_printf_sign(negative, flags), 0U, "inf",
+                                    3U, width, flags);
+        return;
+    }
+
+    size_t decimals = (precision < 0) ? 6U : (size_t)precision;
+    if (decimals > CY_RETARGET_IO_PRINTF_MAX_PRECISION)
+    {
+        decimals = CY_RETARGET_IO_PRINTF_MAX_PRECISION;
+    }
+    cy_retarget_io_printf_uint_t whole    = (cy_retarget_io_printf_uint_t)value;
+    uint32_t                     fraction =
+        (uint32_t)(((value - (double)whole) * (double)pow10[decimals]) + 0.5);
+    if (fraction >= pow10[decimals])
+    {
+        fraction -= pow10[decimals];
+        ++whole;
+    }
+
+    size_t len = 0U;
+    if (decimals > 0U)
+    {
+        len = cy_retarget_io_printf_digits(end, fraction, 10U, 0U);
+        for (; len < decimals; ++len)
+        {
+            *(end - len - 1U) = '0';
+        }
+    }
+    if ((decimals > 0U) || ((flags & CY_RETARGET_IO_PRINTF_ALT) != 0U))
+    {
+        ++len;
+        *(end - len) = '.';
+    }
+    len += cy_retarget_io_printf_digits(end - len, whole, 10U, 0U);
+    cy_retarget_io_printf_field(out, cy_retarget_io_printf_sign(negative, flags), 0U, end - len,
+                                len, width, flags);
+}
+
+
+#endif // defined(CY_RETARGET_IO_PRINTF_FLOAT)
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_printf_number
+//
+// Reads an int argument of a '*' width or precision, or the decimal number at *fmt
+//--------------------------------------------------------------------------------------------------
+static int cy_retarget_io_printf_number(const char** fmt, va_list* args)
+{
+    int value = 0;
+    if (**fmt == '*')
+    {
+        ++(*fmt);
+        value = va_arg(*args, int);
+    }
+    else
+    {
+        for (; (**fmt >= '0') && (**fmt <= '9'); ++(*fmt))
+        {
+            value = (value * 10) + (**fmt - '0');
+        }
+    }
+    return value;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_vprintf
+//--------------------------------------------------------------------------------------------------
+int cy_retarget_io_vprintf(const char* fmt, va_list args)
+{
+    cy_retarget_io_printf_out_t out;
+    va_list                     ap;
+    out.len   = 0U;
+    out.count = 0;
+    if (fmt == NULL)
+    {
+        return 0;
+    }
+
+    // Copied, so that the helpers can take the list by pointer on every ABI
+    va_copy(ap, args);
+    while (*fmt != '\0')
+    {
+        const char* spec = fmt;
+        while ((*fmt != '\0') && (*fmt != '%'))
+        {
+            ++fmt;
+        }
+        cy_retarget_io_printf_put(&out, spec, (size_t)(fmt - spec));
+        if (*fmt == '\0')
+        {
+            break;
+        }
+        const char* conv = fmt;
+        ++fmt;
+
+        uint32_t flags = 0U;
+        for (;; ++fmt)
+        {
+            if (*fmt == '-')
+            {
+                flags |= CY_RETARGET_IO_PRINTF_LEFT;
+            }
+            else if (*fmt == '0')
+            {
+                flags |= CY_RETARGET_IO_PRINTF_ZERO;
+            }
+            else if (*fmt == '+')
+            {
+                flags |= CY_RETARGET_IO_PRINTF_PLUS;
+            }
+            else if (*fmt == ' ')
+            {
+                flags |= CY_RETARGET_IO_PRINTF_SPACE;
+            }
+            else if (*fmt == '#')
+            {
+                flags |= CY_RETARGET_IO_PRINTF_ALT;
+            }
+            else
+            {
+                break;
+            }
+        }
+        int width = cy_retarget_io_printf_number(&fmt, &ap);
+        if (width < 0)
+        {
+            // A negative '*' width is the '-' flag
+            flags |= CY_RETARGET_IO_PRINTF_LEFT;
+            width  = -width;
+        }
+        int precision = -1;
+        if (*fmt == '.')
+        {
+            ++fmt;
+            precision = cy_retarget_io_printf_number(&fmt, &ap);
+            if (precision < 0)
+            {
+                precision = -1;
+            }
+        }
+        // Number of long and short modifiers, size_t and ptrdiff_t are long or int on all targets
+        uint32_t longs  = 0U;
+        uint32_t shorts = 0U;
+        while ((*fmt == 'h') || (*fmt == 'l') || (*fmt == 'z') || (*fmt == 't'))
+        {
+            if ((*fmt == 'l') ||
+                (((*fmt == 'z') || (*fmt == 't')) && (sizeof(size_t) == sizeof(long))))
+            {
+                ++longs;
+            }
+            else if (*fmt == 'h')
+            {
+                ++shorts;
+            }
+            ++fmt;
+        }
+
+        cy_retarget_io_printf_uint_t value;
+        uint32_t                     base = 10U;
+        switch (*fmt)
+        {
+            case 'd':
+            case 'i':
+            {
+                long long svalue = (longs >= 2U) ? va_arg(ap, long long) :
+                                   ((longs == 1U) ? va_arg(ap, long) : va_arg(ap, int));
+                // The argument was promoted to int, h and hh convert it back
+                if ((longs == 0U) && (shorts > 0U))
+                {
+                    svalue = (shorts >= 2U) ? (signed char)svalue : (short)svalue;
+                }
+                value = (svalue < 0)
+                    ? (cy_retarget_io_printf_uint_t)(0U - (unsigned long long)svalue)
+                    : (cy_retarget_io_printf_uint_t)svalue;
+                cy_retarget_io_printf_int(&out, value, (svalue < 0), 10U, precision,
+                                          (size_t)width, flags);
+                break;
+            }
+
+            case 'X':
+                flags |= CY_RETARGET_IO_PRINTF_UPPER;
+            // fall-through
+
+            case 'x':
+                base = 16U;
+            // fall-through
+
+            case 'o':
+                base = (base == 10U) ? 8U : base;
+            // fall-through
+
+            case 'u':
+                value = (longs >= 2U) ? (cy_retarget_io_printf_uint_t)va_arg(ap, unsigned long long)
+                        : ((longs == 1U) ? va_arg(ap, unsigned long) : va_arg(ap, unsigned int));
+                if ((longs == 0U) && (shorts > 0U))
+                {
+                    value = (shorts >= 2U) ? (unsigned char)value : (unsigned short)value;
+                }
+                cy_retarget_io_printf_int(&out, value, false, base, precision, (size_t)width,
+                                          flags);
+                break;
+
+            case 'p':
+                value = (cy_retarget_io_printf_uint_t)(uintptr_t)va_arg(ap, void*);
+                cy_retarget_io_printf_int(&out, value, false, 16U, precision, (size_t)width,
+                                          flags | CY_RETARGET_IO_PRINTF_ALT);
+                break;
+
+            case 'c':
+            {
+                char c = (char)va_arg(ap, int);
+                cy_retarget_io_printf_field(&out, "", 0U, &c, 1U, (size_t)width,
+                                            flags & CY_RETARGET_IO_PRINTF_LEFT);
+                break;
+            }
+
+            case 's':
+            {
+                const char* str = va_arg(ap, const char*);
+                size_t      len = 0U;
+                if (str == NULL)
+                {
+                    str = "(null)";
+                }
+                while (((precision < 0) || (len < (size_t)precision)) && (str[len] != '\0'))
+                {
+                    ++len;
+                }
+                cy_retarget_io_printf_field(&out, "", 0U, str, len, (size_t)width,
+                                            flags & CY_RETARGET_IO_PRINTF_LEFT);
+                break;
+            }
+
+            case '%':
+                cy_retarget_io_printf_put(&out, "%", 1U);
+                break;
+
+            #if defined(CY_RETARGET_IO_PRINTF_FLOAT)
+            case 'f':
+            case 'F':
+                cy_retarget_io_printf_float(&out, va_arg(ap, double), precision, (size_t)width,
+                                            flags);
+                break;
+            #endif
+
+            default:
+                // Unsupported, the argument of a floating point conversion is still consumed so
+                // that the following ones stay in place
+                if ((*fmt == 'f') || (*fmt == 'F') || (*fmt == 'e') || (*fmt == 'E') ||
+                    (*fmt == 'g') || (*fmt == 'G') || (*fmt == 'a') || (*fmt == 'A'))
+                {
+                    (void)va_arg(ap, double);
+                }
+                if (*fmt != '\0')
+                {
+                    ++fmt;
+                }
+                cy_retarget_io_printf_put(&out, conv, (size_t)(fmt - conv));
+                continue;
+        }
+        ++fmt;
+    }
+    va_end(ap);
+    cy_retarget_io_printf_flush(&out);
+    return out.count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_printf
+//--------------------------------------------------------------------------------------------------
+int cy_retarget_io_printf(const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int count = cy_retarget_io_vprintf(fmt, args);
+    va_end(args);
+    return count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_get_tx_dropped
+//--------------------------------------------------------------------------------------------------
+uint32_t cy_retarget_io_get_tx_dropped(void)
+{
+    return cy_retarget_io_tx_dropped;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_get_rx_overruns
+//--------------------------------------------------------------------------------------------------
+void cy_retarget_io_get_rx_overruns(cy_retarget_io_rx_overruns_t* overruns)
+{
+    if (overruns != NULL)
+    {
+        overruns->ring     = cy_retarget_io_rx_ring_overruns;
+        overruns->hardware = cy_retarget_io_rx_hw_overruns;
+        overruns->frames   = cy_retarget_io_rx_bad_frames;
+    }
+}
+
+
+#if defined(CY_RETARGET_IO_STATS)
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_get_stats
+//--------------------------------------------------------------------------------------------------
+void cy_retarget_io_get_stats(cy_retarget_io_stats_t* stats)
+{
+    if (stats != NULL)
+    {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        *stats = cy_retarget_io_stats;
+        __set_PRIMASK(primask);
+        stats->tx_dropped = cy_retarget_io_tx_dropped;
+        cy_retarget_io_get_rx_overruns(&stats->rx_overruns);
+    }
+}
+
+
+#endif // defined(CY_RETARGET_IO_STATS)
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_panic_flush
+//--------------------------------------------------------------------------------------------------
+void cy_retarget_io_panic_flush(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    cy_retarget_io_in_panic = true;
+
+    XMC_USIC_CH_t* channel = cy_retarget_io_uart_obj.channel;
+    if ((cy_retarget_io_tx_ring.buffer != NULL) || (cy_retarget_io_rx_ring.buffer != NULL))
+    {
+        NVIC_DisableIRQ(cy_retarget_io_get_irqn(channel));
+    }
+
+    #if (UC_FAMILY == XMC4)
+    if (cy_retarget_io_dma_channel >= 0)
+    {
+        // The block in flight is moved by the hardware alone, let it finish so that its bytes
+        // are neither lost nor sent twice
+        uint8_t dma_channel = (uint8_t)cy_retarget_io_dma_channel;
+        while (XMC_DMA_CH_IsEnabled(XMC_DMA0, dma_channel))
+        {
+        }
+        XMC_UART_CH_DisableEvent(channel, XMC_UART_CH_EVENT_TRANSMIT_BUFFER);
+        XMC_DMA_CH_Disable(XMC_DMA0, dma_channel);
+        cy_retarget_io_tx_consume(cy_retarget_io_dma_len);
+        cy_retarget_io_dma_len     = 0U;
+        cy_retarget_io_dma_channel = -1;
+    }
+    #endif // (UC_FAMILY == XMC4)
+
+    if (cy_retarget_io_tx_ring.buffer != NULL)
+    {
+        cy_retarget_io_tx_fifo_space = 0U;
+        // Producers that were interrupted while copying never complete, send what they reserved
+        cy_retarget_io_tx_ring.head = cy_retarget_io_tx_state & CY_RETARGET_IO_TX_RESERVED_Msk;
+
+        const uint8_t* data;
+        size_t len;
+        while ((len = cy_retarget_io_tx_next_segment(&data)) != 0U)
+        {
+            for (size_t i = 0U; i < len; ++i)
+            {
+                (void)cy_retarget_io_putchar((char)data[i]);
+            }
+            cy_retarget_io_tx_consume(len);
+        }
+
+        cy_retarget_io_tx_ring.buffer      = NULL;
+        cy_retarget_io_tx_high_ring.buffer = NULL;
+        cy_retarget_io_tx_running          = false;
+    }
+
+    #if defined(CY_RETARGET_IO_TASK_LINES)
+    // Sent in the polling mode now
+    cy_retarget_io_line_flush_all();
+    #endif
+    while (cy_retarget_io_is_tx_active())
+    {
+    }
+    __set_PRIMASK(primask);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_teardown
+//
+// Disables the interrupts and the DMA and releases the RTOS objects set up by the initialization,
+// without sending pending output. Also undoes a partial initialization that failed.
+//--------------------------------------------------------------------------------------------------
+static void cy_retarget_io_teardown(void)
+{
+    #if (UC_FAMILY == XMC4)
+    if (cy_retarget_io_dma_channel >= 0)
+    {
+        XMC_UART_CH_DisableEvent(cy_retarget_io_uart_obj.channel,
+                                 XMC_UART_CH_EVENT_TRANSMIT_BUFFER);
+        XMC_DMA_CH_Disable(XMC_DMA0, (uint8_t)cy_retarget_io_dma_channel);
+        cy_retarget_io_dma_channel         = -1;
+        cy_retarget_io_dma_len             = 0U;
+        cy_retarget_io_tx_ring.buffer      = NULL;
+        cy_retarget_io_tx_high_ring.buffer = NULL;
+    }
+    #endif // (UC_FAMILY == XMC4)
+
+    if (cy_retarget_io_rx_ring.buffer != NULL)
+    {
+        XMC_USIC_CH_t* channel = cy_retarget_io_uart_obj.channel;
+        if ((channel->RBCTR & USIC_CH_RBCTR_SIZE_Msk) != 0U)
+        {
+            XMC_USIC_CH_RXFIFO_DisableEvent(channel, XMC_USIC_CH_RXFIFO_EVENT_CONF_STANDARD |
+                                            XMC_USIC_CH_RXFIFO_EVENT_CONF_ALTERNATE);
+        }
+        else
+        {
+            XMC_UART_CH_DisableEvent(channel, XMC_UART_CH_EVENT_STANDARD_RECEIVE |
+                                     XMC_UART_CH_EVENT_ALTERNATIVE_RECEIVE);
+        }
+        NVIC_DisableIRQ(cy_retarget_io_get_irqn(channel));
+        cy_retarget_io_rx_ring.buffer = NULL;
+    }
+
+    if (cy_retarget_io_tx_ring.buffer != NULL)
+    {
+        if (cy_retarget_io_tx_fifo_size != 0U)
+        {
+            XMC_USIC_CH_TXFIFO_DisableEvent(cy_retarget_io_uart_obj.channel,
+                                            XMC_USIC_CH_TXFIFO_EVENT_CONF_STANDARD);
+        }
+        else
+        {
+            XMC_UART_CH_DisableEvent(cy_retarget_io_uart_obj.channel,
+                                     XMC_UART_CH_EVENT_TRANSMIT_BUFFER);
+        }
+        NVIC_DisableIRQ(cy_retarget_io_get_irqn(cy_retarget_io_uart_obj.channel));
+        cy_retarget_io_tx_ring.buffer      = NULL;
+        cy_retarget_io_tx_high_ring.buffer = NULL;
+        cy_retarget_io_tx_running          = false;
+    }
+
+    #if defined(CY_RETARGET_IO_RTOS_WAIT)
+    cy_retarget_io_waiter_deinit(&cy_retarget_io_tx_waiter);
+    cy_retarget_io_waiter_deinit(&cy_retarget_io_tx_high_waiter);
+    cy_retarget_io_waiter_deinit(&cy_retarget_io_tx_open_waiter);
+    cy_retarget_io_waiter_deinit(&cy_retarget_io_rx_waiter);
+    #endif
+    for (int fd = CY_RETARGET_IO_STDIN; fd <= CY_RETARGET_IO_STDERR; ++fd)
+    {
+        cy_retarget_io_routes[fd].channel = NULL;
+        cy_retarget_io_route_lock_deinit(&cy_retarget_io_routes[fd]);
+    }
+    cy_retarget_io_capture.buffer = NULL;
+    cy_retarget_io_mutex_deinit();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// cy_retarget_io_deinit
+//--------------------------------------------------------------------------------------------------
+void cy_retarget_io_deinit()
+{
+    // Unless the baud rate is known, wait up to CY_RETARGET_IO_DRAIN_TIMEOUT_US. Since the largest
+    // hardware buffer would be 256 bytes it takes about 500 ms to transmit the 256 bytes at 9600
+    // baud. Thus 1000 ms gives roughly 50% padding to this time.
+    #if defined(CY_RETARGET_IO_TASK_LINES)
+    cy_retarget_io_line_flush_all();
+    #endif
+    cy_rslt_t rslt = cy_retarget_io_flush(cy_retarget_io_drain_timeout_us());
+    CY_ASSERT(rslt == CY_RSLT_SUCCESS);
+    (void)rslt;
+
+    cy_retarget_io_teardown();
 }
 
 
@@ -37,6 +37,7 @@
 
 #pragma once
 
+#include <stdarg.h>
 #include <stdio.h>
 #include "cy_result.h"
 #include "xmc_usic.h"
@@ -54,6 +55,139 @@ typedef struct
 /** UART channel handle used by this library */
 extern cy_retarget_io_uart_t cy_retarget_io_uart_obj;
 
+/** DMA configuration of the transmit path. DMA is only available on XMC™ 4000
+ * devices, on other devices the transmit path falls back to the interrupt mode.
+ */
+typedef struct
+{
+    bool    enable;          /**< Use a GPDMA0 channel to drain the transmit ring buffer */
+    uint8_t channel;         /**< GPDMA0 channel number */
+    uint8_t service_request; /**< USIC service request line (0-5) routed to the DMA line
+                                  router, must differ from \ref CY_RETARGET_IO_SR */
+    uint8_t request;         /**< DMA peripheral request matching service_request, e.g.
+                                  DMA0_PERIPHERAL_REQUEST_USIC0_SR0_0 */
+} cy_retarget_io_dma_cfg_t;
+
+/** What the buffered transmit path does with output that does not fit into the
+ * ring buffer
+ */
+typedef enum
+{
+    CY_RETARGET_IO_OVERFLOW_BLOCK,       /**< Wait until enough space is freed, interrupts
+                                              drop the part that does not fit instead */
+    CY_RETARGET_IO_OVERFLOW_DROP_NEWEST, /**< Drop the part of the write that does not fit */
+    CY_RETARGET_IO_OVERFLOW_DROP_OLDEST, /**< Drop the oldest unsent lines and binary records
+                                              as a whole to make space, or the new data if the
+                                              old data is already being sent or no record
+                                              boundary frees enough space */
+    CY_RETARGET_IO_OVERFLOW_TRUNCATE     /**< Write as much as fits, drop the rest */
+} cy_retarget_io_overflow_policy_t;
+
+/** Buffering of the standard streams set up by \ref cy_retarget_io_init_cfg */
+typedef enum
+{
+    CY_RETARGET_IO_STDIO_DEFAULT, /**< Leave the buffering of the C library unchanged */
+    CY_RETARGET_IO_STDIO_LINE,    /**< stdout is line buffered, written at every LF */
+    CY_RETARGET_IO_STDIO_FULL     /**< stdout is written when its buffer is full or on fflush() */
+} cy_retarget_io_stdio_buffering_t;
+
+/** Receive overrun counters of the buffered receive mode */
+typedef struct
+{
+    uint32_t ring;     /**< Bytes dropped because the receive ring buffer was full */
+    uint32_t hardware; /**< Bytes lost in the USIC receive buffer before the interrupt read them */
+    uint32_t frames;   /**< Frames dropped by \ref cy_retarget_io_read_frame */
+} cy_retarget_io_rx_overruns_t;
+
+#if !defined(CY_RETARGET_IO_STATS_LATENCY_BINS)
+/** Number of bins of cy_retarget_io_stats_t::write_latency */
+#define CY_RETARGET_IO_STATS_LATENCY_BINS   (24U)
+#endif
+
+/** Usage statistics of the library collected with \ref CY_RETARGET_IO_STATS. The
+ * times are in core clock cycles, measured with the DWT cycle counter on
+ * XMC™ 4000 and with SysTick on XMC™ 1000, where a single wait longer than the
+ * SysTick period is not measured correctly.
+ */
+typedef struct
+{
+    uint32_t bytes_written;           /**< Bytes accepted by the output functions */
+    uint32_t bytes_read;              /**< Bytes returned by the input functions */
+    uint32_t write_calls;             /**< Calls of _write(), __write(), _sys_write() or
+                                           fputc() */
+    uint64_t write_cycles;            /**< Time spent in these calls, divided by bytes_written
+                                           it gives the cost per byte */
+    /** Histogram of the time spent in each of these calls, for latency percentiles. Bin n
+     * counts the calls that took 2^(n-1) to 2^n - 1 cycles, the last bin also longer ones. */
+    uint32_t write_latency[CY_RETARGET_IO_STATS_LATENCY_BINS];
+    uint64_t tx_blocked_cycles;       /**< Time spent waiting for the UART in the polling mode
+                                           or for ring buffer space in the buffered mode */
+    uint64_t rx_blocked_cycles;       /**< Time spent waiting for received data */
+    uint64_t mutex_wait_cycles;       /**< Time spent waiting for the library mutex */
+    uint32_t tx_high_water;           /**< Most bytes held in the transmit ring buffer */
+    uint32_t tx_high_lane_high_water; /**< Most bytes held in the high priority lane */
+    uint32_t rx_high_water;           /**< Most bytes held in the receive ring buffer */
+    uint32_t tx_dropped;              /**< See \ref cy_retarget_io_get_tx_dropped */
+    uint32_t tx_compress_in;          /**< Bytes encoded by \ref CY_RETARGET_IO_COMPRESS */
+    uint32_t tx_compress_out;         /**< Bytes of the frames they were encoded into */
+    cy_retarget_io_rx_overruns_t rx_overruns; /**< See \ref cy_retarget_io_get_rx_overruns */
+} cy_retarget_io_stats_t;
+
+/** Configuration of the library, used by \ref cy_retarget_io_init_cfg */
+typedef struct
+{
+    XMC_USIC_CH_t*           channel;        /**< Pointer to USIC channel handler */
+    uint8_t*                 tx_buffer;      /**< Transmit ring buffer, NULL selects the polling
+                                                  mode */
+    size_t                   tx_buffer_size; /**< Size of tx_buffer in bytes (at least 4, 13
+                                                  with \ref CY_RETARGET_IO_LINE_STAMP, less
+                                                  than 4 MiB) */
+    uint8_t*                 rx_buffer;      /**< Receive ring buffer filled by the interrupt,
+                                                  NULL selects the polling mode */
+    size_t                   rx_buffer_size; /**< Size of rx_buffer in bytes (at least 2) */
+    cy_retarget_io_dma_cfg_t dma;            /**< DMA configuration of the transmit path */
+    cy_retarget_io_overflow_policy_t overflow_policy; /**< Handling of output that does not fit
+                                                           into tx_buffer */
+    uint8_t*                 tx_high_buffer; /**< High priority transmit lane used by stderr, sent
+                                                  before tx_buffer at the next line or record
+                                                  boundary.
+                                                  Requires tx_buffer, NULL disables the lane */
+    size_t                   tx_high_buffer_size; /**< Size of tx_high_buffer in bytes
+                                                       (at least 4, 13 with
+                                                       \ref CY_RETARGET_IO_LINE_STAMP) */
+    cy_retarget_io_stdio_buffering_t stdio_buffering; /**< Buffering of stdout. Unless it is
+                                                           the default, stderr is unbuffered,
+                                                           and so is stdin with rx_buffer */
+    char*                    stdout_buffer;  /**< Buffer of stdout used by the C library, sized
+                                                  to the longest line. Required unless
+                                                  stdio_buffering is the default */
+    size_t                   stdout_buffer_size; /**< Size of stdout_buffer in bytes */
+    uint8_t*                 capture_buffer; /**< Trace capture log that takes the output of the
+                                                  main channel instead of the UART, see
+                                                  \ref cy_retarget_io_dump. NULL disables the
+                                                  capture mode */
+    size_t                   capture_buffer_size; /**< Size of capture_buffer in bytes (at least
+                                                       4, 13 with
+                                                       \ref CY_RETARGET_IO_LINE_STAMP) */
+} cy_retarget_io_config_t;
+
+/** Trace capture log. The captured output runs from buffer[tail] up to
+ * buffer[head - 1], wrapping around at the end of the buffer. One byte is
+ * always kept free, the oldest output is overwritten when the log is full.
+ */
+typedef struct
+{
+    uint8_t*        buffer; /**< Capture buffer, NULL while the capture mode is off */
+    size_t          size;   /**< Size of buffer in bytes */
+    volatile size_t head;   /**< Index following the newest byte */
+    volatile size_t tail;   /**< Index of the oldest byte, equal to head if the log is empty */
+} cy_retarget_io_capture_t;
+
+/** Trace capture log used by this library, exported under this name for
+ * debuggers
+ */
+extern cy_retarget_io_capture_t cy_retarget_io_capture;
+
 #ifdef DOXYGEN
 
 /** Defining this macro enables conversion of line feed (LF) into carriage
@@ -63,8 +197,276 @@ extern cy_retarget_io_uart_t cy_retarget_io_uart_obj;
  */
 #define CY_RETARGET_IO_CONVERT_LF_TO_CRLF
 
+/** Defining this macro makes the standard input functions deliver the line
+ * terminators CR, LF and CR & LF alike as a single LF, see
+ * \ref CY_RETARGET_IO_READ_CRLF_TO_LF.
+ */
+#define CY_RETARGET_IO_CONVERT_CRLF_TO_LF
+
+/** Defining this macro makes the library insert a header with the timestamp of
+ * \ref cy_retarget_io_get_timestamp at the start of every line written to
+ * stdout and stderr. The timestamp is taken when the write that starts the
+ * line is called, not formatted with printf(). Defined without a value or to
+ * \ref CY_RETARGET_IO_LINE_STAMP_HEX, the header is the timestamp as 8 hex
+ * digits followed by a space. Defined to \ref CY_RETARGET_IO_LINE_STAMP_BINARY,
+ * it is \ref CY_RETARGET_IO_LINE_STAMP_MARKER followed by the timestamp as 4
+ * bytes little endian. Binary data, like \ref CY_RETARGET_IO_LOG records, is
+ * not stamped.
+ */
+#define CY_RETARGET_IO_LINE_STAMP
+
+/** Defining this macro to a number of buffers makes the library collect the
+ * output of each task to stdout in a line buffer of
+ * \ref CY_RETARGET_IO_LINE_BUFFER_SIZE bytes taken from a pool of this many
+ * buffers. Only available with CY_RTOS_AWARE. The transmit path sees one write
+ * per line, so the partial prints of different tasks do not interleave and
+ * each line takes the lock or ring buffer reservation once. A partial line is
+ * sent when it is completed, when the buffer is full, before the task reads
+ * stdin and by \ref cy_retarget_io_flush. Interrupts and tasks that find the
+ * pool exhausted write directly. A task that is deleted while it holds a
+ * partial line keeps its buffer until \ref cy_retarget_io_line_release is
+ * called for it.
+ */
+#define CY_RETARGET_IO_LINE_BUFFERS
+
+/** Defining this macro makes the library collect the usage statistics returned
+ * by \ref cy_retarget_io_get_stats. It costs a few cycles per call and starts
+ * the DWT cycle counter, or SysTick if it is not running.
+ */
+#define CY_RETARGET_IO_STATS
+
+/** Defining this macro makes \ref cy_retarget_io_printf support the %f
+ * conversion, printed in fixed point with at most
+ * \ref CY_RETARGET_IO_PRINTF_MAX_PRECISION decimals and rounded half away from
+ * zero. Values beyond the range of the integer type are printed as inf.
+ */
+#define CY_RETARGET_IO_PRINTF_FLOAT
+
+/** Defining this macro makes \ref cy_retarget_io_printf format the ll length
+ * modifier with 64 bits. Otherwise these arguments are truncated to 32 bits,
+ * which avoids the 64-bit division code.
+ */
+#define CY_RETARGET_IO_PRINTF_LONG_LONG
+
+/** Defining this macro makes the buffered transmit mode compress its output for
+ * slow links. The transmit interrupt, or the DMA completion on XMC™ 4000, takes
+ * the data waiting in the ring buffers and encodes it into a frame whenever the
+ * previous one has been sent, so frames grow while the link is busy and short
+ * lines are not delayed while it is idle. The encoder needs no heap: it keeps
+ * the last \ref CY_RETARGET_IO_COMPRESS_WINDOW bytes in a static window. The
+ * frame format, which a host tool decompresses, is described at
+ * \ref CY_RETARGET_IO_COMPRESS_MARKER. Output of the polling mode, including
+ * the output after \ref cy_retarget_io_panic_flush, is not compressed.
+ */
+#define CY_RETARGET_IO_COMPRESS
+
+/** While a task or the main loop waits for space in the transmit ring buffers,
+ * the core sleeps with WFI until the next interrupt instead of polling.
+ * Defining this macro disables this, e.g. if the sleep mode of the device stops
+ * a clock the application needs. \ref cy_retarget_io_flush always polls, so
+ * that its timeout is kept even if the line stalls.
+ */
+#define CY_RETARGET_IO_NO_SLEEP
+
+/** Defining this macro overrides the NVIC interrupt number used by the buffered
+ * mode. By default it is derived from the USIC module of the channel and
+ * \ref CY_RETARGET_IO_SR.
+ */
+#define CY_RETARGET_IO_IRQN
+
 #endif // DOXYGEN
 
+#if !defined(CY_RETARGET_IO_SR)
+/** USIC service request line (0-5) used by the buffered mode to signal the
+ * interrupt that drains the transmit ring buffer. The application must call
+ * \ref cy_retarget_io_irq_handler from the handler of the matching interrupt.
+ */
+#define CY_RETARGET_IO_SR                   (0U)
+#endif
+
+#if !defined(CY_RETARGET_IO_IRQ_PRIORITY)
+/** NVIC priority of the buffered mode interrupt. Defaults to the lowest
+ * priority available on the device.
+ */
+#define CY_RETARGET_IO_IRQ_PRIORITY         ((1UL << __NVIC_PRIO_BITS) - 1UL)
+#endif
+
+#if !defined(CY_RETARGET_IO_LOG_MAX_ARGS)
+/** Maximum number of arguments of a \ref CY_RETARGET_IO_LOG record */
+#define CY_RETARGET_IO_LOG_MAX_ARGS         (8U)
+#endif
+
+#if !defined(CY_RETARGET_IO_LINE_BUFFER_SIZE)
+/** Size of each buffer of \ref CY_RETARGET_IO_LINE_BUFFERS, longer lines are sent in parts */
+#define CY_RETARGET_IO_LINE_BUFFER_SIZE     (128U)
+#endif
+
+#if !defined(CY_RETARGET_IO_COMPRESS_WINDOW)
+/** Size of the \ref CY_RETARGET_IO_COMPRESS window in bytes, a power of two
+ * from 512 to 4096. The decoder needs a window of the same size.
+ */
+#define CY_RETARGET_IO_COMPRESS_WINDOW      (1024U)
+#endif
+
+#if !defined(CY_RETARGET_IO_COMPRESS_SYNC_FRAMES)
+/** Number of \ref CY_RETARGET_IO_COMPRESS frames after which the window is
+ * cleared, 1 to 255. A decoder that lost data resumes at the next frame that
+ * clears it; fewer frames resume sooner but compress less.
+ */
+#define CY_RETARGET_IO_COMPRESS_SYNC_FRAMES (16U)
+#endif
+
+#if !defined(CY_RETARGET_IO_PRINTF_BUFFER_SIZE)
+/** Size of the stack buffer in which \ref cy_retarget_io_printf collects
+ * output before it is written. Longer output is written in several parts, split
+ * after the last complete line in the buffer, so only a line longer than the
+ * buffer is written in parts.
+ */
+#define CY_RETARGET_IO_PRINTF_BUFFER_SIZE   (64U)
+#endif
+
+#if !defined(CY_RETARGET_IO_CAPTURE_CHUNK)
+/** Most bytes of text the trace capture mode appends to its log with
+ * interrupts masked, at least 16. It bounds the interrupt latency added by a
+ * write; output captured by an interrupt may come between the chunks of a
+ * longer write.
+ */
+#define CY_RETARGET_IO_CAPTURE_CHUNK        (64U)
+#endif
+
+/** Most decimals printed by the %f conversion of \ref cy_retarget_io_printf */
+#define CY_RETARGET_IO_PRINTF_MAX_PRECISION (9U)
+
+/** First byte of a \ref CY_RETARGET_IO_LOG record, never part of ASCII or UTF-8 text */
+#define CY_RETARGET_IO_LOG_MARKER           (0xFFU)
+
+/** Size of the \ref CY_RETARGET_IO_LOG record header: marker, argument count,
+ * format string address and timestamp
+ */
+#define CY_RETARGET_IO_LOG_HEADER_SIZE      (10U)
+
+/** \cond INTERNAL */
+#if defined(__ICCARM__)
+#define CY_RETARGET_IO_LOG_FMT_ATTR         _Pragma("location=\".cy_retarget_io_fmt\"") __root
+#else
+#define CY_RETARGET_IO_LOG_FMT_ATTR         __attribute__((section(".cy_retarget_io_fmt"), used))
+#endif
+#if defined(__ICCARM__)
+#define CY_RETARGET_IO_PRINTF_ATTR
+#else
+#define CY_RETARGET_IO_PRINTF_ATTR          __attribute__((format(printf, 1, 2)))
+#endif
+#define CY_RETARGET_IO_LOG_IMPL(fmt, ...)                                                \
+    do                                                                                   \
+    {                                                                                    \
+        CY_RETARGET_IO_LOG_FMT_ATTR static const char cy_retarget_io_log_fmt[] = fmt;    \
+        const uint32_t cy_retarget_io_log_args[] = { 0U, __VA_ARGS__ };                  \
+        cy_retarget_io_log_write(cy_retarget_io_log_fmt, &cy_retarget_io_log_args[1],   \
+                                 (sizeof(cy_retarget_io_log_args) / sizeof(uint32_t)) - 1U); \
+    } while (0)
+/** \endcond */
+
+/** Writes a deferred log record instead of formatting the message on the
+ * device.
+ *
+ * The format string is not sent: it is placed in the .cy_retarget_io_fmt
+ * section and identified by its address. The record is written binary through
+ * the same path as printf():
+ *
+ * | Offset | Size      | Content                                    |
+ * |--------|-----------|--------------------------------------------|
+ * | 0      | 1         | \ref CY_RETARGET_IO_LOG_MARKER             |
+ * | 1      | 1         | Number of arguments n                      |
+ * | 2      | 4         | Address of the format string               |
+ * | 6      | 4         | \ref cy_retarget_io_get_timestamp          |
+ * | 10     | 4 * n     | Arguments                                  |
+ *
+ * All values are little endian. A host tool, like tools/retarget_decode.py,
+ * looks up the format string in the .cy_retarget_io_fmt section of the
+ * application ELF file and formats the arguments. Arguments are converted to uint32_t, so only integer types up to
+ * 32 bits are supported; pointers must be cast. At most
+ * \ref CY_RETARGET_IO_LOG_MAX_ARGS arguments are sent.
+ */
+#define CY_RETARGET_IO_LOG(...)             CY_RETARGET_IO_LOG_IMPL(__VA_ARGS__, )
+
+/** \ref CY_RETARGET_IO_LINE_STAMP value for a header of 8 hex digits and a space */
+#define CY_RETARGET_IO_LINE_STAMP_HEX       (1)
+/** \ref CY_RETARGET_IO_LINE_STAMP value for a binary header */
+#define CY_RETARGET_IO_LINE_STAMP_BINARY    (2)
+
+/** First byte of a binary \ref CY_RETARGET_IO_LINE_STAMP header, never part of ASCII or UTF-8
+ * text
+ */
+#define CY_RETARGET_IO_LINE_STAMP_MARKER    (0xFEU)
+
+/** \cond INTERNAL */
+#if defined(CY_RETARGET_IO_LINE_STAMP) && \
+    ((CY_RETARGET_IO_LINE_STAMP + 0) == CY_RETARGET_IO_LINE_STAMP_BINARY)
+#define CY_RETARGET_IO_LINE_STAMP_SIZE      (5U)
+#else
+#define CY_RETARGET_IO_LINE_STAMP_SIZE      (9U)
+#endif
+/** \endcond */
+
+/** First byte of a \ref CY_RETARGET_IO_COMPRESS frame, never part of ASCII or
+ * UTF-8 text:
+ *
+ * | Offset | Size | Content                                                     |
+ * |--------|------|-------------------------------------------------------------|
+ * | 0      | 1    | \ref CY_RETARGET_IO_COMPRESS_MARKER                         |
+ * | 1      | 1    | Bit 7: the window is cleared before this frame. Bits 6-0:   |
+ * |        |      | sequence number, incremented by one per frame               |
+ * | 2      | 1    | Length n of the payload                                     |
+ * | 3      | n    | Payload                                                     |
+ * | 3 + n  | 1    | Sum of bytes 1 to 2 + n, modulo 256                         |
+ * | 4 + n  | 1    | Sum of the running sums of bytes 1 to 2 + n, modulo 256     |
+ *
+ * The payload is a sequence of tokens. A byte c below 0x80 is followed by
+ * c + 1 literal bytes. A byte c from 0x80 is followed by a byte d and copies
+ * ((c >> 4) & 7) + 3 bytes from ((c & 0x0F) << 8) + d + 1 bytes back in the
+ * decoded output; if (c >> 4) & 7 is 7, a third byte is added to the length.
+ * The bytes are copied one by one, so a copy may repeat the bytes it produces.
+ * The decoded output is the data written in the buffered mode, bytes between
+ * frames are sent uncompressed. A decoder that finds a bad sum or a gap in the
+ * sequence numbers drops frames until the next one that clears the window.
+ */
+#define CY_RETARGET_IO_COMPRESS_MARKER      (0xFDU)
+
+/** File descriptor of the standard input stream, see \ref cy_retarget_io_set_route */
+#define CY_RETARGET_IO_STDIN                (0)
+/** File descriptor of the standard output stream, see \ref cy_retarget_io_set_route */
+#define CY_RETARGET_IO_STDOUT               (1)
+/** File descriptor of the standard error stream, see \ref cy_retarget_io_set_route */
+#define CY_RETARGET_IO_STDERR               (2)
+
+/** \ref cy_retarget_io_read returns the data available once the first data
+ * has arrived, without looking at line terminators
+ */
+#define CY_RETARGET_IO_READ_RAW             (0x00U)
+/** \ref cy_retarget_io_read waits for a complete line and returns after its
+ * terminator, CR or LF
+ */
+#define CY_RETARGET_IO_READ_LINE            (0x01U)
+/** \ref cy_retarget_io_read delivers the line terminators CR, LF and CR & LF
+ * alike as a single LF, the counterpart of \ref CY_RETARGET_IO_CONVERT_LF_TO_CRLF
+ */
+#define CY_RETARGET_IO_READ_CRLF_TO_LF      (0x02U)
+/** Timeout of \ref cy_retarget_io_read that never expires */
+#define CY_RETARGET_IO_WAIT_FOREVER         (0xFFFFFFFFUL)
+
+/** An invalid parameter value was passed to a function */
+#define CY_RETARGET_IO_RSLT_BAD_PARAM \
+    (CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_BOARD_LIB_RETARGET_IO, 0))
+/** The requested mode is not supported by the current USIC channel configuration */
+#define CY_RETARGET_IO_RSLT_UNSUPPORTED \
+    (CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_BOARD_LIB_RETARGET_IO, 1))
+/** The operation did not finish within the given time */
+#define CY_RETARGET_IO_RSLT_TIMEOUT \
+    (CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_BOARD_LIB_RETARGET_IO, 2))
+/** The data did not fit into the transmit ring buffer and was dropped */
+#define CY_RETARGET_IO_RSLT_DROPPED \
+    (CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_BOARD_LIB_RETARGET_IO, 3))
+
 /**
  * \brief Initialization function for redirecting low level IO commands to allow
  * sending messages over a UART interface.
@@ -82,12 +484,357 @@ extern cy_retarget_io_uart_t cy_retarget_io_uart_obj;
  */
 cy_rslt_t cy_retarget_io_init(XMC_USIC_CH_t* channel);
 
+/**
+ * \brief Initialization function for redirecting low level IO commands to a
+ * UART interface with an interrupt-driven transmit path.
+ *
+ * Output written through printf and related functions is copied into the
+ * provided ring buffer and the calling code returns immediately. The USIC
+ * transmit buffer interrupt drains the ring buffer in the background. When the
+ * ring buffer is full, the caller waits until enough space is freed. Callers
+ * in interrupt context never wait, they drop what does not fit.
+ *
+ * The buffered mode is lock-free: any number of tasks and interrupts can write
+ * concurrently without taking the library mutex. Each write reserves its own
+ * contiguous area of the ring buffer, so its output is never interleaved with
+ * other writers, unless it is longer than half the ring buffer.
+ *
+ * \note The interrupt is routed to the service request line
+ * \ref CY_RETARGET_IO_SR and enabled in the NVIC by this function. The
+ * application must call \ref cy_retarget_io_irq_handler from the matching
+ * interrupt handler (e.g. USIC0_0_IRQHandler).
+ *
+ * \param channel Pointer to USIC channel handler
+ * \param buffer  Transmit ring buffer, must remain valid until
+ *                \ref cy_retarget_io_deinit is called
+ * \param size    Size of the ring buffer in bytes (at least 4, 13 with
+ *                \ref CY_RETARGET_IO_LINE_STAMP)
+ * \returns CY_RSLT_SUCCESS if successfully initialized, else an error about
+ * what went wrong
+ */
+cy_rslt_t cy_retarget_io_init_buffered(XMC_USIC_CH_t* channel, uint8_t* buffer, size_t size);
+
+/**
+ * \brief Initialization function taking the full library configuration.
+ *
+ * With a transmit buffer, this behaves like \ref cy_retarget_io_init_buffered.
+ * With a receive buffer, the interrupt on \ref CY_RETARGET_IO_SR moves every
+ * received byte into the ring buffer, and reads from stdin are served from it.
+ * If the USIC receive FIFO is configured, its limit is set to 0 so that the
+ * interrupt fires for the first byte of every burst.
+ * If DMA is enabled in the configuration on an XMC™ 4000 device, contiguous
+ * segments of the ring buffer are handed to a GPDMA0 channel, and the next
+ * segment is chained from the DMA transfer complete event. The application must
+ * forward the GPDMA0 interrupt with XMC_DMA_IRQHandler(XMC_DMA0), the library
+ * enables GPDMA0_0_IRQn in the NVIC. DMA requires the transmit FIFO to be
+ * disabled.
+ *
+ * \param config Library configuration
+ * \returns CY_RSLT_SUCCESS if successfully initialized, else an error about
+ * what went wrong. On an error nothing stays enabled or allocated, as after
+ * \ref cy_retarget_io_deinit, and the call can be retried.
+ */
+cy_rslt_t cy_retarget_io_init_cfg(const cy_retarget_io_config_t* config);
+
+/**
+ * \brief Routes a standard stream to its own USIC channel.
+ *
+ * By default all streams use the channel passed to \ref cy_retarget_io_init. A
+ * routed stream uses the given channel in the polling mode, with its own lock,
+ * so it never waits for output queued on the other channels. For example,
+ * stdout can be initialized in the buffered mode on a fast channel for
+ * telemetry while stderr stays on the debug UART. The channel must already be
+ * configured for UART operation by the BSP. The numbering matches the newlib
+ * file descriptors, the IAR handles and the ARM FILEHANDLEs returned by
+ * _sys_open.
+ * \param fd      \ref CY_RETARGET_IO_STDIN, \ref CY_RETARGET_IO_STDOUT or
+ *                \ref CY_RETARGET_IO_STDERR
+ * \param channel USIC channel, NULL to use the main channel again
+ * \returns CY_RSLT_SUCCESS if successful, else an error about what went wrong
+ */
+cy_rslt_t cy_retarget_io_set_route(int fd, XMC_USIC_CH_t* channel);
+
+/**
+ * \brief Changes the baud rate of the main channel, e.g. to send a memory dump
+ * at a few Mbaud.
+ *
+ * Waits until all pending output has been sent at the old rate, then
+ * reprograms the USIC channel with the oversampling configured by the BSP.
+ * Meanwhile, tasks writing to the buffered transmit path wait and interrupts
+ * drop their output, so no character is sent while the rate changes. The
+ * library mutex is not held while the output drains. With an RTOS, a call made
+ * while a region of \ref cy_retarget_io_reserve is open in another task or an
+ * interrupt, or while another task changes the rate, waits until the ring
+ * buffer is free again. Routed streams keep their channel settings. The timeout
+ * of \ref cy_retarget_io_deinit is derived from the new rate.
+ * \param baudrate Baud rate in bit/s
+ * \returns CY_RSLT_SUCCESS if successful, \ref CY_RETARGET_IO_RSLT_TIMEOUT if the
+ * pending output could not be sent, \ref CY_RETARGET_IO_RSLT_UNSUPPORTED if the
+ * rate cannot be set or a region of \ref cy_retarget_io_reserve is open that the
+ * call cannot wait for
+ */
+cy_rslt_t cy_retarget_io_set_baudrate(uint32_t baudrate);
+
+/**
+ * \brief Interrupt handler of the buffered mode. Moves pending data from the
+ * software ring buffer to the USIC channel.
+ *
+ * Must be called from the interrupt handler assigned to \ref CY_RETARGET_IO_SR.
+ */
+void cy_retarget_io_irq_handler(void);
+
 /**
  * \brief Checks whether the data is currently written to the serial console.
+ *
+ * Covers the transmit ring buffers of the buffered mode, a DMA transfer in
+ * progress, the transmit FIFO and the frame in the shift register, so a power
+ * manager can use it to delay deep sleep entry until all output has been sent.
+ * Partial lines held by \ref CY_RETARGET_IO_LINE_BUFFERS are not covered.
  * \returns true if there are pending TX transactions, otherwise false
  */
 bool cy_retarget_io_is_tx_active();
 
+/**
+ * \brief Waits until all output has been sent: the transmit ring buffers of the
+ * buffered mode, a DMA transfer in progress, the transmit FIFO and the frame in
+ * the shift register.
+ *
+ * The time is measured with the DWT cycle counter on Cortex-M4 and with SysTick
+ * on Cortex-M0, which is started for the duration of the call if the
+ * application does not use it. In the buffered mode, a task blocks on a
+ * semaphore with CY_RTOS_AWARE, and without an RTOS the core sleeps with
+ * WFI while SysTick interrupts are enabled to end the sleep. With interrupts
+ * masked, the buffered mode is drained by the caller. With \ref CY_RETARGET_IO_LINE_BUFFERS, the partial line
+ * of the calling task is sent first.
+ * \param timeout_us Maximum time to wait in microseconds, 0 to only check
+ * \returns CY_RSLT_SUCCESS if all output has been sent,
+ * \ref CY_RETARGET_IO_RSLT_TIMEOUT otherwise
+ */
+cy_rslt_t cy_retarget_io_flush(uint32_t timeout_us);
+
+/**
+ * \brief Sends the partial line a task holds in a buffer of
+ * \ref CY_RETARGET_IO_LINE_BUFFERS and returns the buffer to the pool.
+ *
+ * Call it before a task is deleted, from the task itself or from the task that
+ * deletes it. Otherwise the buffer stays owned by the deleted task, the pool
+ * shrinks by one, and a task created later with the same handle continues its
+ * partial line. Must not be called while the task is still writing to stdout.
+ * Does nothing without \ref CY_RETARGET_IO_LINE_BUFFERS.
+ * \param thread Handle (cy_thread_t) of the task, NULL for the calling task
+ */
+void cy_retarget_io_line_release(void* thread);
+
+/**
+ * \brief Writes data to the buffered transmit path without ever waiting.
+ *
+ * Can be called from interrupts and tasks alike. Data that does not fit into
+ * the ring buffer is handled as configured by
+ * cy_retarget_io_config_t::overflow_policy, where
+ * \ref CY_RETARGET_IO_OVERFLOW_BLOCK is treated as
+ * \ref CY_RETARGET_IO_OVERFLOW_DROP_NEWEST. LF to CR & LF conversion is applied
+ * if enabled.
+ * \param data Data to write
+ * \param len  Number of bytes to write
+ * \returns Number of bytes accepted, 0 if the buffered transmit mode is not used
+ */
+size_t cy_retarget_io_write_nb(const void* data, size_t len);
+
+/**
+ * \brief Reads received data from standard input, from the receive ring buffer
+ * in the buffered receive mode, from the USIC channel otherwise.
+ *
+ * Waits until data is available, then copies everything received so far in
+ * one pass. With \ref CY_RETARGET_IO_READ_LINE, it keeps waiting until a line
+ * terminator has been read or buf is full. The timeout applies to the whole
+ * call, so an incomplete line is returned once it expires.
+ * \param buf        Buffer receiving the data
+ * \param len        Size of buf in bytes
+ * \param timeout_ms Maximum time to wait in milliseconds, 0 to only take what
+ *                   is available or \ref CY_RETARGET_IO_WAIT_FOREVER
+ * \param flags      \ref CY_RETARGET_IO_READ_RAW or \ref CY_RETARGET_IO_READ_LINE,
+ *                   optionally combined with \ref CY_RETARGET_IO_READ_CRLF_TO_LF
+ * \returns Number of bytes read, 0 if nothing arrived in time
+ */
+size_t cy_retarget_io_read(void* buf, size_t len, uint32_t timeout_ms, uint32_t flags);
+
+/**
+ * \brief Writes a binary packet as a frame that a host parser can find again
+ * after corrupted or lost bytes.
+ *
+ * The payload is followed by its CRC-16/CCITT-FALSE (polynomial 0x1021,
+ * initial value 0xFFFF), low byte first, and both are COBS encoded, so the
+ * frame contains no zero byte. A zero byte is sent before and after it. The
+ * encoding and the CRC are done in one pass while the payload is copied into
+ * the transmit ring buffer, or sent by polling in the polling mode. The frame
+ * is never interleaved with other output. Zero bytes in the surrounding text
+ * output, or several of them in a row, delimit empty frames that a parser
+ * skips.
+ *
+ * In the buffered mode the frame is reserved in the ring buffer at its largest
+ * encoded size, the unused rest is sent as zero bytes. If it does not fit, it
+ * is waited for or dropped as a whole according to
+ * cy_retarget_io_config_t::overflow_policy; dropped bytes are counted by
+ * \ref cy_retarget_io_get_tx_dropped. No line conversion or stamp is applied.
+ * \param data Payload
+ * \param len  Size of the payload in bytes. In the buffered mode, at most
+ *             about tx_buffer_size - 6 - tx_buffer_size / 254
+ * \returns CY_RSLT_SUCCESS if the frame was written,
+ * \ref CY_RETARGET_IO_RSLT_DROPPED if it did not fit,
+ * \ref CY_RETARGET_IO_RSLT_BAD_PARAM if it can never fit into the ring buffer
+ */
+cy_rslt_t cy_retarget_io_write_frame(const void* data, size_t len);
+
+/**
+ * \brief Reads the next frame written by the host in the format of
+ * \ref cy_retarget_io_write_frame from the receive ring buffer.
+ *
+ * Waits until a delimiter has been received, then decodes the frame in place
+ * from the ring buffer into buf. Frames with a bad encoding or CRC, frames
+ * larger than buf and frames that do not fit into the ring buffer are dropped
+ * and counted in cy_retarget_io_rx_overruns_t::frames, and the next frame is
+ * waited for; empty frames are skipped. Other data between delimiters, like
+ * text typed into a terminal, is dropped the same way. Only available in the
+ * buffered receive mode, whose ring buffer must hold a complete encoded frame.
+ * \param buf        Buffer receiving the payload
+ * \param size       Size of buf in bytes
+ * \param len        Receives the size of the payload
+ * \param timeout_ms Maximum time to wait in milliseconds, 0 to only check or
+ *                   \ref CY_RETARGET_IO_WAIT_FOREVER
+ * \returns CY_RSLT_SUCCESS if a frame was read,
+ * \ref CY_RETARGET_IO_RSLT_TIMEOUT if none arrived in time,
+ * \ref CY_RETARGET_IO_RSLT_UNSUPPORTED without the buffered receive mode
+ */
+cy_rslt_t cy_retarget_io_read_frame(void* buf, size_t size, size_t* len, uint32_t timeout_ms);
+
+/**
+ * \brief Hands out a contiguous region of the transmit ring buffer to format
+ * output into directly, e.g. with snprintf(), saving the copy done by
+ * _write().
+ *
+ * The region must be passed to \ref cy_retarget_io_commit before any other
+ * output function is called. Until then, other tasks writing to the buffered
+ * transmit path wait for the commit, and interrupts and the calling task drop
+ * their output. With
+ * \ref CY_RETARGET_IO_OVERFLOW_BLOCK, the call waits for space unless it is
+ * made from an interrupt. With \ref CY_RETARGET_IO_CONVERT_LF_TO_CRLF, the
+ * CRs are inserted on commit into the space of the region that was not used
+ * and of the ring buffer after it, so max should leave some headroom.
+ * \param max Maximum number of bytes needed
+ * \param ptr Receives the start of the region
+ * \returns Length of the region, at most max. 0 if the buffered transmit mode
+ * is not used, not enough space is free or another region is not committed
+ * yet.
+ */
+size_t cy_retarget_io_reserve(size_t max, void** ptr);
+
+/**
+ * \brief Sends the data written into the region returned by
+ * \ref cy_retarget_io_reserve.
+ * \param used Number of bytes written to the start of the region, may be 0
+ */
+void cy_retarget_io_commit(size_t used);
+
+/**
+ * \brief Writes a deferred log record, used by \ref CY_RETARGET_IO_LOG.
+ * \param fmt   Format string in the .cy_retarget_io_fmt section
+ * \param args  Arguments of the record
+ * \param count Number of arguments
+ */
+void cy_retarget_io_log_write(const char* fmt, const uint32_t* args, size_t count);
+
+/**
+ * \brief Returns the timestamp of \ref CY_RETARGET_IO_LOG records and
+ * \ref CY_RETARGET_IO_LINE_STAMP headers. The default implementation returns 0,
+ * the application can override it, e.g. with a millisecond tick counter, a
+ * CCU4 timer or the DWT cycle counter.
+ */
+uint32_t cy_retarget_io_get_timestamp(void);
+
+/**
+ * \brief Formats a message and writes it to stdout without the C library.
+ *
+ * A compact alternative to printf() with a bounded stack and without heap use.
+ * The output is collected in a buffer of \ref CY_RETARGET_IO_PRINTF_BUFFER_SIZE
+ * bytes on the stack and written through the same path as printf(), in the
+ * buffered mode straight into the transmit ring buffer. Output that does not fit
+ * the buffer is written in several parts at line ends, and each part counts as
+ * a write in \ref cy_retarget_io_stats_t. Other tasks and interrupts can write
+ * between the parts, so a line longer than the buffer may be interleaved with
+ * their output, unless \ref CY_RETARGET_IO_LINE_BUFFERS collects it.
+ *
+ * Supported are the conversions d, i, u, o, x, X, c, s, p and %, the flags
+ * -, 0, +, space and #, width and precision, also as *, and the length
+ * modifiers hh, h, l, ll, z and t. The f conversion requires
+ * \ref CY_RETARGET_IO_PRINTF_FLOAT, 64-bit ll arguments require
+ * \ref CY_RETARGET_IO_PRINTF_LONG_LONG. Unsupported conversions are written as
+ * they appear in the format string.
+ *
+ * \param fmt Format string
+ * \returns Number of characters formatted, not counting the CR added by
+ * \ref CY_RETARGET_IO_CONVERT_LF_TO_CRLF
+ */
+int cy_retarget_io_printf(const char* fmt, ...) CY_RETARGET_IO_PRINTF_ATTR;
+
+/**
+ * \brief \ref cy_retarget_io_printf with the arguments given as a va_list.
+ * \param fmt  Format string
+ * \param args Arguments
+ * \returns Number of characters formatted
+ */
+int cy_retarget_io_vprintf(const char* fmt, va_list args);
+
+/**
+ * \brief Returns the number of bytes dropped by the overflow policy of the
+ * buffered transmit mode, including data dropped by \ref cy_retarget_io_write_nb,
+ * and the output of interrupts in the polling mode, which they cannot send
+ * without the mutex.
+ */
+uint32_t cy_retarget_io_get_tx_dropped(void);
+
+/**
+ * \brief Returns the receive overrun counters of the buffered receive mode.
+ * \param overruns Receives the counters
+ */
+void cy_retarget_io_get_rx_overruns(cy_retarget_io_rx_overruns_t* overruns);
+
+#if defined(CY_RETARGET_IO_STATS) || defined(DOXYGEN)
+/**
+ * \brief Returns the usage statistics collected since \ref cy_retarget_io_init,
+ * e.g. to size the buffers or to find the tasks that log too much. Only
+ * available with \ref CY_RETARGET_IO_STATS.
+ * \param stats Receives the statistics
+ */
+void cy_retarget_io_get_stats(cy_retarget_io_stats_t* stats);
+#endif
+
+/**
+ * \brief Sends out everything still held in the transmit ring buffers by
+ * polling the USIC channel, for use in HardFault and CY_ASSERT handlers.
+ *
+ * Disables the interrupt and the DMA channel of the buffered mode and does not
+ * take any mutex. Data of a producer that was interrupted while copying is sent
+ * as far as it got, a region handed out by \ref cy_retarget_io_reserve and not
+ * committed is lost. Afterwards the transmit path stays in the polling mode
+ * without locking, so printf can be used for the rest of the handler. The
+ * buffered receive mode is not serviced any more.
+ */
+void cy_retarget_io_panic_flush(void);
+
+/**
+ * \brief Sends the output held in the trace capture log over the UART and
+ * empties the log.
+ *
+ * The output was converted and stamped when it was captured and is sent
+ * unchanged, through the buffered transmit path if it is used and by polling
+ * otherwise. Output captured while the log is sent is left for the next call.
+ * After \ref cy_retarget_io_panic_flush, a fault handler can call it to send
+ * the history by polling.
+ * \returns Number of bytes taken from the log, 0 if the capture mode is not
+ * used
+ */
+size_t cy_retarget_io_dump(void);
+
 /**
  * \brief Releases the UART interface allowing it to be used for other purposes.
  * After calling this, printf and related functions will no longer work.
@@ -0,0 +1,153 @@
+// Throughput and printf latency of every transmit mode on the simulated line.
+//
+// The host times each cy_retarget_io_printf() call. In the buffered modes that covers
+// formatting, reserving and copying into the ring, plus the interrupts the simulation takes
+// meanwhile; in the polling modes it includes waiting for the line. The results compare the
+// modes with each other and between revisions of the library; they are host numbers that
+// include the cost of the simulation, not target numbers. The same workload runs on a board
+// with target/bench_target.c.
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT  "cycles"
+#else
+#define BENCH_UNIT  "ns"
+#endif
+
+#define BENCH_CALLS (2000)
+
+typedef enum
+{
+    MODE_POLLING,
+    MODE_POLLING_FIFO,
+    MODE_INTERRUPT,
+    MODE_INTERRUPT_FIFO,
+    MODE_DMA,
+    MODE_COUNT
+} tx_mode_t;
+
+static const char* const mode_names[MODE_COUNT] =
+{
+    "polling", "polling fifo", "interrupt", "interrupt fifo", "dma"
+};
+
+// Holds all the output of one run, so the buffered modes never wait for the line
+static uint8_t  tx_buffer[1 << 17];
+static uint64_t samples[BENCH_CALLS];
+
+
+static uint64_t bench_now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec;
+#endif
+}
+
+
+static double seconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + ((double)now.tv_nsec * 1e-9);
+}
+
+
+static int compare(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+
+static uint64_t percentile(unsigned pct)
+{
+    return samples[((size_t)BENCH_CALLS * pct) / 100U - ((pct == 100U) ? 1U : 0U)];
+}
+
+
+static void init(tx_mode_t mode)
+{
+    cy_retarget_io_config_t config;
+
+    sim_reset();
+    if ((mode == MODE_POLLING_FIFO) || (mode == MODE_INTERRUPT_FIFO))
+    {
+        XMC_USIC0_CH0->TBCTR = (uint32_t)XMC_USIC_CH_FIFO_SIZE_16WORDS << USIC_CH_TBCTR_SIZE_Pos;
+    }
+    memset(&config, 0, sizeof(config));
+    config.channel = XMC_USIC0_CH0;
+    if (mode >= MODE_INTERRUPT)
+    {
+        config.tx_buffer      = tx_buffer;
+        config.tx_buffer_size = sizeof(tx_buffer);
+    }
+    if (mode == MODE_DMA)
+    {
+        config.dma.enable          = true;
+        config.dma.channel         = 2U;
+        config.dma.service_request = 1U;
+    }
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+}
+
+
+static void run(tx_mode_t mode)
+{
+    uint64_t total = 0U;
+    size_t   bytes = 0U;
+    double   elapsed;
+
+    init(mode);
+    elapsed = seconds();
+    for (int i = 0; i < BENCH_CALLS; i++)
+    {
+        uint64_t start = bench_now();
+        int      len   = cy_retarget_io_printf("[%6u] sensor %d: temp=%d.%d C, state=%s\n",
+                                               (unsigned)(i * 37), i % 4, 20 + (i % 7), i % 10,
+                                               ((i % 9) != 0) ? "OK" : "WARN");
+        samples[i] = bench_now() - start;
+        total     += samples[i];
+        assert(len > 0);
+        bytes += (size_t)len;
+    }
+    elapsed = seconds() - elapsed;
+    sim_drain();
+    while (cy_retarget_io_is_tx_active())
+    {
+        sim_drain();
+    }
+    assert(sim_out_len == bytes);
+    cy_retarget_io_deinit();
+
+    qsort(samples, BENCH_CALLS, sizeof(samples[0]), compare);
+    printf("%-15s %12.0f %10.1f %8llu %8llu %8llu %8llu\n", mode_names[mode],
+           (double)bytes / elapsed, (double)total / (double)bytes,
+           (unsigned long long)percentile(50U), (unsigned long long)percentile(90U),
+           (unsigned long long)percentile(99U), (unsigned long long)percentile(100U));
+}
+
+
+int main(void)
+{
+    setvbuf(stdout, NULL, _IONBF, 0);
+    printf("%d printf calls per mode, latency in " BENCH_UNIT "\n", BENCH_CALLS);
+    printf("%-15s %12s %10s %8s %8s %8s %8s\n", "mode", "bytes/s", BENCH_UNIT "/B", "p50",
+           "p90", "p99", "max");
+    for (int mode = 0; mode < (int)MODE_COUNT; mode++)
+    {
+        run((tx_mode_t)mode);
+    }
+    printf("ALL OK\n");
+    return 0;
+}
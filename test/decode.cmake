@@ -0,0 +1,20 @@
+# Runs the decode test program, then tools/retarget_decode.py on its output with the ELF file of
+# the program, and compares the result with the text the program expects.
+#
+#   cmake -DPYTHON=<python3> -DDECODER=<retarget_decode.py> -DPROGRAM=<decode> -DOUT=<prefix>
+#         -P decode.cmake
+execute_process(COMMAND ${PROGRAM} ${OUT}.bin ${OUT}.expected OUTPUT_QUIET RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${PROGRAM} failed: ${result}")
+endif()
+execute_process(COMMAND ${PYTHON} ${DECODER} -e ${PROGRAM} ${OUT}.bin
+                OUTPUT_FILE ${OUT}.txt RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${DECODER} failed: ${result}")
+endif()
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${OUT}.txt ${OUT}.expected
+                RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${OUT}.txt differs from ${OUT}.expected")
+endif()
+message(STATUS "ALL OK")
@@ -0,0 +1,15 @@
+// Host mock of the result codes of the core-lib library
+#pragma once
+
+#include <stdint.h>
+
+typedef uint32_t cy_rslt_t;
+
+#define CY_RSLT_SUCCESS                      ((cy_rslt_t)0U)
+#define CY_RSLT_TYPE_INFO                    (0U)
+#define CY_RSLT_TYPE_WARNING                 (1U)
+#define CY_RSLT_TYPE_ERROR                   (2U)
+#define CY_RSLT_TYPE_FATAL                   (3U)
+#define CY_RSLT_MODULE_BOARD_LIB_RETARGET_IO (0x1A1U)
+#define CY_RSLT_CREATE(type, module, code) \
+    ((((module) & 0x3FFFU) << 16U) | (((type) & 0x3U) << 30U) | ((code) & 0xFFFFU))
@@ -0,0 +1,8 @@
+// Host mock of the utilities of the core-lib library
+#pragma once
+
+#include <assert.h>
+
+#define CY_ASSERT(x)            assert(x)
+#define CY_UNUSED_PARAMETER(x)  (void)(x)
+#define CY_HALT()               do { } while (0)
@@ -0,0 +1,25 @@
+// Host mock of the abstraction-rtos library, see sim.c
+#pragma once
+
+#include <stdbool.h>
+#include "cy_result.h"
+
+typedef struct { int count; } cy_mutex_t;
+typedef struct { int count; } cy_semaphore_t;
+typedef void* cy_thread_t;
+typedef uint32_t cy_time_t;
+
+#define CY_RTOS_NEVER_TIMEOUT   (0xFFFFFFFFUL)
+#define CY_RTOS_TIMEOUT         (0x5001U)
+
+cy_rslt_t cy_rtos_init_mutex(cy_mutex_t* mutex);
+cy_rslt_t cy_rtos_get_mutex(cy_mutex_t* mutex, cy_time_t timeout_ms);
+cy_rslt_t cy_rtos_set_mutex(cy_mutex_t* mutex);
+cy_rslt_t cy_rtos_deinit_mutex(cy_mutex_t* mutex);
+cy_rslt_t cy_rtos_init_semaphore(cy_semaphore_t* semaphore, uint32_t maxcount, uint32_t initcount);
+cy_rslt_t cy_rtos_get_semaphore(cy_semaphore_t* semaphore, cy_time_t timeout_ms, bool in_isr);
+cy_rslt_t cy_rtos_set_semaphore(cy_semaphore_t* semaphore, bool in_isr);
+cy_rslt_t cy_rtos_deinit_semaphore(cy_semaphore_t* semaphore);
+cy_rslt_t cy_rtos_get_thread_handle(cy_thread_t* thread);
+cy_rslt_t cy_rtos_get_time(cy_time_t* tval);
+cy_rslt_t cy_rtos_delay_milliseconds(cy_time_t num_ms);
@@ -0,0 +1,8 @@
+// Host mock of the ARM C library system interface
+#pragma once
+
+typedef int FILEHANDLE;
+
+extern const char __stdin_name[];
+extern const char __stdout_name[];
+extern const char __stderr_name[];
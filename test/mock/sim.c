@@ -0,0 +1,1179 @@
+// Host simulation of XMC_USIC0_CH0, the NVIC, GPDMA0 and the RTOS abstraction, see sim.h
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xmc_uart.h"
+#include "xmc_dma.h"
+#include "cyabs_rtos.h"
+#include "sim.h"
+
+#define SIM_NVIC_LINES  (128)
+#define SIM_FIFO_MAX    (64)
+#define SIM_NO_DMA      (255U)
+#define SIM_WFI_LIMIT   (10000000)
+
+uint32_t       SystemCoreClock = 1000000U;
+SysTick_Type   sim_systick;
+SCB_Type       sim_scb;
+#if (UC_FAMILY == XMC4)
+DWT_Type       sim_dwt;
+CoreDebug_Type sim_core_debug;
+#endif
+XMC_USIC_CH_t  sim_usic[6];
+XMC_DMA_t      sim_dma0;
+
+uint8_t  sim_out[1 << 20];
+size_t   sim_out_len;
+uint8_t  sim_out2[1 << 16];
+size_t   sim_out2_len;
+uint64_t sim_time;
+int      sim_ticks_per_char = 10;
+int      sim_tx_stall;
+int      sim_tick_masked;
+int      sim_loopback;
+int      sim_wfi_count;
+int      sim_mutex_gets;
+int      sim_mutex_held;
+int      sim_semaphore_waits;
+int      sim_irq_masks;
+int      sim_semaphore_init_fail;
+int      sim_semaphores;
+void*    sim_thread_id;
+void     (*sim_switch)(void);
+void     (*sim_on_tick)(void);
+
+extern void cy_retarget_io_irq_handler(void);
+
+static int      primask;
+static int      in_isr;
+static uint32_t ipsr_forced;
+static int      nvic_enabled[SIM_NVIC_LINES];
+static int      systick_pending;
+static int      nvic_pending[SIM_NVIC_LINES];
+
+// Transmit buffer, shift register and FIFOs of XMC_USIC0_CH0
+static int      tbuf_valid;
+static uint16_t tbuf;
+static int      shift_busy;
+static int      shift_ticks;
+static uint16_t shift_data;
+static uint16_t tx_fifo[SIM_FIFO_MAX];
+static int      tx_fifo_level;
+static int      tx_fifo_read;
+static uint16_t rx_fifo[SIM_FIFO_MAX];
+static int      rx_fifo_level;
+static int      rx_fifo_read;
+static uint32_t uart_events;
+
+// Service request lines selected by the interrupt node pointers, -1 if unused
+static int tbi_sr;
+static int rx_sr;
+static int alt_rx_sr;
+static int tx_fifo_sr;
+static int rx_fifo_sr;
+
+// GPDMA0 channel, handshaking with the transmit buffer interrupt on service request 1
+static uint8_t                    dma_channel = SIM_NO_DMA;
+static int                        dma_enabled;
+static int                        dma_request;
+static int                        dma_irq_pending;
+static uint32_t                   dma_src;
+static uint32_t                   dma_count;
+static XMC_DMA_CH_EVENT_HANDLER_t dma_handler;
+
+// Simulated ISR and PRIMASK state apply to the status polls of the code under test
+#define THREAD_TICK() \
+    do { if (!in_isr && (!primask || sim_tick_masked)) { sim_tick(); } } while (0)
+
+
+//--------------------------------------------------------------------------------------------------
+// Simulation core
+//--------------------------------------------------------------------------------------------------
+static int fifo_size(uint32_t ctr)
+{
+    uint32_t code = (ctr & USIC_CH_TBCTR_SIZE_Msk) >> USIC_CH_TBCTR_SIZE_Pos;
+    return (code != 0U) ? (1 << code) : 0;
+}
+
+
+static int fifo_limit(uint32_t ctr)
+{
+    return (int)((ctr & USIC_CH_TBCTR_LIMIT_Msk) >> USIC_CH_TBCTR_LIMIT_Pos);
+}
+
+
+static void pend_sr(int sr)
+{
+    if (sr >= 0)
+    {
+        nvic_pending[USIC0_0_IRQn + sr] = 1;
+    }
+}
+
+
+static void trbsr_update(void)
+{
+    XMC_USIC_CH_t* channel = XMC_USIC0_CH0;
+    uint32_t       value   = channel->TRBSR &
+                             (USIC_CH_TRBSR_STBI_Msk | USIC_CH_TRBSR_SRBI_Msk | 2U);
+
+    value |= (uint32_t)tx_fifo_level << USIC_CH_TRBSR_TBFLVL_Pos;
+    if ((fifo_size(channel->TBCTR) != 0) && (tx_fifo_level == fifo_size(channel->TBCTR)))
+    {
+        value |= USIC_CH_TRBSR_TFULL_Msk;
+    }
+    if (tx_fifo_level == 0)
+    {
+        value |= USIC_CH_TRBSR_TEMPTY_Msk;
+    }
+    value |= (uint32_t)rx_fifo_level << USIC_CH_TRBSR_RBFLVL_Pos;
+    if (rx_fifo_level == 0)
+    {
+        value |= USIC_CH_TRBSR_REMPTY_Msk;
+    }
+    channel->TRBSR = value;
+}
+
+
+static void run_irqs(void)
+{
+    if ((primask != 0) || (in_isr != 0))
+    {
+        return;
+    }
+    systick_pending = 0;
+    for (int n = 0; n < SIM_NVIC_LINES; n++)
+    {
+        if ((nvic_pending[n] != 0) && (nvic_enabled[n] != 0))
+        {
+            nvic_pending[n] = 0;
+            in_isr          = 1;
+            if (n == GPDMA0_0_IRQn)
+            {
+                XMC_DMA_IRQHandler(XMC_DMA0);
+            }
+            else
+            {
+                cy_retarget_io_irq_handler();
+            }
+            in_isr = 0;
+            n      = -1; // Rescan, the handler may have raised another request
+        }
+    }
+}
+
+
+static int irq_pending(void)
+{
+    if (systick_pending != 0)
+    {
+        return 1;
+    }
+    for (int n = 0; n < SIM_NVIC_LINES; n++)
+    {
+        if ((nvic_pending[n] != 0) && (nvic_enabled[n] != 0))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+static void dma_step(void)
+{
+    XMC_USIC_CH_t* channel = XMC_USIC0_CH0;
+
+    if ((dma_enabled != 0) && (dma_request != 0) && (tbuf_valid == 0))
+    {
+        // The library passes 32 bit addresses; the ring sits in the same 4 GiB window as sim_out
+        uintptr_t base = (uintptr_t)sim_out & ~(uintptr_t)0xFFFFFFFFU;
+
+        dma_request    = 0;
+        tbuf           = *(const uint8_t*)(base | dma_src);
+        tbuf_valid     = 1;
+        channel->TCSR |= USIC_CH_TCSR_TDV_Msk;
+        dma_src++;
+        dma_count--;
+        if (dma_count == 0U)
+        {
+            dma_enabled                 = 0;
+            dma_irq_pending             = 1;
+            nvic_pending[GPDMA0_0_IRQn] = 1;
+        }
+    }
+}
+
+
+static void cycles_tick(void)
+{
+#if (UC_FAMILY == XMC4)
+    if ((sim_dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0U)
+    {
+        sim_dwt.CYCCNT += 100U;
+    }
+#endif
+    if ((sim_systick.CTRL & SysTick_CTRL_ENABLE_Msk) != 0U)
+    {
+        uint32_t value = sim_systick.VAL;
+        sim_systick.VAL = (value >= 100U)
+            ? (value - 100U)
+            : ((sim_systick.LOAD & SysTick_LOAD_RELOAD_Msk) + 1U + value - 100U);
+        if ((value < 100U) && ((sim_systick.CTRL & SysTick_CTRL_TICKINT_Msk) != 0U))
+        {
+            // The exception has no handler here, it only ends a WFI
+            systick_pending = 1;
+        }
+    }
+}
+
+
+static void rx_push(uint8_t data)
+{
+    XMC_USIC_CH_t* channel = XMC_USIC0_CH0;
+    int            size    = fifo_size(channel->RBCTR);
+
+    if (size != 0)
+    {
+        if (rx_fifo_level < size)
+        {
+            rx_fifo[(rx_fifo_read + rx_fifo_level) % SIM_FIFO_MAX] = data;
+            rx_fifo_level++;
+            if ((rx_fifo_level == (fifo_limit(channel->RBCTR) + 1)) &&
+                ((channel->RBCTR & XMC_USIC_CH_RXFIFO_EVENT_CONF_STANDARD) != 0U))
+            {
+                pend_sr(rx_fifo_sr);
+            }
+        }
+    }
+    else
+    {
+        if ((channel->PSR & XMC_UART_CH_STATUS_FLAG_RECEIVE_INDICATION) != 0U)
+        {
+            channel->PSR |= XMC_UART_CH_STATUS_FLAG_DATA_LOST_INDICATION;
+        }
+        channel->RBUF = data;
+        channel->PSR |= XMC_UART_CH_STATUS_FLAG_RECEIVE_INDICATION;
+        if ((uart_events & XMC_UART_CH_EVENT_STANDARD_RECEIVE) != 0U)
+        {
+            pend_sr(rx_sr);
+        }
+    }
+    trbsr_update();
+}
+
+
+static void shift_out(void)
+{
+    XMC_USIC_CH_t* channel = XMC_USIC0_CH0;
+
+    if ((shift_busy != 0) && (--shift_ticks <= 0))
+    {
+        shift_busy               = 0;
+        sim_out[sim_out_len++]   = (uint8_t)shift_data;
+        if (sim_loopback != 0)
+        {
+            rx_push((uint8_t)shift_data);
+        }
+    }
+    if (shift_busy != 0)
+    {
+        return;
+    }
+    if (fifo_size(channel->TBCTR) != 0)
+    {
+        if (tx_fifo_level != 0)
+        {
+            shift_data    = tx_fifo[tx_fifo_read];
+            tx_fifo_read  = (tx_fifo_read + 1) % SIM_FIFO_MAX;
+            tx_fifo_level--;
+            shift_busy    = 1;
+            shift_ticks   = sim_ticks_per_char;
+            if ((tx_fifo_level == (fifo_limit(channel->TBCTR) - 1)) &&
+                ((channel->TBCTR & XMC_USIC_CH_TXFIFO_EVENT_CONF_STANDARD) != 0U))
+            {
+                channel->TRBSR |= USIC_CH_TRBSR_STBI_Msk;
+                pend_sr(tx_fifo_sr);
+            }
+        }
+    }
+    else if (tbuf_valid != 0)
+    {
+        shift_data     = tbuf;
+        tbuf_valid     = 0;
+        channel->TCSR &= ~USIC_CH_TCSR_TDV_Msk;
+        shift_busy     = 1;
+        shift_ticks    = sim_ticks_per_char;
+        channel->PSR  |= XMC_UART_CH_STATUS_FLAG_TRANSMIT_BUFFER_INDICATION;
+        if ((uart_events & XMC_UART_CH_EVENT_TRANSMIT_BUFFER) != 0U)
+        {
+            if ((dma_channel != SIM_NO_DMA) && (tbi_sr == 1))
+            {
+                dma_request = 1;
+            }
+            else
+            {
+                pend_sr(tbi_sr);
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// sim_tick
+//--------------------------------------------------------------------------------------------------
+void sim_tick(void)
+{
+    XMC_USIC_CH_t* channel = XMC_USIC0_CH0;
+
+    cycles_tick();
+    sim_time++;
+    if (sim_on_tick != NULL)
+    {
+        sim_on_tick();
+    }
+    if (sim_tx_stall == 0)
+    {
+        shift_out();
+    }
+    if (shift_busy != 0)
+    {
+        channel->PSR |= XMC_UART_CH_STATUS_FLAG_TRANSFER_STATUS_BUSY;
+    }
+    else
+    {
+        channel->PSR &= ~XMC_UART_CH_STATUS_FLAG_TRANSFER_STATUS_BUSY;
+    }
+    dma_step();
+    trbsr_update();
+    run_irqs();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// sim_rx
+//--------------------------------------------------------------------------------------------------
+void sim_rx(uint8_t data)
+{
+    rx_push(data);
+    run_irqs();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// sim_reset
+//--------------------------------------------------------------------------------------------------
+void sim_reset(void)
+{
+    memset(sim_usic, 0, sizeof(sim_usic));
+    memset(nvic_enabled, 0, sizeof(nvic_enabled));
+    memset(nvic_pending, 0, sizeof(nvic_pending));
+    systick_pending = 0;
+    sim_out_len     = 0U;
+    sim_tx_stall    = 0;
+    sim_loopback    = 0;
+    primask         = 0;
+    in_isr          = 0;
+    tbuf_valid      = 0;
+    shift_busy      = 0;
+    tx_fifo_level   = 0;
+    tx_fifo_read    = 0;
+    rx_fifo_level   = 0;
+    rx_fifo_read    = 0;
+    uart_events     = 0U;
+    tbi_sr          = -1;
+    rx_sr           = -1;
+    alt_rx_sr       = -1;
+    tx_fifo_sr      = -1;
+    rx_fifo_sr      = -1;
+    dma_channel     = SIM_NO_DMA;
+    dma_enabled     = 0;
+    dma_request     = 0;
+    dma_irq_pending = 0;
+    dma_handler     = NULL;
+    sim_switch      = NULL;
+    sim_on_tick     = NULL;
+    trbsr_update();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// sim_drain
+//--------------------------------------------------------------------------------------------------
+void sim_drain(void)
+{
+    for (int i = 0; (i < SIM_WFI_LIMIT) &&
+         ((shift_busy != 0) || (tbuf_valid != 0) || (tx_fifo_level != 0) || (dma_enabled != 0));
+         i++)
+    {
+        sim_tick();
+    }
+    // Let the interrupt refill the hardware from the ring until it is empty as well
+    for (int i = 0; i < 100; i++)
+    {
+        sim_tick();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// sim_expect
+//--------------------------------------------------------------------------------------------------
+void sim_expect(const char* what, const void* data, size_t len)
+{
+    sim_drain();
+    if ((sim_out_len != len) || (memcmp(sim_out, data, len) != 0))
+    {
+        size_t at = 0U;
+        while ((at < len) && (at < sim_out_len) && (sim_out[at] == ((const uint8_t*)data)[at]))
+        {
+            at++;
+        }
+        printf("FAIL %s: %zu bytes out, %zu expected, first difference at %zu\n",
+               what, sim_out_len, len, at);
+        abort();
+    }
+    printf("ok %s\n", what);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// sim_force_ipsr
+//--------------------------------------------------------------------------------------------------
+void sim_force_ipsr(uint32_t ipsr)
+{
+    ipsr_forced = ipsr;
+}
+
+
+int sim_irq_enabled(IRQn_Type irqn)
+{
+    return nvic_enabled[irqn];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// CMSIS core
+//--------------------------------------------------------------------------------------------------
+static uint32_t apsr_ge;
+
+uint32_t __get_PRIMASK(void)
+{
+    if ((in_isr == 0) && (primask == 0))
+    {
+        sim_tick();
+    }
+    return (uint32_t)primask;
+}
+
+
+void __set_PRIMASK(uint32_t priMask)
+{
+    primask = (int)priMask;
+    run_irqs();
+}
+
+
+void __disable_irq(void)
+{
+    sim_irq_masks++;
+    primask = 1;
+}
+
+
+void __enable_irq(void)
+{
+    primask = 0;
+    run_irqs();
+}
+
+
+uint32_t __get_IPSR(void)
+{
+    return (in_isr != 0) ? (16U + (uint32_t)USIC0_0_IRQn) : ipsr_forced;
+}
+
+
+uint32_t __get_BASEPRI(void)
+{
+    return 0U;
+}
+
+
+void __DMB(void)
+{
+}
+
+
+void __DSB(void)
+{
+}
+
+
+void __ISB(void)
+{
+}
+
+
+void __WFI(void)
+{
+    int i = 0;
+
+    sim_wfi_count++;
+    while ((i < SIM_WFI_LIMIT) && (irq_pending() == 0))
+    {
+        sim_tick();
+        i++;
+    }
+    if (i == SIM_WFI_LIMIT)
+    {
+        fprintf(stderr, "WFI never woke up\n");
+        abort();
+    }
+    if (primask == 0)
+    {
+        run_irqs();
+    }
+}
+
+
+void __WFE(void)
+{
+    sim_tick();
+}
+
+
+void __SEV(void)
+{
+}
+
+
+void __NOP(void)
+{
+    sim_tick();
+}
+
+
+uint32_t __LDREXW(volatile uint32_t* addr)
+{
+    return *addr;
+}
+
+
+uint32_t __STREXW(uint32_t value, volatile uint32_t* addr)
+{
+    *addr = value;
+    return 0U;
+}
+
+
+void __CLREX(void)
+{
+}
+
+
+uint32_t __CLZ(uint32_t value)
+{
+    return (value != 0U) ? (uint32_t)__builtin_clz(value) : 32U;
+}
+
+
+uint32_t __RBIT(uint32_t value)
+{
+    uint32_t result = 0U;
+    for (int i = 0; i < 32; i++)
+    {
+        result  = (result << 1) | (value & 1U);
+        value >>= 1;
+    }
+    return result;
+}
+
+
+uint32_t __REV(uint32_t value)
+{
+    return __builtin_bswap32(value);
+}
+
+
+uint32_t __USUB8(uint32_t op1, uint32_t op2)
+{
+    uint32_t result = 0U;
+    for (int i = 0; i < 4; i++)
+    {
+        int diff = (int)((op1 >> (8 * i)) & 0xFFU) - (int)((op2 >> (8 * i)) & 0xFFU);
+        result |= ((uint32_t)diff & 0xFFU) << (8 * i);
+        if (diff >= 0)
+        {
+            apsr_ge |= 1U << i;
+        }
+    }
+    return result;
+}
+
+
+uint32_t __SEL(uint32_t op1, uint32_t op2)
+{
+    uint32_t result = 0U;
+    for (int i = 0; i < 4; i++)
+    {
+        result |= ((((apsr_ge >> i) & 1U) != 0U) ? op1 : op2) & (0xFFU << (8 * i));
+    }
+    apsr_ge = 0U;
+    return result;
+}
+
+
+void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    nvic_enabled[IRQn] = 1;
+    run_irqs();
+}
+
+
+void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    nvic_enabled[IRQn] = 0;
+}
+
+
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority)
+{
+    (void)IRQn;
+    (void)priority;
+}
+
+
+void NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+    nvic_pending[IRQn] = 0;
+}
+
+
+uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn)
+{
+    return (uint32_t)nvic_pending[IRQn];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// USIC
+//--------------------------------------------------------------------------------------------------
+void XMC_USIC_CH_WriteTransmitBuffer(XMC_USIC_CH_t* const channel, const uint16_t data)
+{
+    if (tbuf_valid != 0)
+    {
+        fprintf(stderr, "TBUF overwritten\n");
+        abort();
+    }
+    tbuf           = data;
+    tbuf_valid     = 1;
+    channel->TCSR |= USIC_CH_TCSR_TDV_Msk;
+}
+
+
+XMC_USIC_CH_TBUF_STATUS_t XMC_USIC_CH_GetTransmitBufferStatus(XMC_USIC_CH_t* const channel)
+{
+    (void)channel;
+    THREAD_TICK();
+    return (tbuf_valid != 0) ? XMC_USIC_CH_TBUF_STATUS_BUSY : XMC_USIC_CH_TBUF_STATUS_IDLE;
+}
+
+
+void XMC_USIC_CH_TriggerServiceRequest(XMC_USIC_CH_t* const channel,
+                                       const uint32_t service_request_line)
+{
+    (void)channel;
+    if ((dma_channel != SIM_NO_DMA) && (service_request_line == 1U))
+    {
+        dma_request = 1;
+    }
+    else
+    {
+        pend_sr((int)service_request_line);
+    }
+    dma_step();
+    run_irqs();
+}
+
+
+void XMC_USIC_CH_TXFIFO_PutData(XMC_USIC_CH_t* const channel, const uint16_t data)
+{
+    if (tx_fifo_level >= fifo_size(channel->TBCTR))
+    {
+        fprintf(stderr, "TXFIFO overflow\n");
+        abort();
+    }
+    tx_fifo[(tx_fifo_read + tx_fifo_level) % SIM_FIFO_MAX] = data;
+    tx_fifo_level++;
+    trbsr_update();
+}
+
+
+bool XMC_USIC_CH_TXFIFO_IsFull(XMC_USIC_CH_t* const channel)
+{
+    THREAD_TICK();
+    return tx_fifo_level == fifo_size(channel->TBCTR);
+}
+
+
+bool XMC_USIC_CH_TXFIFO_IsEmpty(XMC_USIC_CH_t* const channel)
+{
+    (void)channel;
+    THREAD_TICK();
+    return tx_fifo_level == 0;
+}
+
+
+uint32_t XMC_USIC_CH_TXFIFO_GetLevel(XMC_USIC_CH_t* const channel)
+{
+    (void)channel;
+    THREAD_TICK();
+    return (uint32_t)tx_fifo_level;
+}
+
+
+void XMC_USIC_CH_TXFIFO_EnableEvent(XMC_USIC_CH_t* const channel, const uint32_t event)
+{
+    channel->TBCTR |= event;
+}
+
+
+void XMC_USIC_CH_TXFIFO_DisableEvent(XMC_USIC_CH_t* const channel, const uint32_t event)
+{
+    channel->TBCTR &= ~event;
+}
+
+
+void XMC_USIC_CH_TXFIFO_ClearEvent(XMC_USIC_CH_t* const channel, const uint32_t event)
+{
+    channel->TRBSR &= ~event;
+}
+
+
+void XMC_USIC_CH_TXFIFO_Flush(XMC_USIC_CH_t* const channel)
+{
+    (void)channel;
+    tx_fifo_level = 0;
+}
+
+
+void XMC_USIC_CH_TXFIFO_SetInterruptNodePointer(
+    XMC_USIC_CH_t* const channel, const XMC_USIC_CH_TXFIFO_INTERRUPT_NODE_POINTER_t interrupt_node,
+    const uint32_t service_request)
+{
+    (void)channel;
+    (void)interrupt_node;
+    tx_fifo_sr = (int)service_request;
+}
+
+
+bool XMC_USIC_CH_RXFIFO_IsEmpty(XMC_USIC_CH_t* const channel)
+{
+    (void)channel;
+    return rx_fifo_level == 0;
+}
+
+
+uint16_t XMC_USIC_CH_RXFIFO_GetData(XMC_USIC_CH_t* const channel)
+{
+    uint16_t data = rx_fifo[rx_fifo_read];
+
+    (void)channel;
+    rx_fifo_read = (rx_fifo_read + 1) % SIM_FIFO_MAX;
+    rx_fifo_level--;
+    trbsr_update();
+    return data;
+}
+
+
+uint32_t XMC_USIC_CH_RXFIFO_GetLevel(XMC_USIC_CH_t* const channel)
+{
+    (void)channel;
+    return (uint32_t)rx_fifo_level;
+}
+
+
+void XMC_USIC_CH_RXFIFO_EnableEvent(XMC_USIC_CH_t* const channel, const uint32_t event)
+{
+    channel->RBCTR |= event;
+}
+
+
+void XMC_USIC_CH_RXFIFO_DisableEvent(XMC_USIC_CH_t* const channel, const uint32_t event)
+{
+    channel->RBCTR &= ~event;
+}
+
+
+uint32_t XMC_USIC_CH_RXFIFO_GetEvent(XMC_USIC_CH_t* const channel)
+{
+    return channel->TRBSR;
+}
+
+
+void XMC_USIC_CH_RXFIFO_ClearEvent(XMC_USIC_CH_t* const channel, const uint32_t event)
+{
+    channel->TRBSR &= ~event;
+}
+
+
+void XMC_USIC_CH_RXFIFO_SetInterruptNodePointer(
+    XMC_USIC_CH_t* const channel, const XMC_USIC_CH_RXFIFO_INTERRUPT_NODE_POINTER_t interrupt_node,
+    const uint32_t service_request)
+{
+    (void)channel;
+    (void)interrupt_node;
+    rx_fifo_sr = (int)service_request;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// UART
+//--------------------------------------------------------------------------------------------------
+void XMC_UART_CH_Transmit(XMC_USIC_CH_t* const channel, const uint16_t data)
+{
+    if (channel != XMC_USIC0_CH0)
+    {
+        sim_out2[sim_out2_len++] = (uint8_t)data;
+    }
+    else if (fifo_size(channel->TBCTR) == 0)
+    {
+        while (tbuf_valid != 0)
+        {
+            sim_tick();
+        }
+        channel->PSCR = 0U;
+        tbuf          = data;
+        tbuf_valid    = 1;
+    }
+    else
+    {
+        // The XMC driver does not wait for FIFO space either
+        if (tx_fifo_level >= fifo_size(channel->TBCTR))
+        {
+            fprintf(stderr, "XMC_UART_CH_Transmit: TXFIFO overflow\n");
+            abort();
+        }
+        XMC_USIC_CH_TXFIFO_PutData(channel, data);
+    }
+}
+
+
+uint16_t XMC_UART_CH_GetReceivedData(XMC_USIC_CH_t* const channel)
+{
+    return (fifo_size(channel->RBCTR) != 0)
+        ? XMC_USIC_CH_RXFIFO_GetData(channel)
+        : (uint16_t)channel->RBUF;
+}
+
+
+uint32_t XMC_UART_CH_GetStatusFlag(XMC_USIC_CH_t* const channel)
+{
+    THREAD_TICK();
+    return channel->PSR;
+}
+
+
+void XMC_UART_CH_ClearStatusFlag(XMC_USIC_CH_t* const channel, const uint32_t flag)
+{
+    channel->PSR &= ~flag;
+}
+
+
+void XMC_UART_CH_EnableEvent(XMC_USIC_CH_t* const channel, const uint32_t event)
+{
+    (void)channel;
+    uart_events |= event;
+}
+
+
+void XMC_UART_CH_DisableEvent(XMC_USIC_CH_t* const channel, const uint32_t event)
+{
+    (void)channel;
+    uart_events &= ~event;
+}
+
+
+void XMC_UART_CH_SelectInterruptNodePointer(
+    XMC_USIC_CH_t* const channel, const XMC_UART_CH_INTERRUPT_NODE_POINTER_t interrupt_node,
+    const uint32_t service_request)
+{
+    (void)channel;
+    if (interrupt_node == XMC_UART_CH_INTERRUPT_NODE_POINTER_TRANSMIT_BUFFER)
+    {
+        tbi_sr = (int)service_request;
+    }
+    else if (interrupt_node == XMC_UART_CH_INTERRUPT_NODE_POINTER_RECEIVE)
+    {
+        rx_sr = (int)service_request;
+    }
+    else
+    {
+        alt_rx_sr = (int)service_request;
+    }
+}
+
+
+XMC_UART_CH_STATUS_t XMC_UART_CH_SetBaudrate(XMC_USIC_CH_t* const channel, uint32_t rate,
+                                             uint32_t oversampling)
+{
+    (void)channel;
+    (void)rate;
+    (void)oversampling;
+    return XMC_UART_CH_STATUS_OK;
+}
+
+
+XMC_UART_CH_STATUS_t XMC_UART_CH_Stop(XMC_USIC_CH_t* const channel)
+{
+    (void)channel;
+    return ((shift_busy != 0) || (tbuf_valid != 0))
+        ? XMC_UART_CH_STATUS_BUSY
+        : XMC_UART_CH_STATUS_OK;
+}
+
+
+void XMC_UART_CH_Start(XMC_USIC_CH_t* const channel)
+{
+    (void)channel;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// GPDMA
+//--------------------------------------------------------------------------------------------------
+void XMC_DMA_Init(XMC_DMA_t* const dma)
+{
+    (void)dma;
+}
+
+
+bool XMC_DMA_IsEnabled(const XMC_DMA_t* const dma)
+{
+    (void)dma;
+    return true;
+}
+
+
+XMC_DMA_CH_STATUS_t XMC_DMA_CH_Init(XMC_DMA_t* const dma, const uint8_t channel,
+                                    const XMC_DMA_CH_CONFIG_t* const config)
+{
+    (void)dma;
+    (void)config;
+    dma_channel = channel;
+    return XMC_DMA_CH_STATUS_OK;
+}
+
+
+void XMC_DMA_CH_Enable(XMC_DMA_t* const dma, const uint8_t channel)
+{
+    (void)dma;
+    (void)channel;
+    dma_enabled = 1;
+    dma_step();
+}
+
+
+void XMC_DMA_CH_Disable(XMC_DMA_t* const dma, const uint8_t channel)
+{
+    (void)dma;
+    (void)channel;
+    dma_enabled = 0;
+}
+
+
+bool XMC_DMA_CH_IsEnabled(XMC_DMA_t* const dma, const uint8_t channel)
+{
+    (void)dma;
+    (void)channel;
+    if (sim_tick_masked != 0)
+    {
+        THREAD_TICK();
+    }
+    return dma_enabled != 0;
+}
+
+
+void XMC_DMA_CH_SetSourceAddress(XMC_DMA_t* const dma, const uint8_t channel, uint32_t addr)
+{
+    (void)dma;
+    (void)channel;
+    dma_src = addr;
+}
+
+
+void XMC_DMA_CH_SetBlockSize(XMC_DMA_t* const dma, const uint8_t channel, uint32_t block_size)
+{
+    (void)dma;
+    (void)channel;
+    dma_count = block_size;
+}
+
+
+void XMC_DMA_CH_EnableEvent(XMC_DMA_t* const dma, const uint8_t channel, const uint32_t event)
+{
+    (void)dma;
+    (void)channel;
+    (void)event;
+}
+
+
+void XMC_DMA_CH_DisableEvent(XMC_DMA_t* const dma, const uint8_t channel, const uint32_t event)
+{
+    (void)dma;
+    (void)channel;
+    (void)event;
+}
+
+
+void XMC_DMA_CH_SetEventHandler(XMC_DMA_t* const dma, const uint8_t channel,
+                                XMC_DMA_CH_EVENT_HANDLER_t event_handler)
+{
+    (void)dma;
+    (void)channel;
+    dma_handler = event_handler;
+}
+
+
+void XMC_DMA_IRQHandler(XMC_DMA_t* const dma)
+{
+    (void)dma;
+    if (dma_irq_pending != 0)
+    {
+        dma_irq_pending = 0;
+        if (dma_handler != NULL)
+        {
+            dma_handler(XMC_DMA_CH_EVENT_TRANSFER_COMPLETE);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// RTOS abstraction: one cooperative thread, waits advance the simulated line
+//--------------------------------------------------------------------------------------------------
+cy_rslt_t cy_rtos_init_mutex(cy_mutex_t* mutex)
+{
+    mutex->count = 0;
+    return CY_RSLT_SUCCESS;
+}
+
+
+cy_rslt_t cy_rtos_get_mutex(cy_mutex_t* mutex, cy_time_t timeout_ms)
+{
+    (void)timeout_ms;
+    if (__get_IPSR() != 0U)
+    {
+        fprintf(stderr, "mutex taken in an interrupt\n");
+        abort();
+    }
+    mutex->count++;
+    sim_mutex_gets++;
+    sim_mutex_held++;
+    return CY_RSLT_SUCCESS;
+}
+
+
+cy_rslt_t cy_rtos_set_mutex(cy_mutex_t* mutex)
+{
+    mutex->count--;
+    sim_mutex_held--;
+    return CY_RSLT_SUCCESS;
+}
+
+
+cy_rslt_t cy_rtos_deinit_mutex(cy_mutex_t* mutex)
+{
+    (void)mutex;
+    return CY_RSLT_SUCCESS;
+}
+
+
+cy_rslt_t cy_rtos_init_semaphore(cy_semaphore_t* semaphore, uint32_t maxcount, uint32_t initcount)
+{
+    (void)maxcount;
+    if ((sim_semaphore_init_fail > 0) && (--sim_semaphore_init_fail == 0))
+    {
+        return CY_RTOS_TIMEOUT;
+    }
+    sim_semaphores++;
+    semaphore->count = (int)initcount;
+    return CY_RSLT_SUCCESS;
+}
+
+
+cy_rslt_t cy_rtos_get_semaphore(cy_semaphore_t* semaphore, cy_time_t timeout_ms, bool in_isr)
+{
+    uint64_t waited = 0U;
+
+    (void)in_isr;
+    if (semaphore->count == 0)
+    {
+        sim_semaphore_waits++;
+    }
+    if ((semaphore->count == 0) && (sim_switch != NULL))
+    {
+        void (*task)(void) = sim_switch;
+        sim_switch = NULL;
+        task();
+    }
+    while (semaphore->count == 0)
+    {
+        sim_tick();
+        waited++;
+        if ((timeout_ms != CY_RTOS_NEVER_TIMEOUT) && (waited > (uint64_t)timeout_ms * 10U))
+        {
+            return CY_RTOS_TIMEOUT;
+        }
+        if (waited > (uint64_t)SIM_WFI_LIMIT)
+        {
+            fprintf(stderr, "semaphore never signalled\n");
+            abort();
+        }
+    }
+    semaphore->count--;
+    return CY_RSLT_SUCCESS;
+}
+
+
+cy_rslt_t cy_rtos_set_semaphore(cy_semaphore_t* semaphore, bool in_isr)
+{
+    (void)in_isr;
+    semaphore->count = 1;
+    return CY_RSLT_SUCCESS;
+}
+
+
+cy_rslt_t cy_rtos_deinit_semaphore(cy_semaphore_t* semaphore)
+{
+    (void)semaphore;
+    sim_semaphores--;
+    return CY_RSLT_SUCCESS;
+}
+
+
+cy_rslt_t cy_rtos_get_thread_handle(cy_thread_t* thread)
+{
+    static int main_thread;
+    *thread = (sim_thread_id != NULL) ? sim_thread_id : &main_thread;
+    return CY_RSLT_SUCCESS;
+}
+
+
+cy_rslt_t cy_rtos_get_time(cy_time_t* tval)
+{
+    *tval = (cy_time_t)(sim_time / 10U);
+    return CY_RSLT_SUCCESS;
+}
+
+
+cy_rslt_t cy_rtos_delay_milliseconds(cy_time_t num_ms)
+{
+    for (uint64_t i = 0U; i < (uint64_t)num_ms * 10U; i++)
+    {
+        sim_tick();
+    }
+    return CY_RSLT_SUCCESS;
+}
@@ -0,0 +1,47 @@
+// Host simulation of XMC_USIC0_CH0, the NVIC and GPDMA0 that the retarget-io tests run against.
+//
+// Nothing runs concurrently: the simulated line advances by one tick whenever the code under test
+// polls a status register, waits (__WFI, semaphores, delays) or the test calls sim_tick(). One
+// character takes sim_ticks_per_char ticks to shift out and ten ticks make one RTOS millisecond.
+// Pending interrupts are taken at the next tick while PRIMASK is clear.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cy_retarget_io.h"
+
+extern uint8_t  sim_out[];          // Bytes shifted out of XMC_USIC0_CH0
+extern size_t   sim_out_len;
+extern uint8_t  sim_out2[];         // Bytes transmitted on any other channel
+extern size_t   sim_out2_len;
+extern uint64_t sim_time;           // Ticks since the start of the program
+extern int      sim_ticks_per_char; // Ticks per character on the line, 10 by default
+extern int      sim_tx_stall;       // Non zero holds the transmitter, e.g. for a flow control stop
+extern int      sim_tick_masked;    // Non zero keeps the line running while PRIMASK is set
+extern int      sim_loopback;       // Non zero feeds every transmitted byte back to the receiver
+extern int      sim_wfi_count;      // Calls of __WFI
+extern int      sim_mutex_gets;     // Calls of cy_rtos_get_mutex
+extern int      sim_mutex_held;     // Calls of cy_rtos_get_mutex not matched by cy_rtos_set_mutex
+extern int      sim_semaphore_waits; // Calls of cy_rtos_get_semaphore that had to block
+extern int      sim_irq_masks;      // Calls of __disable_irq
+extern int      sim_semaphore_init_fail; // n > 0 fails the nth cy_rtos_init_semaphore from now
+extern int      sim_semaphores;     // Semaphores created and not deleted
+extern void*    sim_thread_id;      // Handle returned by cy_rtos_get_thread_handle, NULL for main
+extern void     (*sim_switch)(void); // Called once instead of blocking on a semaphore, models
+                                    // another task running meanwhile
+extern void     (*sim_on_tick)(void); // Called at every tick while set, models code that runs
+                                      // meanwhile
+
+void sim_reset(void);
+void sim_tick(void);
+void sim_drain(void);
+void sim_rx(uint8_t data);
+void sim_force_ipsr(uint32_t ipsr);
+int  sim_irq_enabled(IRQn_Type irqn);
+
+// Drains the line and aborts unless sim_out holds exactly len bytes of data
+void sim_expect(const char* what, const void* data, size_t len);
+
+// The retarget functions of the newlib build of the library
+int _write(int fd, const char* ptr, int len);
+int _read(int fd, char* ptr, int len);
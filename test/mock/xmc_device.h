@@ -0,0 +1,122 @@
+// Host mock of the device header and the CMSIS core functions, see sim.c. UC_FAMILY selects the
+// simulated family: XMC4 (Cortex-M4, the default) or XMC1 (Cortex-M0).
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define XMC1 1
+#define XMC4 4
+#if !defined(UC_FAMILY)
+#define UC_FAMILY XMC4
+#endif
+
+#define __NVIC_PRIO_BITS 6
+#if (UC_FAMILY == XMC4)
+#define __CORTEX_M 4
+#else
+#define __CORTEX_M 0
+#endif
+
+typedef enum
+{
+    SysTick_IRQn  = -1,
+    USIC0_0_IRQn  = 84,
+    USIC1_0_IRQn  = 90,
+    USIC2_0_IRQn  = 96,
+    GPDMA0_0_IRQn = 105
+} IRQn_Type;
+
+extern uint32_t SystemCoreClock;
+
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+void __disable_irq(void);
+void __enable_irq(void);
+uint32_t __get_IPSR(void);
+uint32_t __get_BASEPRI(void);
+void __DMB(void);
+void __DSB(void);
+void __ISB(void);
+void __WFI(void);
+void __WFE(void);
+void __SEV(void);
+void __NOP(void);
+uint32_t __LDREXW(volatile uint32_t* addr);
+uint32_t __STREXW(uint32_t value, volatile uint32_t* addr);
+void __CLREX(void);
+uint32_t __CLZ(uint32_t value);
+uint32_t __RBIT(uint32_t value);
+uint32_t __REV(uint32_t value);
+uint32_t __USUB8(uint32_t op1, uint32_t op2);
+uint32_t __SEL(uint32_t op1, uint32_t op2);
+
+void NVIC_EnableIRQ(IRQn_Type IRQn);
+void NVIC_DisableIRQ(IRQn_Type IRQn);
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority);
+void NVIC_ClearPendingIRQ(IRQn_Type IRQn);
+uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn);
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+    volatile uint32_t CALIB;
+} SysTick_Type;
+
+extern SysTick_Type sim_systick;
+#define SysTick                         (&sim_systick)
+#define SysTick_CTRL_ENABLE_Msk         (1UL)
+#define SysTick_CTRL_TICKINT_Msk        (2UL)
+#define SysTick_CTRL_CLKSOURCE_Msk      (4UL)
+#define SysTick_CTRL_COUNTFLAG_Msk      (1UL << 16U)
+#define SysTick_LOAD_RELOAD_Msk         (0xFFFFFFUL)
+
+#if (UC_FAMILY == XMC4)
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+extern DWT_Type sim_dwt;
+#define DWT                             (&sim_dwt)
+#define DWT_CTRL_CYCCNTENA_Msk          (1UL)
+
+typedef struct
+{
+    volatile uint32_t DHCSR;
+    volatile uint32_t DCRSR;
+    volatile uint32_t DCRDR;
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern CoreDebug_Type sim_core_debug;
+#define CoreDebug                       (&sim_core_debug)
+#define CoreDebug_DEMCR_TRCENA_Msk      (1UL << 24U)
+
+typedef struct
+{
+    volatile uint32_t ICSR;
+    volatile uint32_t VTOR;
+    volatile uint32_t AIRCR;
+    volatile uint32_t SCR;
+    volatile uint32_t CCR;
+} SCB_Type;
+#else
+typedef struct
+{
+    volatile uint32_t CPUID;
+    volatile uint32_t ICSR;
+    volatile uint32_t VTOR;
+    volatile uint32_t AIRCR;
+    volatile uint32_t SCR;
+    volatile uint32_t CCR;
+} SCB_Type;
+#endif // (UC_FAMILY == XMC4)
+
+extern SCB_Type sim_scb;
+#define SCB                             (&sim_scb)
+#define SCB_SCR_SLEEPDEEP_Msk           (4UL)
+#define SCB_ICSR_VECTACTIVE_Msk         (0x1FFUL)
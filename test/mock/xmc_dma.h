@@ -0,0 +1,101 @@
+// Host mock of the XMC GPDMA driver, see sim.c
+#pragma once
+
+#include "xmc_device.h"
+
+typedef struct
+{
+    uint32_t unused;
+} XMC_DMA_t;
+
+extern XMC_DMA_t sim_dma0;
+#define XMC_DMA0 (&sim_dma0)
+
+typedef enum
+{
+    XMC_DMA_CH_STATUS_OK,
+    XMC_DMA_CH_STATUS_ERROR,
+    XMC_DMA_CH_STATUS_BUSY
+} XMC_DMA_CH_STATUS_t;
+
+typedef enum { XMC_DMA_CH_TRANSFER_WIDTH_8 = 0 } XMC_DMA_CH_TRANSFER_WIDTH_t;
+typedef enum
+{
+    XMC_DMA_CH_ADDRESS_COUNT_MODE_INCREMENT = 0,
+    XMC_DMA_CH_ADDRESS_COUNT_MODE_DECREMENT,
+    XMC_DMA_CH_ADDRESS_COUNT_MODE_NO_CHANGE
+} XMC_DMA_CH_ADDRESS_COUNT_MODE_t;
+typedef enum { XMC_DMA_CH_BURST_LENGTH_1 = 0 } XMC_DMA_CH_BURST_LENGTH_t;
+typedef enum
+{
+    XMC_DMA_CH_TRANSFER_FLOW_M2M_DMA,
+    XMC_DMA_CH_TRANSFER_FLOW_M2P_DMA
+} XMC_DMA_CH_TRANSFER_FLOW_t;
+typedef enum { XMC_DMA_CH_TRANSFER_TYPE_SINGLE_BLOCK } XMC_DMA_CH_TRANSFER_TYPE_t;
+typedef enum { XMC_DMA_CH_PRIORITY_0 } XMC_DMA_CH_PRIORITY_t;
+typedef enum
+{
+    XMC_DMA_CH_DST_HANDSHAKING_HARDWARE = 0,
+    XMC_DMA_CH_DST_HANDSHAKING_SOFTWARE
+} XMC_DMA_CH_DST_HANDSHAKING_t;
+typedef enum
+{
+    XMC_DMA_CH_SRC_HANDSHAKING_HARDWARE = 0,
+    XMC_DMA_CH_SRC_HANDSHAKING_SOFTWARE
+} XMC_DMA_CH_SRC_HANDSHAKING_t;
+typedef enum
+{
+    XMC_DMA_CH_EVENT_TRANSFER_COMPLETE       = 1,
+    XMC_DMA_CH_EVENT_BLOCK_TRANSFER_COMPLETE = 2,
+    XMC_DMA_CH_EVENT_ERROR                   = 16
+} XMC_DMA_CH_EVENT_t;
+
+typedef void (* XMC_DMA_CH_EVENT_HANDLER_t)(XMC_DMA_CH_EVENT_t event);
+
+typedef struct
+{
+    union
+    {
+        uint32_t control;
+        struct
+        {
+            uint32_t enable_interrupt       : 1;
+            uint32_t dst_transfer_width     : 3;
+            uint32_t src_transfer_width     : 3;
+            uint32_t dst_address_count_mode : 2;
+            uint32_t src_address_count_mode : 2;
+            uint32_t dst_burst_length       : 3;
+            uint32_t src_burst_length       : 3;
+            uint32_t enable_src_gather      : 1;
+            uint32_t enable_dst_scatter     : 1;
+            uint32_t                        : 1;
+            uint32_t transfer_flow          : 3;
+            uint32_t                        : 9;
+        };
+    };
+    uint32_t                     src_addr;
+    uint32_t                     dst_addr;
+    void*                        linked_list_pointer;
+    uint16_t                     block_size;
+    XMC_DMA_CH_TRANSFER_TYPE_t   transfer_type;
+    XMC_DMA_CH_PRIORITY_t        priority;
+    XMC_DMA_CH_SRC_HANDSHAKING_t src_handshaking;
+    uint8_t                      src_peripheral_request;
+    XMC_DMA_CH_DST_HANDSHAKING_t dst_handshaking;
+    uint8_t                      dst_peripheral_request;
+} XMC_DMA_CH_CONFIG_t;
+
+void XMC_DMA_Init(XMC_DMA_t* const dma);
+bool XMC_DMA_IsEnabled(const XMC_DMA_t* const dma);
+XMC_DMA_CH_STATUS_t XMC_DMA_CH_Init(XMC_DMA_t* const dma, const uint8_t channel,
+                                    const XMC_DMA_CH_CONFIG_t* const config);
+void XMC_DMA_CH_Enable(XMC_DMA_t* const dma, const uint8_t channel);
+void XMC_DMA_CH_Disable(XMC_DMA_t* const dma, const uint8_t channel);
+bool XMC_DMA_CH_IsEnabled(XMC_DMA_t* const dma, const uint8_t channel);
+void XMC_DMA_CH_SetSourceAddress(XMC_DMA_t* const dma, const uint8_t channel, uint32_t addr);
+void XMC_DMA_CH_SetBlockSize(XMC_DMA_t* const dma, const uint8_t channel, uint32_t block_size);
+void XMC_DMA_CH_EnableEvent(XMC_DMA_t* const dma, const uint8_t channel, const uint32_t event);
+void XMC_DMA_CH_DisableEvent(XMC_DMA_t* const dma, const uint8_t channel, const uint32_t event);
+void XMC_DMA_CH_SetEventHandler(XMC_DMA_t* const dma, const uint8_t channel,
+                                XMC_DMA_CH_EVENT_HANDLER_t event_handler);
+void XMC_DMA_IRQHandler(XMC_DMA_t* const dma);
@@ -0,0 +1,62 @@
+// Host mock of the XMC UART driver, see sim.c
+#pragma once
+
+#include "xmc_usic.h"
+
+#define XMC_UART_CH_OVERSAMPLING (16UL)
+
+typedef enum
+{
+    XMC_UART_CH_STATUS_OK,
+    XMC_UART_CH_STATUS_ERROR,
+    XMC_UART_CH_STATUS_BUSY
+} XMC_UART_CH_STATUS_t;
+
+typedef enum
+{
+    XMC_UART_CH_STATUS_FLAG_TRANSMISSION_IDLE              = 0x0001U,
+    XMC_UART_CH_STATUS_FLAG_RECEPTION_IDLE                 = 0x0002U,
+    XMC_UART_CH_STATUS_FLAG_SYNCHRONIZATION_BREAK_DETECTED = 0x0004U,
+    XMC_UART_CH_STATUS_FLAG_RECEIVER_NOISE_DETECTED        = 0x0020U,
+    XMC_UART_CH_STATUS_FLAG_FORMAT_ERROR_IN_STOP_BIT_0     = 0x0040U,
+    XMC_UART_CH_STATUS_FLAG_TRANSFER_STATUS_BUSY           = 0x0100U,
+    XMC_UART_CH_STATUS_FLAG_RECEIVER_START_INDICATION      = 0x0400U,
+    XMC_UART_CH_STATUS_FLAG_DATA_LOST_INDICATION           = 0x0800U,
+    XMC_UART_CH_STATUS_FLAG_TRANSMIT_SHIFT_INDICATION      = 0x1000U,
+    XMC_UART_CH_STATUS_FLAG_TRANSMIT_BUFFER_INDICATION     = 0x2000U,
+    XMC_UART_CH_STATUS_FLAG_RECEIVE_INDICATION             = 0x4000U,
+    XMC_UART_CH_STATUS_FLAG_ALTERNATIVE_RECEIVE_INDICATION = 0x8000U
+} XMC_UART_CH_STATUS_FLAG_t;
+
+typedef enum
+{
+    XMC_UART_CH_EVENT_RECEIVE_START       = 1U << 10U,
+    XMC_UART_CH_EVENT_DATA_LOST           = 1U << 11U,
+    XMC_UART_CH_EVENT_TRANSMIT_SHIFT      = 1U << 12U,
+    XMC_UART_CH_EVENT_TRANSMIT_BUFFER     = 1U << 13U,
+    XMC_UART_CH_EVENT_STANDARD_RECEIVE    = 1U << 14U,
+    XMC_UART_CH_EVENT_ALTERNATIVE_RECEIVE = 1U << 15U
+} XMC_UART_CH_EVENT_t;
+
+typedef enum
+{
+    XMC_UART_CH_INTERRUPT_NODE_POINTER_TRANSMIT_SHIFT    = 0,
+    XMC_UART_CH_INTERRUPT_NODE_POINTER_TRANSMIT_BUFFER   = 4,
+    XMC_UART_CH_INTERRUPT_NODE_POINTER_RECEIVE           = 8,
+    XMC_UART_CH_INTERRUPT_NODE_POINTER_ALTERNATE_RECEIVE = 12,
+    XMC_UART_CH_INTERRUPT_NODE_POINTER_PROTOCOL          = 16
+} XMC_UART_CH_INTERRUPT_NODE_POINTER_t;
+
+void XMC_UART_CH_Transmit(XMC_USIC_CH_t* const channel, const uint16_t data);
+uint16_t XMC_UART_CH_GetReceivedData(XMC_USIC_CH_t* const channel);
+uint32_t XMC_UART_CH_GetStatusFlag(XMC_USIC_CH_t* const channel);
+void XMC_UART_CH_ClearStatusFlag(XMC_USIC_CH_t* const channel, const uint32_t flag);
+void XMC_UART_CH_EnableEvent(XMC_USIC_CH_t* const channel, const uint32_t event);
+void XMC_UART_CH_DisableEvent(XMC_USIC_CH_t* const channel, const uint32_t event);
+void XMC_UART_CH_SelectInterruptNodePointer(
+    XMC_USIC_CH_t* const channel, const XMC_UART_CH_INTERRUPT_NODE_POINTER_t interrupt_node,
+    const uint32_t service_request);
+XMC_UART_CH_STATUS_t XMC_UART_CH_SetBaudrate(XMC_USIC_CH_t* const channel, uint32_t rate,
+                                             uint32_t oversampling);
+XMC_UART_CH_STATUS_t XMC_UART_CH_Stop(XMC_USIC_CH_t* const channel);
+void XMC_UART_CH_Start(XMC_USIC_CH_t* const channel);
@@ -0,0 +1,123 @@
+// Host mock of the XMC USIC driver, see sim.c
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "xmc_device.h"
+
+typedef struct
+{
+    volatile uint32_t CCR;
+    volatile uint32_t PSR;
+    volatile uint32_t PSCR;
+    volatile uint32_t TCSR;
+    volatile uint32_t FMR;
+    volatile uint32_t TBCTR;
+    volatile uint32_t RBCTR;
+    volatile uint32_t TRBSR;
+    volatile uint32_t OUTR;
+    volatile uint32_t RBUF;
+    volatile uint32_t BRG;
+    volatile uint32_t FDR;
+    volatile uint32_t INPR;
+    volatile uint32_t KSCFG;
+    volatile uint32_t CCFG;
+    volatile uint32_t TBUF[32];
+    volatile uint32_t IN[32];
+} XMC_USIC_CH_t;
+
+// Only XMC_USIC0_CH0 is simulated in full, the other channels record what they transmit
+extern XMC_USIC_CH_t sim_usic[6];
+#define XMC_USIC0_CH0                   (&sim_usic[0])
+#define XMC_USIC0_CH1                   (&sim_usic[1])
+#define USIC1                           1
+#define USIC2                           1
+#define XMC_USIC1_CH0                   (&sim_usic[2])
+#define XMC_USIC1_CH1                   (&sim_usic[3])
+#define XMC_USIC2_CH0                   (&sim_usic[4])
+#define XMC_USIC2_CH1                   (&sim_usic[5])
+
+#define USIC_CH_TBCTR_SIZE_Pos          (24U)
+#define USIC_CH_TBCTR_SIZE_Msk          (7UL << USIC_CH_TBCTR_SIZE_Pos)
+#define USIC_CH_TBCTR_LIMIT_Pos         (8U)
+#define USIC_CH_TBCTR_LIMIT_Msk         (0x3FUL << USIC_CH_TBCTR_LIMIT_Pos)
+#define USIC_CH_RBCTR_SIZE_Pos          (24U)
+#define USIC_CH_RBCTR_SIZE_Msk          (7UL << USIC_CH_RBCTR_SIZE_Pos)
+#define USIC_CH_RBCTR_LIMIT_Pos         (8U)
+#define USIC_CH_RBCTR_LIMIT_Msk         (0x3FUL << USIC_CH_RBCTR_LIMIT_Pos)
+#define USIC_CH_TRBSR_TBFLVL_Pos        (24U)
+#define USIC_CH_TRBSR_TBFLVL_Msk        (0x7FUL << USIC_CH_TRBSR_TBFLVL_Pos)
+#define USIC_CH_TRBSR_RBFLVL_Pos        (8U)
+#define USIC_CH_TRBSR_RBFLVL_Msk        (0x7FUL << USIC_CH_TRBSR_RBFLVL_Pos)
+#define USIC_CH_TRBSR_TFULL_Msk         (1UL << 12U)
+#define USIC_CH_TRBSR_TEMPTY_Msk        (1UL << 11U)
+#define USIC_CH_TRBSR_REMPTY_Msk        (1UL << 3U)
+#define USIC_CH_TRBSR_SRBI_Msk          (1UL)
+#define USIC_CH_TRBSR_STBI_Msk          (1UL << 8U)
+#define USIC_CH_FMR_SIO0_Msk            (1UL << 16U)
+#define USIC_CH_TCSR_TDV_Msk            (1UL << 7U)
+#define USIC_CH_PSR_ASCMode_RIF_Msk     (1UL << 14U)
+#define USIC_CH_BRG_DCTQ_Pos            (10U)
+#define USIC_CH_BRG_DCTQ_Msk            (0x1FUL << USIC_CH_BRG_DCTQ_Pos)
+
+typedef enum
+{
+    XMC_USIC_CH_TBUF_STATUS_IDLE = 0,
+    XMC_USIC_CH_TBUF_STATUS_BUSY = 1
+} XMC_USIC_CH_TBUF_STATUS_t;
+
+typedef enum
+{
+    XMC_USIC_CH_FIFO_DISABLED = 0,
+    XMC_USIC_CH_FIFO_SIZE_2WORDS,
+    XMC_USIC_CH_FIFO_SIZE_4WORDS,
+    XMC_USIC_CH_FIFO_SIZE_8WORDS,
+    XMC_USIC_CH_FIFO_SIZE_16WORDS,
+    XMC_USIC_CH_FIFO_SIZE_32WORDS,
+    XMC_USIC_CH_FIFO_SIZE_64WORDS
+} XMC_USIC_CH_FIFO_SIZE_t;
+
+#define XMC_USIC_CH_TXFIFO_EVENT_CONF_STANDARD  (1UL << 30U)
+#define XMC_USIC_CH_TXFIFO_EVENT_STANDARD       (1UL << 8U)
+#define XMC_USIC_CH_RXFIFO_EVENT_CONF_STANDARD  (1UL << 14U)
+#define XMC_USIC_CH_RXFIFO_EVENT_CONF_ALTERNATE (1UL << 15U)
+#define XMC_USIC_CH_RXFIFO_EVENT_STANDARD       (1UL)
+#define XMC_USIC_CH_RXFIFO_EVENT_ALTERNATE      (2UL)
+
+typedef enum
+{
+    XMC_USIC_CH_TXFIFO_INTERRUPT_NODE_POINTER_STANDARD  = 16,
+    XMC_USIC_CH_TXFIFO_INTERRUPT_NODE_POINTER_ALTERNATE = 19
+} XMC_USIC_CH_TXFIFO_INTERRUPT_NODE_POINTER_t;
+
+typedef enum
+{
+    XMC_USIC_CH_RXFIFO_INTERRUPT_NODE_POINTER_STANDARD  = 16,
+    XMC_USIC_CH_RXFIFO_INTERRUPT_NODE_POINTER_ALTERNATE = 19
+} XMC_USIC_CH_RXFIFO_INTERRUPT_NODE_POINTER_t;
+
+void XMC_USIC_CH_WriteTransmitBuffer(XMC_USIC_CH_t* const channel, const uint16_t data);
+XMC_USIC_CH_TBUF_STATUS_t XMC_USIC_CH_GetTransmitBufferStatus(XMC_USIC_CH_t* const channel);
+void XMC_USIC_CH_TriggerServiceRequest(XMC_USIC_CH_t* const channel,
+                                       const uint32_t service_request_line);
+void XMC_USIC_CH_TXFIFO_PutData(XMC_USIC_CH_t* const channel, const uint16_t data);
+bool XMC_USIC_CH_TXFIFO_IsFull(XMC_USIC_CH_t* const channel);
+bool XMC_USIC_CH_TXFIFO_IsEmpty(XMC_USIC_CH_t* const channel);
+uint32_t XMC_USIC_CH_TXFIFO_GetLevel(XMC_USIC_CH_t* const channel);
+void XMC_USIC_CH_TXFIFO_EnableEvent(XMC_USIC_CH_t* const channel, const uint32_t event);
+void XMC_USIC_CH_TXFIFO_DisableEvent(XMC_USIC_CH_t* const channel, const uint32_t event);
+void XMC_USIC_CH_TXFIFO_ClearEvent(XMC_USIC_CH_t* const channel, const uint32_t event);
+void XMC_USIC_CH_TXFIFO_Flush(XMC_USIC_CH_t* const channel);
+void XMC_USIC_CH_TXFIFO_SetInterruptNodePointer(
+    XMC_USIC_CH_t* const channel, const XMC_USIC_CH_TXFIFO_INTERRUPT_NODE_POINTER_t interrupt_node,
+    const uint32_t service_request);
+bool XMC_USIC_CH_RXFIFO_IsEmpty(XMC_USIC_CH_t* const channel);
+uint16_t XMC_USIC_CH_RXFIFO_GetData(XMC_USIC_CH_t* const channel);
+uint32_t XMC_USIC_CH_RXFIFO_GetLevel(XMC_USIC_CH_t* const channel);
+void XMC_USIC_CH_RXFIFO_EnableEvent(XMC_USIC_CH_t* const channel, const uint32_t event);
+void XMC_USIC_CH_RXFIFO_DisableEvent(XMC_USIC_CH_t* const channel, const uint32_t event);
+uint32_t XMC_USIC_CH_RXFIFO_GetEvent(XMC_USIC_CH_t* const channel);
+void XMC_USIC_CH_RXFIFO_ClearEvent(XMC_USIC_CH_t* const channel, const uint32_t event);
+void XMC_USIC_CH_RXFIFO_SetInterruptNodePointer(
+    XMC_USIC_CH_t* const channel, const XMC_USIC_CH_RXFIFO_INTERRUPT_NODE_POINTER_t interrupt_node,
+    const uint32_t service_request);
@@ -0,0 +1,9 @@
+// Host mock of the IAR low level I/O interface
+#pragma once
+
+#include <stddef.h>
+
+#define _LLIO_STDIN     0
+#define _LLIO_STDOUT    1
+#define _LLIO_STDERR    2
+#define _LLIO_ERROR     ((size_t)-1)
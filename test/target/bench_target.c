@@ -0,0 +1,153 @@
+// On-target throughput and printf latency of every transmit mode.
+//
+// Build this file into a board application that defines CY_RETARGET_IO_STATS and call
+// bench_target_run() after the pins and the UART protocol of the channel are set up, in place of
+// cy_retarget_io_init(). It prints the workload of ../bench_throughput.c with printf in the
+// polling, polling FIFO, interrupt, interrupt FIFO and, given a DMA configuration, DMA modes and
+// then reports for each mode the bytes per second, the core clock cycles per byte and the
+// latency percentiles of the write calls. stdout is line buffered, so every printf makes one
+// write call.
+//
+// The elapsed time is taken from cy_retarget_io_get_timestamp(), which the application must
+// override to return milliseconds, e.g. from its SysTick handler or the RTOS tick. The
+// percentiles come from the power of two bins of cy_retarget_io_stats_t::write_latency, each one
+// is the upper end of its bin. The FIFO modes use the first 16 words of the FIFO buffer of the
+// channel.
+#include <stdio.h>
+#include <string.h>
+#include "cy_retarget_io.h"
+
+#if !defined(CY_RETARGET_IO_STATS)
+#error "bench_target.c needs CY_RETARGET_IO_STATS"
+#endif
+
+#define BENCH_LINES (2000)
+
+typedef enum
+{
+    MODE_POLLING,
+    MODE_POLLING_FIFO,
+    MODE_INTERRUPT,
+    MODE_INTERRUPT_FIFO,
+    MODE_DMA,
+    MODE_COUNT
+} tx_mode_t;
+
+typedef struct
+{
+    uint32_t               elapsed_ms;
+    cy_retarget_io_stats_t stats;
+} bench_result_t;
+
+static const char* const mode_names[MODE_COUNT] =
+{
+    "polling", "polling FIFO", "interrupt", "interrupt FIFO", "DMA"
+};
+
+static uint8_t        tx_buffer[1024];
+static char           stdout_buffer[80];
+static bench_result_t results[MODE_COUNT];
+
+
+static cy_rslt_t init(XMC_USIC_CH_t* channel, tx_mode_t mode, const cy_retarget_io_dma_cfg_t* dma)
+{
+    cy_retarget_io_config_t config;
+
+    if ((mode == MODE_POLLING_FIFO) || (mode == MODE_INTERRUPT_FIFO))
+    {
+        XMC_USIC_CH_TXFIFO_Configure(channel, 0U, XMC_USIC_CH_FIFO_SIZE_16WORDS, 1U);
+    }
+    else
+    {
+        XMC_USIC_CH_TXFIFO_Configure(channel, 0U, XMC_USIC_CH_FIFO_DISABLED, 0U);
+    }
+    (void)memset(&config, 0, sizeof(config));
+    config.channel            = channel;
+    config.stdio_buffering    = CY_RETARGET_IO_STDIO_LINE;
+    config.stdout_buffer      = stdout_buffer;
+    config.stdout_buffer_size = sizeof(stdout_buffer);
+    if (mode >= MODE_INTERRUPT)
+    {
+        config.tx_buffer      = tx_buffer;
+        config.tx_buffer_size = sizeof(tx_buffer);
+    }
+    if (mode == MODE_DMA)
+    {
+        config.dma = *dma;
+    }
+    return cy_retarget_io_init_cfg(&config);
+}
+
+
+static uint32_t percentile(const cy_retarget_io_stats_t* stats, uint32_t pct)
+{
+    uint32_t rank  = ((stats->write_calls * pct) + 99U) / 100U;
+    uint32_t count = 0U;
+    uint32_t bin   = 0U;
+    while (bin < (CY_RETARGET_IO_STATS_LATENCY_BINS - 1U))
+    {
+        count += stats->write_latency[bin];
+        if (count >= rank)
+        {
+            break;
+        }
+        ++bin;
+    }
+    return (bin == 0U) ? 0U : ((1UL << bin) - 1U);
+}
+
+
+static void run(XMC_USIC_CH_t* channel, tx_mode_t mode, const cy_retarget_io_dma_cfg_t* dma)
+{
+    bench_result_t* result = &results[mode];
+    uint32_t        start;
+
+    if (init(channel, mode, dma) != CY_RSLT_SUCCESS)
+    {
+        return;
+    }
+    start = cy_retarget_io_get_timestamp();
+    for (int i = 0; i < BENCH_LINES; i++)
+    {
+        (void)printf("[%6u] sensor %d: temp=%d.%d C, state=%s\n", (unsigned)(i * 37), i % 4,
+                     20 + (i % 7), i % 10, ((i % 9) != 0) ? "OK" : "WARN");
+    }
+    (void)cy_retarget_io_flush(1000000U);
+    result->elapsed_ms = cy_retarget_io_get_timestamp() - start;
+    cy_retarget_io_get_stats(&result->stats);
+    cy_retarget_io_deinit();
+}
+
+
+/** Runs the benchmark on channel and prints the report in the polling mode. dma selects the DMA
+ * channel and request line of the DMA mode, NULL skips it. */
+void bench_target_run(XMC_USIC_CH_t* channel, const cy_retarget_io_dma_cfg_t* dma)
+{
+    for (int mode = 0; mode < (int)MODE_COUNT; mode++)
+    {
+        if ((mode != (int)MODE_DMA) || (dma != NULL))
+        {
+            run(channel, (tx_mode_t)mode, dma);
+        }
+    }
+
+    (void)init(channel, MODE_POLLING, NULL);
+    (void)printf("%d lines per mode, latency in cycles\n", BENCH_LINES);
+    (void)printf("%-15s %10s %10s %8s %8s %8s %8s\n", "mode", "bytes/s", "cycles/B", "p50",
+                 "p90", "p99", "max");
+    for (int mode = 0; mode < (int)MODE_COUNT; mode++)
+    {
+        const cy_retarget_io_stats_t* stats = &results[mode].stats;
+        if ((stats->bytes_written == 0U) || (results[mode].elapsed_ms == 0U))
+        {
+            continue;
+        }
+        (void)printf("%-15s %10lu %10lu %8lu %8lu %8lu %8lu\n", mode_names[mode],
+                     (unsigned long)(((uint64_t)stats->bytes_written * 1000U) /
+                                     results[mode].elapsed_ms),
+                     (unsigned long)(stats->write_cycles / stats->bytes_written),
+                     (unsigned long)percentile(stats, 50U), (unsigned long)percentile(stats, 90U),
+                     (unsigned long)percentile(stats, 99U), (unsigned long)percentile(stats, 100U));
+    }
+    (void)fflush(stdout);
+}
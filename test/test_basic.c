@@ -0,0 +1,169 @@
+// Every transmit mode sends the data unchanged, and the receive paths deliver what arrives
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+
+static uint8_t    tx_buffer[64];
+static uint8_t    rx_buffer[16];
+static const char big[] =
+    "The quick brown fox jumps over the lazy dog 0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ "
+    "abcdefghijklmnopqrstuvwxyz!!\n";
+
+
+static void write_str(const char* str)
+{
+    assert(_write(1, str, (int)strlen(str)) == (int)strlen(str));
+}
+
+
+static void tx_modes(void)
+{
+    cy_retarget_io_config_t config;
+    char                    expected[512];
+
+    sim_reset();
+    assert(cy_retarget_io_init(XMC_USIC0_CH0) == CY_RSLT_SUCCESS);
+    write_str(big);
+    sim_expect("polling", big, strlen(big));
+    cy_retarget_io_deinit();
+
+    sim_reset();
+    XMC_USIC0_CH0->TBCTR = (uint32_t)XMC_USIC_CH_FIFO_SIZE_8WORDS << USIC_CH_TBCTR_SIZE_Pos;
+    assert(cy_retarget_io_init(XMC_USIC0_CH0) == CY_RSLT_SUCCESS);
+    write_str(big);
+    sim_expect("polling fifo", big, strlen(big));
+    cy_retarget_io_deinit();
+
+    sim_reset();
+    assert(cy_retarget_io_init_buffered(XMC_USIC0_CH0, tx_buffer, sizeof(tx_buffer)) ==
+           CY_RSLT_SUCCESS);
+    write_str(big);
+    write_str(big);
+    snprintf(expected, sizeof(expected), "%s%s", big, big);
+    sim_expect("interrupt", expected, strlen(expected));
+    cy_retarget_io_deinit();
+
+    sim_reset();
+    XMC_USIC0_CH0->TBCTR = (uint32_t)XMC_USIC_CH_FIFO_SIZE_16WORDS << USIC_CH_TBCTR_SIZE_Pos;
+    assert(cy_retarget_io_init_buffered(XMC_USIC0_CH0, tx_buffer, sizeof(tx_buffer)) ==
+           CY_RSLT_SUCCESS);
+    write_str(big);
+    sim_drain();
+    write_str("x");
+    write_str(big);
+    snprintf(expected, sizeof(expected), "%s%s%s", big, "x", big);
+    sim_expect("fifo", expected, strlen(expected));
+    cy_retarget_io_deinit();
+
+    sim_reset();
+    memset(&config, 0, sizeof(config));
+    config.channel             = XMC_USIC0_CH0;
+    config.tx_buffer           = tx_buffer;
+    config.tx_buffer_size      = sizeof(tx_buffer);
+    config.dma.enable          = true;
+    config.dma.channel         = 2U;
+    config.dma.service_request = 1U;
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+    write_str(big);
+    sim_drain();
+    write_str("y");
+    write_str(big);
+    snprintf(expected, sizeof(expected), "%s%s%s", big, "y", big);
+    sim_expect("dma", expected, strlen(expected));
+    cy_retarget_io_deinit();
+}
+
+
+static void rx(void)
+{
+    cy_retarget_io_config_t      config;
+    cy_retarget_io_rx_overruns_t overruns;
+    const char*                  in = "hello\nworld and more much longer text";
+    char                         line[64];
+    int                          len;
+
+    sim_reset();
+    memset(&config, 0, sizeof(config));
+    config.channel        = XMC_USIC0_CH0;
+    config.rx_buffer      = rx_buffer;
+    config.rx_buffer_size = sizeof(rx_buffer);
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+    for (const char* p = in; *p != '\0'; p++)
+    {
+        sim_rx((uint8_t)*p);
+    }
+    len = _read(0, line, sizeof(line));
+    assert((len == 6) && (memcmp(line, "hello\n", 6U) == 0));
+    (void)cy_retarget_io_read(line, sizeof(line), 0U, CY_RETARGET_IO_READ_RAW);
+    cy_retarget_io_get_rx_overruns(&overruns);
+    assert(overruns.ring > 0U);
+    cy_retarget_io_deinit();
+    printf("ok rx\n");
+
+    sim_reset();
+    XMC_USIC0_CH0->RBCTR = (uint32_t)XMC_USIC_CH_FIFO_SIZE_8WORDS << USIC_CH_RBCTR_SIZE_Pos;
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+    for (const char* p = "ab\r"; *p != '\0'; p++)
+    {
+        sim_rx((uint8_t)*p);
+    }
+    len = _read(0, line, sizeof(line));
+    assert((len == 3) && (memcmp(line, "ab\r", 3U) == 0));
+    cy_retarget_io_deinit();
+    printf("ok rx fifo\n");
+}
+
+
+// A failed initialization leaves nothing enabled or allocated and can be retried
+static void init_failure(void)
+{
+    cy_retarget_io_config_t config;
+
+    sim_reset();
+    memset(&config, 0, sizeof(config));
+    config.channel        = XMC_USIC0_CH0;
+    config.tx_buffer      = tx_buffer;
+    config.tx_buffer_size = sizeof(tx_buffer);
+    config.rx_buffer      = rx_buffer;
+    config.rx_buffer_size = sizeof(rx_buffer);
+#if defined(CY_RTOS_AWARE)
+    sim_semaphore_init_fail = 2;
+    assert(cy_retarget_io_init_cfg(&config) != CY_RSLT_SUCCESS);
+    assert(sim_semaphores == 0);
+    assert(sim_irq_enabled(USIC0_0_IRQn) == 0);
+#endif
+#if (UC_FAMILY == XMC4)
+    // The DMA cannot be used with the transmit FIFO
+    sim_reset();
+    XMC_USIC0_CH0->TBCTR = (uint32_t)XMC_USIC_CH_FIFO_SIZE_8WORDS << USIC_CH_TBCTR_SIZE_Pos;
+    config.dma.enable          = true;
+    config.dma.channel         = 2U;
+    config.dma.service_request = 1U;
+    assert(cy_retarget_io_init_cfg(&config) == CY_RETARGET_IO_RSLT_UNSUPPORTED);
+    assert(sim_semaphores == 0);
+    assert(sim_irq_enabled(USIC0_0_IRQn) == 0);
+    config.dma.enable = false;
+#endif
+
+    // Retrying with the same configuration succeeds
+    sim_reset();
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+    assert(sim_irq_enabled(USIC0_0_IRQn) != 0);
+    write_str("buffered\n");
+    sim_expect("retry", "buffered\n", 9U);
+    cy_retarget_io_deinit();
+    assert(sim_semaphores == 0);
+    printf("ok init failure\n");
+}
+
+
+int main(void)
+{
+    setvbuf(stdout, NULL, _IONBF, 0);
+    tx_modes();
+    rx();
+    init_failure();
+    printf("ALL OK\n");
+    return 0;
+}
@@ -0,0 +1,133 @@
+// The capture mode keeps the newest output in RAM until cy_retarget_io_dump() sends it
+#define _GNU_SOURCE
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+
+static uint8_t tx_buffer[64];
+static uint8_t capture[100];
+
+
+static void config_init(cy_retarget_io_config_t* config, bool buffered)
+{
+    memset(config, 0, sizeof(*config));
+    config->channel             = XMC_USIC0_CH0;
+    config->capture_buffer      = capture;
+    config->capture_buffer_size = sizeof(capture);
+    if (buffered)
+    {
+        config->tx_buffer      = tx_buffer;
+        config->tx_buffer_size = sizeof(tx_buffer);
+    }
+}
+
+
+static void run(bool buffered)
+{
+    cy_retarget_io_config_t config;
+    char                    line[32];
+    size_t                  used;
+    size_t                  dumped;
+
+    sim_reset();
+    config_init(&config, buffered);
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+    for (int i = 0; i < 40; i++)
+    {
+        int len = snprintf(line, sizeof(line), "line %02d\n", i);
+        _write(((i & 1) != 0) ? 2 : 1, line, len);
+    }
+    sim_force_ipsr(20U);
+    _write(1, "isr\n", 4);
+    sim_force_ipsr(0U);
+    cy_retarget_io_printf("p%d\n", 7);
+    sim_drain();
+    assert(sim_out_len == 0U);
+
+    used = (cy_retarget_io_capture.head + cy_retarget_io_capture.size -
+            cy_retarget_io_capture.tail) % cy_retarget_io_capture.size;
+    assert(used == sizeof(capture) - 1U);
+    dumped = cy_retarget_io_dump();
+    assert(dumped == used);
+    sim_drain();
+    assert(sim_out_len == dumped);
+    assert(cy_retarget_io_capture.head == cy_retarget_io_capture.tail);
+#if defined(CY_RETARGET_IO_LINE_STAMP)
+    assert(memmem(&sim_out[sim_out_len - 4U], 4U, "p7", 2U) != NULL);
+#elif defined(CY_RETARGET_IO_CONVERT_LF_TO_CRLF)
+    assert(memcmp(&sim_out[sim_out_len - 10U], "\nisr\r\np7\r\n", 10U) == 0);
+#else
+    assert(memcmp(&sim_out[sim_out_len - 15U], "line 39\nisr\np7\n", 15U) == 0);
+#endif
+    assert(cy_retarget_io_dump() == 0U);
+    _write(1, "again\n", 6);
+    sim_drain();
+    assert(sim_out_len == dumped);
+    assert(cy_retarget_io_dump() >= 6U);
+    sim_drain();
+    cy_retarget_io_deinit();
+    assert(cy_retarget_io_dump() == 0U);
+    printf("ok capture buffered=%d dumped %zu\n", buffered, dumped);
+}
+
+
+// Long writes are captured in chunks, so interrupts are masked only briefly
+static void chunks(void)
+{
+    cy_retarget_io_config_t config;
+    char                    text[90];
+    int                     masks;
+    int                     short_masks;
+
+    sim_reset();
+    config_init(&config, false);
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+    memset(text, 'c', sizeof(text));
+    masks = sim_irq_masks;
+    _write(1, text, 40);
+    short_masks = sim_irq_masks - masks;
+    masks       = sim_irq_masks;
+    _write(1, text, sizeof(text));
+    assert((sim_irq_masks - masks) > short_masks);
+    assert(cy_retarget_io_dump() == (sizeof(capture) - 1U));
+    sim_drain();
+    cy_retarget_io_deinit();
+    printf("ok chunks\n");
+}
+
+
+// After a panic flush new output goes straight out and the history stays for the dump
+static void panic(void)
+{
+    cy_retarget_io_config_t config;
+    size_t                  sent;
+
+    sim_reset();
+    config_init(&config, true);
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+    _write(1, "before\n", 7);
+    cy_retarget_io_panic_flush();
+    _write(1, "fault\n", 6);
+    sim_drain();
+    assert(memmem(sim_out, sim_out_len, "fault", 5U) != NULL);
+    assert(memmem(sim_out, sim_out_len, "before", 6U) == NULL);
+    sent = sim_out_len;
+    assert(cy_retarget_io_dump() >= 7U);
+    sim_drain();
+    assert(sim_out_len > sent);
+    printf("ok panic\n");
+}
+
+
+int main(void)
+{
+    setvbuf(stdout, NULL, _IONBF, 0);
+    run(false);
+    run(true);
+    chunks();
+    // The panic state is terminal, so this runs last
+    panic();
+    printf("ALL OK\n");
+    return 0;
+}
@@ -0,0 +1,331 @@
+// CY_RETARGET_IO_COMPRESS frames decode back to the written data, and a decoder resyncs after
+// a corrupted byte at the next reset frame
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+static uint8_t tx_buffer[512];
+static uint8_t high_buffer[128];
+static uint8_t src[1 << 18];
+static size_t  src_len;
+static uint8_t dec[1 << 18];
+static size_t  dec_len;
+static int     frames;
+static int     resets;
+static int     bad;
+
+
+// Decodes the wire format. With strict set any protocol problem fails the test.
+static void decode(const uint8_t* in, size_t len, bool strict)
+{
+    int    seq         = -1;
+    long   history     = -1;
+    bool   synced      = false;
+    size_t since_reset = 0U;
+    size_t i           = 0U;
+
+    dec_len = 0U;
+    frames  = 0;
+    resets  = 0;
+    bad     = 0;
+    while (i < len)
+    {
+        unsigned       flags;
+        unsigned       size;
+        uint8_t        sum1 = 0U;
+        uint8_t        sum2 = 0U;
+        const uint8_t* p;
+        const uint8_t* end;
+
+        if (in[i] != CY_RETARGET_IO_COMPRESS_MARKER)
+        {
+            assert(!strict && "byte outside a frame");
+            i++;
+            continue;
+        }
+        if (i + 3U > len)
+        {
+            break;
+        }
+        flags = in[i + 1U];
+        size  = in[i + 2U];
+        if (i + 5U + size > len)
+        {
+            assert(!strict);
+            break;
+        }
+        for (size_t k = i + 1U; k < i + 3U + size; k++)
+        {
+            sum1 += in[k];
+            sum2 += sum1;
+        }
+        if ((sum1 != in[i + 3U + size]) || (sum2 != in[i + 4U + size]))
+        {
+            assert(!strict);
+            bad++;
+            synced = false;
+            i++;
+            continue;
+        }
+        if ((seq >= 0) && ((int)(flags & 0x7FU) != ((seq + 1) & 0x7F)))
+        {
+            assert(!strict);
+            synced = false;
+        }
+        seq = (int)(flags & 0x7FU);
+        if ((flags & 0x80U) != 0U)
+        {
+            synced      = true;
+            history     = 0;
+            since_reset = 0U;
+            resets++;
+        }
+        frames++;
+        since_reset++;
+        assert(since_reset <= CY_RETARGET_IO_COMPRESS_SYNC_FRAMES);
+        assert(size <= 242U);
+        if (!synced)
+        {
+            i += 5U + size;
+            continue;
+        }
+        p   = &in[i + 3U];
+        end = p + size;
+        while (p < end)
+        {
+            unsigned token = *p++;
+            if (token < 0x80U)
+            {
+                for (unsigned k = 0U; k <= token; k++)
+                {
+                    assert(p < end);
+                    dec[dec_len++] = *p++;
+                    history++;
+                }
+            }
+            else
+            {
+                unsigned distance;
+                unsigned length = ((token >> 4) & 7U) + 3U;
+
+                assert(p < end);
+                distance = (((token & 15U) << 8) | *p++) + 1U;
+                if (((token >> 4) & 7U) == 7U)
+                {
+                    assert(p < end);
+                    length += *p++;
+                }
+                assert(distance <= CY_RETARGET_IO_COMPRESS_WINDOW);
+                assert((long)distance <= history);
+                for (unsigned k = 0U; k < length; k++)
+                {
+                    dec[dec_len] = dec[dec_len - distance];
+                    dec_len++;
+                    history++;
+                }
+            }
+        }
+        i += 5U + size;
+    }
+}
+
+
+static void put(int fd, const void* ptr, size_t len)
+{
+    memcpy(&src[src_len], ptr, len);
+    src_len += len;
+    assert(_write(fd, ptr, (int)len) == (int)len);
+}
+
+
+static void log_lines(int fd, int lines)
+{
+    char buf[128];
+
+    for (int i = 0; i < lines; i++)
+    {
+        int len = snprintf(buf, sizeof(buf), "[%6u] sensor %d: temp=%d.%d C, state=%s\n",
+                           (unsigned)(i * 37), i % 4, 20 + (i % 7), i % 10,
+                           ((i % 9) != 0) ? "OK" : "WARN");
+        put(fd, buf, (size_t)len);
+    }
+}
+
+
+static void check(const char* what, bool compressible)
+{
+    double ratio;
+
+    sim_drain();
+    while (cy_retarget_io_is_tx_active())
+    {
+        sim_drain();
+    }
+    decode(sim_out, sim_out_len, true);
+    if ((dec_len != src_len) || (memcmp(dec, src, src_len) != 0))
+    {
+        printf("FAIL %s: decoded %zu of %zu bytes\n", what, dec_len, src_len);
+        exit(1);
+    }
+    ratio = (double)src_len / (double)sim_out_len;
+    printf("ok %s: %zu bytes, %zu on the wire, ratio %.2f, %d frames, %d resets\n", what,
+           src_len, sim_out_len, ratio, frames, resets);
+    if (compressible)
+    {
+        assert(ratio > 2.0);
+    }
+}
+
+
+static void start(bool dma, bool fifo, bool high)
+{
+    cy_retarget_io_config_t config;
+
+    sim_reset();
+    src_len = 0U;
+    if (fifo)
+    {
+        XMC_USIC0_CH0->TBCTR = (uint32_t)XMC_USIC_CH_FIFO_SIZE_16WORDS << USIC_CH_TBCTR_SIZE_Pos;
+    }
+    memset(&config, 0, sizeof(config));
+    config.channel        = XMC_USIC0_CH0;
+    config.tx_buffer      = tx_buffer;
+    config.tx_buffer_size = sizeof(tx_buffer);
+    if (high)
+    {
+        config.tx_high_buffer      = high_buffer;
+        config.tx_high_buffer_size = sizeof(high_buffer);
+    }
+    if (dma)
+    {
+        config.dma.enable          = true;
+        config.dma.channel         = 2U;
+        config.dma.service_request = 1U;
+    }
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+}
+
+
+static void modes(void)
+{
+    static const char* names[] = { "interrupt", "fifo", "dma" };
+    char               what[64];
+    char               buf[800];
+
+    for (int mode = 0; mode < ((UC_FAMILY == XMC4) ? 3 : 2); mode++)
+    {
+        bool dma  = (mode == 2);
+        bool fifo = (mode == 1);
+
+        start(dma, fifo, false);
+        log_lines(1, 400);
+        snprintf(what, sizeof(what), "%s log", names[mode]);
+        check(what, true);
+#if defined(CY_RETARGET_IO_STATS)
+        {
+            cy_retarget_io_stats_t stats;
+            cy_retarget_io_get_stats(&stats);
+            assert((stats.tx_compress_in == src_len) && (stats.tx_compress_out == sim_out_len));
+        }
+#endif
+        cy_retarget_io_deinit();
+
+        // Incompressible data with every byte value, the marker included
+        start(dma, fifo, false);
+        srand(7U);
+        for (int k = 0; k < 30; k++)
+        {
+            for (int j = 0; j < 97; j++)
+            {
+                buf[j] = (char)rand();
+            }
+            put(1, buf, 97U);
+        }
+        snprintf(what, sizeof(what), "%s random", names[mode]);
+        check(what, false);
+        cy_retarget_io_deinit();
+
+        // Long runs: matches beyond the extended length and overlapping copies
+        start(dma, fifo, false);
+        memset(buf, '=', sizeof(buf));
+        put(1, buf, sizeof(buf));
+        for (size_t j = 0U; j < sizeof(buf); j++)
+        {
+            buf[j] = (char)('a' + (j % 3U));
+        }
+        put(1, buf, sizeof(buf));
+        snprintf(what, sizeof(what), "%s runs", names[mode]);
+        check(what, false);
+        cy_retarget_io_deinit();
+
+        start(dma, fifo, true);
+        log_lines(2, 100);
+        snprintf(what, sizeof(what), "%s high lane", names[mode]);
+        check(what, true);
+        cy_retarget_io_deinit();
+
+        // One short line at a time with the line idle in between
+        start(dma, fifo, false);
+        for (int k = 0; k < 60; k++)
+        {
+            int len = snprintf(buf, sizeof(buf), "tick %d\n", k);
+            put(1, buf, (size_t)len);
+            sim_drain();
+        }
+        snprintf(what, sizeof(what), "%s trickle", names[mode]);
+        check(what, false);
+        cy_retarget_io_deinit();
+    }
+}
+
+
+static void resync(void)
+{
+    static uint8_t copy[1 << 20];
+    static uint8_t good[1 << 18];
+    size_t         good_len;
+    size_t         len;
+
+    start(false, false, false);
+    log_lines(1, 2000);
+    check("resync base", true);
+    len = sim_out_len;
+    memcpy(copy, sim_out, len);
+    decode(copy, len, true);
+    memcpy(good, dec, dec_len);
+    good_len = dec_len;
+    copy[len / 10U] ^= 0x55U;
+    decode(copy, len, false);
+    assert((bad >= 1) || (dec_len < good_len));
+    // What is decoded after the loss is the tail of the original
+    assert(dec_len > good_len / 2U);
+    assert(memcmp(&dec[dec_len - 1000U], &good[good_len - 1000U], 1000U) == 0);
+    cy_retarget_io_deinit();
+    printf("ok resync: %zu of %zu bytes lost\n", good_len - dec_len, good_len);
+}
+
+
+int main(void)
+{
+    setvbuf(stdout, NULL, _IONBF, 0);
+    modes();
+
+    // The panic flush drains the ring through the encoder, later output is plain
+    start(false, true, false);
+    sim_tick_masked = 1;
+    log_lines(1, 10);
+    cy_retarget_io_panic_flush();
+    assert(!cy_retarget_io_is_tx_active());
+    check("panic", false);
+    put(1, "plain\n", 6U);
+    sim_drain();
+    assert(memcmp(&sim_out[sim_out_len - 6U], "plain\n", 6U) == 0);
+    sim_tick_masked = 0;
+    cy_retarget_io_deinit();
+
+    resync();
+    printf("ALL OK\n");
+    return 0;
+}
@@ -0,0 +1,70 @@
+// CY_RETARGET_IO_CONVERT_LF_TO_CRLF inserts CR before every LF not already preceded by one,
+// also across write calls and ring wraps
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+static uint8_t tx_buffer[40];
+static char    ref[100000];
+static size_t  ref_len;
+static char    ref_prev;
+
+
+static void ref_write(const char* ptr, size_t len)
+{
+    for (size_t i = 0U; i < len; i++)
+    {
+        if ((ptr[i] == '\n') && (ref_prev != '\r'))
+        {
+            ref[ref_len++] = '\r';
+        }
+        ref[ref_len++] = ptr[i];
+        ref_prev       = ptr[i];
+    }
+}
+
+
+static void run(bool buffered)
+{
+    static char buf[200];
+
+    sim_reset();
+    ref_len  = 0U;
+    ref_prev = '\0';
+    if (buffered)
+    {
+        assert(cy_retarget_io_init_buffered(XMC_USIC0_CH0, tx_buffer, sizeof(tx_buffer)) ==
+               CY_RSLT_SUCCESS);
+    }
+    else
+    {
+        assert(cy_retarget_io_init(XMC_USIC0_CH0) == CY_RSLT_SUCCESS);
+    }
+    srand(buffered ? 2U : 1U);
+    for (int k = 0; k < 300; k++)
+    {
+        int len    = rand() % 60;
+        int offset = rand() % 8;
+        for (int i = 0; i < len; i++)
+        {
+            int r = rand() % 10;
+            buf[offset + i] = (r == 0) ? '\n' : ((r == 1) ? '\r' : (char)('a' + (rand() % 26)));
+        }
+        _write(1, &buf[offset], len);
+        ref_write(&buf[offset], (size_t)len);
+    }
+    sim_expect(buffered ? "crlf buffered" : "crlf polling", ref, ref_len);
+    cy_retarget_io_deinit();
+}
+
+
+int main(void)
+{
+    setvbuf(stdout, NULL, _IONBF, 0);
+    run(false);
+    run(true);
+    printf("ALL OK\n");
+    return 0;
+}
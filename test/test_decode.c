@@ -0,0 +1,81 @@
+// tools/retarget_decode.py decodes log records, binary line stamps, frames and compressed output.
+//
+// Writes the output of the polling and the buffered mode to the file argv[1] and the text the
+// decoder must make of it, given the ELF file of this program, to the file argv[2]. decode.cmake
+// runs the decoder and compares the two.
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+
+#define STAMP       "00c0ffee "
+
+static uint8_t tx_buffer[256];
+static char    expected[4096];
+static size_t  expected_len;
+
+
+uint32_t cy_retarget_io_get_timestamp(void)
+{
+    return 0x00C0FFEEU;
+}
+
+
+static void expect(const char* text)
+{
+    size_t len = strlen(text);
+    assert((expected_len + len) < sizeof(expected));
+    memcpy(&expected[expected_len], text, len);
+    expected_len += len;
+}
+
+
+// The same output in both modes, the frame payload holds zero bytes and the compress marker
+static void output(const char* mode)
+{
+    static const uint8_t payload[] = { 0x01U, 0x00U, 0xFDU, 0x00U, 0xFFU };
+    char line[64];
+
+    (void)snprintf(line, sizeof(line), "%s mode\n", mode);
+    _write(1, line, (int)strlen(line));
+    expect(STAMP);
+    expect(line);
+    CY_RETARGET_IO_LOG("log %d %u %#x %-4s| %05d %c\n", -7, 4000000000U, 0xFDU,
+                       (uint32_t)(uintptr_t)"arg", -42, 'z');
+    expect(STAMP "log -7 4000000000 0xfd arg | -0042 z\n");
+    assert(cy_retarget_io_write_frame(payload, sizeof(payload)) == CY_RSLT_SUCCESS);
+    expect("<frame 5: 0100fd00ff>");
+    for (int i = 0; i < 8; i++)
+    {
+        (void)snprintf(line, sizeof(line), "repeated line %d of the %s mode\n", i, mode);
+        _write(1, line, (int)strlen(line));
+        expect(STAMP);
+        expect(line);
+    }
+    sim_drain();
+}
+
+
+int main(int argc, char** argv)
+{
+    assert(argc == 3);
+    setvbuf(stdout, NULL, _IONBF, 0);
+    sim_reset();
+    assert(cy_retarget_io_init(XMC_USIC0_CH0) == CY_RSLT_SUCCESS);
+    output("polling");
+    cy_retarget_io_deinit();
+
+    assert(cy_retarget_io_init_buffered(XMC_USIC0_CH0, tx_buffer, sizeof(tx_buffer)) ==
+           CY_RSLT_SUCCESS);
+    output("buffered");
+    cy_retarget_io_deinit();
+
+    FILE* f = fopen(argv[1], "wb");
+    assert((f != NULL) && (fwrite(sim_out, 1U, sim_out_len, f) == sim_out_len));
+    assert(fclose(f) == 0);
+    f = fopen(argv[2], "wb");
+    assert((f != NULL) && (fwrite(expected, 1U, expected_len, f) == expected_len));
+    assert(fclose(f) == 0);
+    printf("ALL OK\n");
+    return 0;
+}
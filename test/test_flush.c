@@ -0,0 +1,229 @@
+// cy_retarget_io_flush() and cy_retarget_io_set_baudrate() wait for the data already written
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+
+#define LINE        "bulk trace line with some text\n"
+#define LINE_LEN    (sizeof(LINE) - 1U)
+
+static uint8_t tx_buffer[256];
+
+
+static void init(bool buffered)
+{
+    cy_retarget_io_config_t config;
+
+    sim_reset();
+    memset(&config, 0, sizeof(config));
+    config.channel = XMC_USIC0_CH0;
+    if (buffered)
+    {
+        config.tx_buffer      = tx_buffer;
+        config.tx_buffer_size = sizeof(tx_buffer);
+    }
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+}
+
+
+static void flush(void)
+{
+    init(true);
+    for (int i = 0; i < 6; i++)
+    {
+        _write(1, LINE, (int)LINE_LEN);
+    }
+    assert(cy_retarget_io_flush(0U) == CY_RETARGET_IO_RSLT_TIMEOUT);
+    assert(cy_retarget_io_flush(1000000U) == CY_RSLT_SUCCESS);
+    assert(sim_out_len == 6U * LINE_LEN);
+
+    sim_tx_stall = 1;
+    _write(1, "x\n", 2);
+    assert(cy_retarget_io_flush(1000U) == CY_RETARGET_IO_RSLT_TIMEOUT);
+    sim_tx_stall = 0;
+    assert(cy_retarget_io_flush(1000000U) == CY_RSLT_SUCCESS);
+    cy_retarget_io_deinit();
+    printf("ok flush\n");
+}
+
+
+// Sets up the counters like other code that starts while a flush waits: an RTOS takes SysTick,
+// a debugger uses another DWT function
+static void take_counters(void)
+{
+    SysTick->LOAD = 999U;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk |
+                    SysTick_CTRL_ENABLE_Msk;
+#if (UC_FAMILY == XMC4)
+    DWT->CTRL |= 2U;
+#endif
+    sim_on_tick = NULL;
+}
+
+
+// A wait only stops the counter it started, changes made meanwhile are kept
+static void counters(void)
+{
+    init(true);
+    SysTick->CTRL = 0U;
+#if (UC_FAMILY == XMC4)
+    DWT->CTRL = 0U;
+#endif
+    sim_tx_stall = 1;
+    _write(1, "x\n", 2);
+    sim_on_tick = take_counters;
+    assert(cy_retarget_io_flush(1000U) == CY_RETARGET_IO_RSLT_TIMEOUT);
+#if (UC_FAMILY == XMC4)
+    assert(DWT->CTRL == 2U);
+#else
+    assert((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) != 0U);
+#endif
+    sim_tx_stall = 0;
+    assert(cy_retarget_io_flush(1000000U) == CY_RSLT_SUCCESS);
+    cy_retarget_io_deinit();
+    printf("ok counters\n");
+}
+
+
+// A flush blocks the task or sleeps until the next interrupt instead of polling the ring buffer,
+// and a stalled line still ends it at the timeout. The SysTick interrupt of an RTOS tick, which
+// ends every sleep after a whole period, must not hide the time from the SysTick count of XMC1
+static void waits(void)
+{
+    init(true);
+#if !defined(CY_RTOS_AWARE)
+    SysTick->LOAD = 999U;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk |
+                    SysTick_CTRL_ENABLE_Msk;
+#endif
+    for (int i = 0; i < 6; i++)
+    {
+        _write(1, LINE, (int)LINE_LEN);
+    }
+#if defined(CY_RTOS_AWARE)
+    int* waits = &sim_semaphore_waits;
+#else
+    int* waits = &sim_wfi_count;
+#endif
+    int before = *waits;
+    assert(cy_retarget_io_flush(1000000U) == CY_RSLT_SUCCESS);
+    assert((sim_out_len == 6U * LINE_LEN) && (*waits > before));
+
+    sim_tx_stall = 1;
+    _write(1, "x\n", 2);
+    uint64_t start = sim_time;
+    assert(cy_retarget_io_flush(20000U) == CY_RETARGET_IO_RSLT_TIMEOUT);
+    // Within an RTOS tick of 10 ticks
+    assert((sim_time - start >= 190U) && (sim_time - start < 220U));
+    sim_tx_stall = 0;
+    assert(cy_retarget_io_flush(1000000U) == CY_RSLT_SUCCESS);
+    SysTick->CTRL = 0U;
+    cy_retarget_io_deinit();
+    printf("ok waits\n");
+}
+
+
+#if !defined(CY_RTOS_AWARE)
+// A core clock of no whole MHz still waits the whole timeout, 20 ms are 300 ticks at 1.5 MHz. The
+// RTOS time of the simulation has 1000 cycles per ms, so this only runs without an RTOS
+static void odd_clock(void)
+{
+    init(true);
+    SystemCoreClock = 1500000U;
+    sim_tx_stall    = 1;
+    _write(1, "x\n", 2);
+    uint64_t start = sim_time;
+    assert(cy_retarget_io_flush(20000U) == CY_RETARGET_IO_RSLT_TIMEOUT);
+    assert((sim_time - start >= 300U) && (sim_time - start < 330U));
+    sim_tx_stall    = 0;
+    SystemCoreClock = 1000000U;
+    assert(cy_retarget_io_flush(1000000U) == CY_RSLT_SUCCESS);
+    cy_retarget_io_deinit();
+    printf("ok flush odd clock\n");
+}
+#endif // if !defined(CY_RTOS_AWARE)
+
+
+static void baudrate(bool buffered)
+{
+    init(buffered);
+    for (int i = 0; i < 6; i++)
+    {
+        _write(1, LINE, (int)LINE_LEN);
+    }
+    assert(cy_retarget_io_set_baudrate(0U) == CY_RETARGET_IO_RSLT_BAD_PARAM);
+    assert(cy_retarget_io_set_baudrate(3000000U) == CY_RSLT_SUCCESS);
+    assert((sim_out_len == 6U * LINE_LEN) && !cy_retarget_io_is_tx_active());
+    _write(1, "fast\n", 5);
+    sim_drain();
+    assert(sim_out_len == 6U * LINE_LEN + 5U);
+    cy_retarget_io_deinit();
+    printf("ok baudrate buffered=%d\n", buffered);
+}
+
+
+#if defined(CY_RTOS_AWARE)
+static int   mutex_held;
+static void* region;
+
+
+static void note_mutex(void)
+{
+    mutex_held = sim_mutex_held;
+}
+
+
+// Runs the interrupt that holds the region
+static void commit_region(void)
+{
+    sim_force_ipsr(16U);
+    memcpy(region, "isr", 3U);
+    cy_retarget_io_commit(3U);
+    sim_force_ipsr(0U);
+}
+
+
+// The mutex is free while the ring drains, and a call made while an interrupt holds a region
+// waits until it is committed
+static void baudrate_unlocked(void)
+{
+    init(true);
+    for (int i = 0; i < 6; i++)
+    {
+        _write(1, LINE, (int)LINE_LEN);
+    }
+    mutex_held = -1;
+    sim_switch = note_mutex;
+    assert(cy_retarget_io_set_baudrate(115200U) == CY_RSLT_SUCCESS);
+    assert((mutex_held == 0) && (sim_mutex_held == 0) && (sim_out_len == 6U * LINE_LEN));
+
+    sim_force_ipsr(16U);
+    assert(cy_retarget_io_reserve(3U, &region) == 3U);
+    sim_force_ipsr(0U);
+    sim_switch = commit_region;
+    assert(cy_retarget_io_set_baudrate(9600U) == CY_RSLT_SUCCESS);
+    assert((sim_switch == NULL) && (sim_mutex_held == 0));
+    sim_expect("region", LINE LINE LINE LINE LINE LINE "isr", 6U * LINE_LEN + 3U);
+    cy_retarget_io_deinit();
+    printf("ok baudrate unlocked\n");
+}
+#endif // if defined(CY_RTOS_AWARE)
+
+
+int main(void)
+{
+    setvbuf(stdout, NULL, _IONBF, 0);
+    flush();
+    counters();
+    waits();
+#if !defined(CY_RTOS_AWARE)
+    odd_clock();
+#endif
+    baudrate(false);
+    baudrate(true);
+#if defined(CY_RTOS_AWARE)
+    baudrate_unlocked();
+#endif
+    printf("ALL OK\n");
+    return 0;
+}
@@ -0,0 +1,374 @@
+// COBS frames with CRC-16 survive every transmit mode, and reads find them among text and noise
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+#define PAYLOADS    (16)
+#define FRAME_MAX   (2048U)
+
+static uint8_t tx_buffer[1024];
+static uint8_t rx_buffer[700];
+static uint8_t payload[PAYLOADS][1100];
+static size_t  payload_len[PAYLOADS];
+static uint8_t frames[64][FRAME_MAX];
+static size_t  frame_len[64];
+static int     frame_count;
+static int     bad_count;
+
+
+static uint16_t crc16(const uint8_t* ptr, size_t len)
+{
+    uint16_t crc = 0xFFFFU;
+    while (len-- > 0U)
+    {
+        crc ^= (uint16_t)(*ptr++ << 8);
+        for (int k = 0; k < 8; k++)
+        {
+            crc = ((crc & 0x8000U) != 0U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+
+// Reference encoder: delimiter, COBS of the payload and its CRC (LSB first), delimiter
+static size_t encode(const uint8_t* ptr, size_t len, uint8_t* out)
+{
+    uint8_t  data[FRAME_MAX];
+    uint16_t crc   = crc16(ptr, len);
+    size_t   w     = 0U;
+    size_t   code_at;
+    uint8_t  code  = 1U;
+
+    memcpy(data, ptr, len);
+    data[len++] = (uint8_t)crc;
+    data[len++] = (uint8_t)(crc >> 8);
+    out[w++]    = 0U;
+    code_at     = w++;
+    for (size_t i = 0U; i < len; i++)
+    {
+        if (data[i] == 0U)
+        {
+            out[code_at] = code;
+            code_at      = w++;
+            code         = 1U;
+        }
+        else
+        {
+            out[w++] = data[i];
+            if (++code == 0xFFU)
+            {
+                out[code_at] = code;
+                code_at      = w++;
+                code         = 1U;
+            }
+        }
+    }
+    out[code_at] = code;
+    out[w++]     = 0U;
+    return w;
+}
+
+
+// Host deframer: collects the frames with a good CRC and counts the other segments
+static void deframe(const uint8_t* in, size_t len)
+{
+    size_t i = 0U;
+
+    frame_count = 0;
+    bad_count   = 0;
+    while (i < len)
+    {
+        size_t j = i;
+        while ((j < len) && (in[j] != 0U))
+        {
+            j++;
+        }
+        if (j == len)
+        {
+            break;
+        }
+        if (j > i)
+        {
+            uint8_t data[FRAME_MAX];
+            size_t  n  = 0U;
+            size_t  k  = i;
+            bool    ok = true;
+
+            while (ok && (k < j))
+            {
+                unsigned code = in[k++];
+                for (unsigned q = 1U; q < code; q++)
+                {
+                    if (k >= j)
+                    {
+                        ok = false;
+                        break;
+                    }
+                    data[n++] = in[k++];
+                }
+                if (ok && (code != 0xFFU) && (k < j))
+                {
+                    data[n++] = 0U;
+                }
+            }
+            if (ok && (n >= 2U) &&
+                (crc16(data, n - 2U) == (uint16_t)(data[n - 2U] | (data[n - 1U] << 8))))
+            {
+                memcpy(frames[frame_count], data, n - 2U);
+                frame_len[frame_count++] = n - 2U;
+            }
+            else
+            {
+                bad_count++;
+            }
+        }
+        i = j + 1U;
+    }
+}
+
+
+static void make_payloads(void)
+{
+    static const size_t lens[PAYLOADS] =
+    {
+        0, 1, 2, 253, 254, 255, 256, 507, 508, 509, 3, 100, 600, 1, 0, 40
+    };
+
+    srand(3U);
+    for (int i = 0; i < PAYLOADS; i++)
+    {
+        payload_len[i] = lens[i];
+        for (size_t k = 0U; k < lens[i]; k++)
+        {
+            int r = rand() % 4;
+            payload[i][k] = (r == 0) ? 0U : ((r == 1) ? 0xFFU : (uint8_t)rand());
+        }
+    }
+    memset(payload[6], 0, 256U);
+    memset(payload[8], 0x55, 508U);
+    payload[13][0] = 0U;
+}
+
+
+static void init(bool buffered, bool fifo, bool dma, cy_retarget_io_overflow_policy_t policy)
+{
+    cy_retarget_io_config_t config;
+
+    sim_reset();
+    if (fifo)
+    {
+        XMC_USIC0_CH0->TBCTR = (uint32_t)XMC_USIC_CH_FIFO_SIZE_16WORDS << USIC_CH_TBCTR_SIZE_Pos;
+    }
+    memset(&config, 0, sizeof(config));
+    config.channel         = XMC_USIC0_CH0;
+    config.overflow_policy = policy;
+    if (buffered)
+    {
+        config.tx_buffer      = tx_buffer;
+        config.tx_buffer_size = sizeof(tx_buffer);
+    }
+    if (dma)
+    {
+        config.dma.enable          = true;
+        config.dma.channel         = 2U;
+        config.dma.service_request = 1U;
+    }
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+}
+
+
+static void drain_all(void)
+{
+    sim_drain();
+    while (cy_retarget_io_is_tx_active())
+    {
+        sim_drain();
+    }
+}
+
+
+static void tx(bool buffered, bool fifo, bool dma)
+{
+    init(buffered, fifo, dma, CY_RETARGET_IO_OVERFLOW_BLOCK);
+    for (int i = 0; i < PAYLOADS; i++)
+    {
+        assert(cy_retarget_io_write_frame(payload[i], payload_len[i]) == CY_RSLT_SUCCESS);
+        _write(1, "text ok\n", 8);
+    }
+    drain_all();
+    deframe(sim_out, sim_out_len);
+    assert(frame_count == PAYLOADS);
+    for (int i = 0; i < PAYLOADS; i++)
+    {
+        assert((frame_len[i] == payload_len[i]) &&
+               (memcmp(frames[i], payload[i], payload_len[i]) == 0));
+    }
+    if (buffered)
+    {
+        assert(cy_retarget_io_write_frame(payload[0], 1020U) == CY_RETARGET_IO_RSLT_BAD_PARAM);
+        assert(cy_retarget_io_write_frame(NULL, 3U) == CY_RETARGET_IO_RSLT_BAD_PARAM);
+    }
+    else
+    {
+        // Byte exact against the reference encoder
+        uint8_t expected[FRAME_MAX];
+        size_t  len = encode(payload[5], payload_len[5], expected);
+
+        sim_out_len = 0U;
+        assert(cy_retarget_io_write_frame(payload[5], payload_len[5]) == CY_RSLT_SUCCESS);
+        sim_expect("reference encoding", expected, len);
+    }
+    cy_retarget_io_deinit();
+    printf("ok tx buffered=%d fifo=%d dma=%d (%d text segments)\n", buffered, fifo, dma,
+           bad_count);
+}
+
+
+static void drop(void)
+{
+    int sent    = 0;
+    int dropped = 0;
+
+    init(true, false, false, CY_RETARGET_IO_OVERFLOW_DROP_NEWEST);
+    sim_tx_stall = 1;
+    for (int i = 0; i < 10; i++)
+    {
+        cy_rslt_t result = cy_retarget_io_write_frame(payload[12], payload_len[12]);
+        if (result == CY_RSLT_SUCCESS)
+        {
+            sent++;
+        }
+        else
+        {
+            assert(result == CY_RETARGET_IO_RSLT_DROPPED);
+            dropped++;
+        }
+    }
+    assert(cy_retarget_io_get_tx_dropped() == (uint32_t)dropped * payload_len[12]);
+    sim_tx_stall = 0;
+    drain_all();
+    deframe(sim_out, sim_out_len);
+    assert((frame_count == sent) && (bad_count == 0));
+    cy_retarget_io_deinit();
+    printf("ok drop: %d sent, %d dropped\n", sent, dropped);
+}
+
+
+static void feed(const uint8_t* ptr, size_t len)
+{
+    for (size_t k = 0U; k < len; k++)
+    {
+        sim_rx(ptr[k]);
+    }
+}
+
+
+static void expect_frame(int index, size_t capacity)
+{
+    uint8_t buf[700];
+    size_t  len;
+
+    assert(cy_retarget_io_read_frame(buf, capacity, &len, 2U) == CY_RSLT_SUCCESS);
+    assert((len == payload_len[index]) && (memcmp(buf, payload[index], len) == 0));
+}
+
+
+static void rx(void)
+{
+    cy_retarget_io_config_t      config;
+    cy_retarget_io_rx_overruns_t overruns;
+    uint8_t                      buf[700];
+    uint8_t                      encoded[FRAME_MAX];
+    char                         text[16];
+    size_t                       len;
+    size_t                       n;
+
+    sim_reset();
+    memset(&config, 0, sizeof(config));
+    config.channel        = XMC_USIC0_CH0;
+    config.rx_buffer      = rx_buffer;
+    config.rx_buffer_size = sizeof(rx_buffer);
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+    assert(cy_retarget_io_read_frame(buf, sizeof(buf), &len, 0U) == CY_RETARGET_IO_RSLT_TIMEOUT);
+    assert(cy_retarget_io_read_frame(buf, sizeof(buf), &len, 5U) == CY_RETARGET_IO_RSLT_TIMEOUT);
+    for (int i = 0; i < PAYLOADS; i++)
+    {
+        if (payload_len[i] <= 600U)
+        {
+            feed(encoded, encode(payload[i], payload_len[i], encoded));
+            expect_frame(i, sizeof(buf));
+        }
+    }
+
+    // A partial frame times out and is read once it is complete
+    n = encode(payload[11], payload_len[11], encoded);
+    feed(encoded, n / 2U);
+    assert(cy_retarget_io_read_frame(buf, sizeof(buf), &len, 2U) == CY_RETARGET_IO_RSLT_TIMEOUT);
+    feed(&encoded[n / 2U], n - (n / 2U));
+    expect_frame(11, sizeof(buf));
+
+    // A corrupted frame and text noise are skipped
+    n = encode(payload[15], payload_len[15], encoded);
+    encoded[10] ^= 0x40U;
+    if (encoded[10] == 0U)
+    {
+        encoded[10] = 1U;
+    }
+    feed(encoded, n);
+    feed((const uint8_t*)"hello\r\n", 7U);
+    feed(encoded, encode(payload[11], payload_len[11], encoded));
+    expect_frame(11, sizeof(buf));
+    cy_retarget_io_get_rx_overruns(&overruns);
+    assert(overruns.frames == 2U);
+
+    // A frame larger than the caller's buffer is dropped
+    feed(encoded, encode(payload[11], payload_len[11], encoded));
+    assert(cy_retarget_io_read_frame(buf, 50U, &len, 2U) == CY_RETARGET_IO_RSLT_TIMEOUT);
+    cy_retarget_io_get_rx_overruns(&overruns);
+    assert(overruns.frames == 3U);
+
+    // A frame larger than the ring is dropped, the next one is still read
+    for (int k = 0; k < 800; k++)
+    {
+        sim_rx(0x41U);
+    }
+    assert(cy_retarget_io_read_frame(buf, sizeof(buf), &len, 2U) == CY_RETARGET_IO_RSLT_TIMEOUT);
+    feed(encoded, encode(payload[3], payload_len[3], encoded));
+    expect_frame(3, sizeof(buf));
+
+    // Text reads still work, as does a wait after a partial scan
+    feed((const uint8_t*)"cmd\n", 4U);
+    assert(cy_retarget_io_read(text, sizeof(text), 5U, CY_RETARGET_IO_READ_LINE) == 4U);
+    assert(memcmp(text, "cmd\n", 4U) == 0);
+    assert(cy_retarget_io_read_frame(NULL, 0U, &len, 0U) == CY_RETARGET_IO_RSLT_TIMEOUT);
+    cy_retarget_io_deinit();
+
+    sim_reset();
+    memset(&config, 0, sizeof(config));
+    config.channel = XMC_USIC0_CH0;
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+    assert(cy_retarget_io_read_frame(buf, sizeof(buf), &len, 0U) ==
+           CY_RETARGET_IO_RSLT_UNSUPPORTED);
+    cy_retarget_io_deinit();
+    printf("ok rx\n");
+}
+
+
+int main(void)
+{
+    setvbuf(stdout, NULL, _IONBF, 0);
+    make_payloads();
+    tx(false, false, false);
+    tx(true, false, false);
+    tx(true, true, false);
+#if (UC_FAMILY == XMC4)
+    tx(true, false, true);
+#endif
+    drop();
+    rx();
+    printf("ALL OK\n");
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Writes from interrupts never block, never take the mutex and drop whole messages
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+
+#define MSG         "0123456789abcde\n"
+#define MSG_LEN     (sizeof(MSG) - 1U)
+#define ISR_IPSR    (20U)
+
+static uint8_t tx_buffer[64];
+static uint8_t high_buffer[32];
+
+
+static void fill(int fd, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        _write(fd, MSG, (int)MSG_LEN);
+    }
+}
+
+
+static void buffered(bool high)
+{
+    cy_retarget_io_config_t config;
+
+    sim_reset();
+    memset(&config, 0, sizeof(config));
+    config.channel        = XMC_USIC0_CH0;
+    config.tx_buffer      = tx_buffer;
+    config.tx_buffer_size = sizeof(tx_buffer);
+    if (high)
+    {
+        config.tx_high_buffer      = high_buffer;
+        config.tx_high_buffer_size = sizeof(high_buffer);
+    }
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+
+    // The line is stalled, so a blocking write would never return
+    sim_tx_stall = 1;
+    sim_force_ipsr(ISR_IPSR);
+    fill(high ? 2 : 1, 20);
+    CY_RETARGET_IO_LOG("isr %u", 1U);
+    if (!high)
+    {
+        assert(cy_retarget_io_write_frame("abc", 3U) == CY_RETARGET_IO_RSLT_DROPPED);
+    }
+    assert(cy_retarget_io_get_tx_dropped() > 0U);
+    sim_force_ipsr(0U);
+    sim_tx_stall = 0;
+    sim_drain();
+    assert((sim_out_len > 0U) && (sim_out_len <= 20U * MSG_LEN));
+    if (!high)
+    {
+        assert((sim_out_len % MSG_LEN) == 0U);
+    }
+    cy_retarget_io_deinit();
+    printf("ok buffered high=%d sent %zu dropped %u\n", high, sim_out_len,
+           (unsigned)cy_retarget_io_get_tx_dropped());
+}
+
+
+static void polled(void)
+{
+    sim_reset();
+    assert(cy_retarget_io_init(XMC_USIC0_CH0) == CY_RSLT_SUCCESS);
+    sim_force_ipsr(ISR_IPSR);
+    fill(1, 2);
+    assert(cy_retarget_io_write_frame("f", 1U) == CY_RETARGET_IO_RSLT_DROPPED);
+    sim_force_ipsr(0U);
+    fill(1, 1);
+    sim_drain();
+    assert(sim_out_len == MSG_LEN);
+    assert(cy_retarget_io_get_tx_dropped() == ((2U * MSG_LEN) + 1U));
+
+    // The fault handler owns the channel after a panic flush, so this runs last
+    cy_retarget_io_panic_flush();
+    sim_force_ipsr(ISR_IPSR);
+    fill(1, 1);
+    sim_force_ipsr(0U);
+    sim_drain();
+    assert(sim_out_len == 2U * MSG_LEN);
+    printf("ok polled dropped %u\n", (unsigned)cy_retarget_io_get_tx_dropped());
+}
+
+
+int main(void)
+{
+    setvbuf(stdout, NULL, _IONBF, 0);
+    buffered(false);
+    buffered(true);
+    polled();
+    printf("ALL OK\n");
+    return 0;
+}
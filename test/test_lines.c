@@ -0,0 +1,234 @@
+// CY_RETARGET_IO_LINE_BUFFERS keeps the lines of concurrent tasks whole
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+#define TASKS   (8)
+
+static uint8_t tx_buffer[256];
+static uint8_t rx_buffer[16];
+static char    ref[200000];
+static size_t  ref_len;
+static char    pending[TASKS][4096];
+static size_t  pending_len[TASKS];
+static int     task_id[TASKS];
+
+
+static void emit(int task, size_t len)
+{
+    memcpy(&ref[ref_len], pending[task], len);
+    ref_len += len;
+    memmove(pending[task], &pending[task][len], pending_len[task] - len);
+    pending_len[task] -= len;
+}
+
+
+static void emit_all(int task)
+{
+    emit(task, pending_len[task]);
+}
+
+
+// Writes as the given task and models what the library sends: whole lines, or a full buffer
+static void task_write(int task, const char* ptr, size_t len)
+{
+    size_t done = 0U;
+
+    sim_thread_id = &task_id[task];
+    _write(1, ptr, (int)len);
+    if (pending_len[task] == 0U)
+    {
+        size_t end = len;
+        while ((end > 0U) && (ptr[end - 1U] != '\n'))
+        {
+            end--;
+        }
+        memcpy(&ref[ref_len], ptr, end);
+        ref_len += end;
+        done     = end;
+    }
+    while (done < len)
+    {
+        size_t chunk = CY_RETARGET_IO_LINE_BUFFER_SIZE - pending_len[task];
+        size_t start = pending_len[task];
+        size_t end;
+
+        if (chunk > len - done)
+        {
+            chunk = len - done;
+        }
+        memcpy(&pending[task][start], &ptr[done], chunk);
+        pending_len[task] += chunk;
+        done              += chunk;
+        end                = pending_len[task];
+        while ((end > start) && (pending[task][end - 1U] != '\n'))
+        {
+            end--;
+        }
+        if ((end == start) && (pending_len[task] == CY_RETARGET_IO_LINE_BUFFER_SIZE))
+        {
+            end = pending_len[task];
+        }
+        if (end > start)
+        {
+            emit(task, end);
+        }
+    }
+}
+
+
+static void interleave(void)
+{
+    srand(11U);
+    for (int k = 0; k < 3000; k++)
+    {
+        int  task = rand() % 3;
+        char buf[64];
+        int  len;
+
+        if ((rand() % 4) == 0)
+        {
+            len = snprintf(buf, sizeof(buf), "T%d line %d\n", task, k);
+        }
+        else
+        {
+            len = snprintf(buf, sizeof(buf), "T%d:%d ", task, k);
+        }
+        task_write(task, buf, (size_t)len);
+    }
+}
+
+
+// Changing the baud rate sends the partial line of the caller before it closes the ring
+static void baudrate(void)
+{
+    sim_reset();
+    assert(cy_retarget_io_init_buffered(XMC_USIC0_CH0, tx_buffer, sizeof(tx_buffer)) ==
+           CY_RSLT_SUCCESS);
+    sim_thread_id = &task_id[0];
+    cy_retarget_io_printf("switching...");
+    assert(cy_retarget_io_set_baudrate(3000000U) == CY_RSLT_SUCCESS);
+    assert(!cy_retarget_io_is_tx_active());
+    sim_expect("baudrate", "switching...", 12U);
+    cy_retarget_io_deinit();
+}
+
+
+// A buffer released for a deleted task returns to the pool with its partial line sent, a task
+// created later with the same handle starts a new line
+static void release(void)
+{
+    static const char expected[] = "gone2gone3gone4gone5gone6gone7++++++\nheld\ngone2new\n";
+
+    sim_reset();
+    assert(cy_retarget_io_init_buffered(XMC_USIC0_CH0, tx_buffer, sizeof(tx_buffer)) ==
+           CY_RSLT_SUCCESS);
+    for (int task = 2; task < TASKS; task++)
+    {
+        char buf[8];
+        int  len = snprintf(buf, sizeof(buf), "gone%d", task);
+
+        sim_thread_id = &task_id[task];
+        _write(1, buf, len);
+        sim_thread_id = &task_id[1];
+        _write(1, "+", 1);
+        if ((task % 2) == 0)
+        {
+            sim_thread_id = &task_id[task];
+            cy_retarget_io_line_release(NULL);
+        }
+        else
+        {
+            sim_thread_id = NULL;
+            cy_retarget_io_line_release(&task_id[task]);
+        }
+    }
+
+    // With the buffers of the deleted tasks lost the pool would be exhausted here
+    sim_thread_id = &task_id[0];
+    _write(1, "held", 4);
+    sim_thread_id = &task_id[1];
+    _write(1, "\n", 1);
+    sim_thread_id = &task_id[0];
+    _write(1, "\n", 1);
+    sim_thread_id = &task_id[2];
+    _write(1, "gone2", 5);
+    _write(1, "new\n", 4);
+    sim_expect("release", expected, sizeof(expected) - 1U);
+    cy_retarget_io_deinit();
+}
+
+
+int main(void)
+{
+    cy_retarget_io_config_t config;
+    char                    buf[40];
+
+    setvbuf(stdout, NULL, _IONBF, 0);
+    sim_reset();
+    assert(cy_retarget_io_init(XMC_USIC0_CH0) == CY_RSLT_SUCCESS);
+    interleave();
+    sim_expect("polling", ref, ref_len);
+
+    // Without LF for a long time the full buffer is sent
+    memset(buf, 'z', sizeof(buf));
+    for (int i = 0; i < 10; i++)
+    {
+        task_write(0, buf, sizeof(buf));
+    }
+    sim_expect("full buffer", ref, ref_len);
+
+    // Flush sends the partial line of the calling task, the others stay
+    sim_thread_id = &task_id[1];
+    assert(cy_retarget_io_flush(1000000U) == CY_RSLT_SUCCESS);
+    emit_all(1);
+    sim_expect("flush", ref, ref_len);
+
+    // Deinit sends the rest
+    cy_retarget_io_deinit();
+    for (int task = 0; task < 3; task++)
+    {
+        emit_all(task);
+    }
+    sim_expect("deinit", ref, ref_len);
+
+    sim_reset();
+    ref_len = 0U;
+    memset(&config, 0, sizeof(config));
+    config.channel        = XMC_USIC0_CH0;
+    config.tx_buffer      = tx_buffer;
+    config.tx_buffer_size = sizeof(tx_buffer);
+    config.rx_buffer      = rx_buffer;
+    config.rx_buffer_size = sizeof(rx_buffer);
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+    interleave();
+    sim_expect("buffered", ref, ref_len);
+
+    // With more tasks than buffers the others write directly
+    for (int k = 0; k < 40; k++)
+    {
+        int len;
+
+        sim_thread_id = &task_id[k % 6];
+        len           = snprintf(buf, sizeof(buf), "%d.", k % 6);
+        _write(1, buf, len);
+    }
+    sim_drain();
+    printf("pool exhausted: %zu bytes sent\n", sim_out_len - ref_len);
+
+    // A prompt is visible before the read that follows it
+    sim_out_len   = 0U;
+    sim_thread_id = &task_id[7];
+    _write(1, "> ", 2);
+    sim_rx('y');
+    assert(cy_retarget_io_read(buf, 4U, 0U, CY_RETARGET_IO_READ_RAW) == 1U);
+    sim_expect("prompt", "> ", 2U);
+    cy_retarget_io_deinit();
+    baudrate();
+    release();
+    sim_thread_id = NULL;
+    printf("ALL OK\n");
+    return 0;
+}
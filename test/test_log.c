@@ -0,0 +1,75 @@
+// CY_RETARGET_IO_LOG emits binary records, and a route sends stderr to a second channel
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+
+static uint8_t tx_buffer[64];
+
+
+uint32_t cy_retarget_io_get_timestamp(void)
+{
+    return 0x11223344U;
+}
+
+
+static uint32_t rd32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+
+static void binary_log(bool buffered)
+{
+    const uint8_t* out = sim_out;
+
+    sim_reset();
+    if (buffered)
+    {
+        assert(cy_retarget_io_init_buffered(XMC_USIC0_CH0, tx_buffer, sizeof(tx_buffer)) ==
+               CY_RSLT_SUCCESS);
+    }
+    else
+    {
+        assert(cy_retarget_io_init(XMC_USIC0_CH0) == CY_RSLT_SUCCESS);
+    }
+    CY_RETARGET_IO_LOG("hello\n");
+    CY_RETARGET_IO_LOG("v=%d w=%u\n", 10, 0x0A0AU);
+    sim_drain();
+    assert(sim_out_len == 10U + 18U);
+    assert((out[0] == 0xFFU) && (out[1] == 0U) && (rd32(&out[6]) == 0x11223344U));
+    out = &out[10];
+    assert((out[1] == 2U) && (rd32(&out[10]) == 10U) && (rd32(&out[14]) == 0x0A0AU));
+    cy_retarget_io_deinit();
+    printf("ok log buffered=%d\n", buffered);
+}
+
+
+static void route(void)
+{
+    sim_reset();
+    sim_out2_len = 0U;
+    assert(cy_retarget_io_init_buffered(XMC_USIC0_CH0, tx_buffer, sizeof(tx_buffer)) ==
+           CY_RSLT_SUCCESS);
+    assert(cy_retarget_io_set_route(CY_RETARGET_IO_STDERR, XMC_USIC0_CH1) == CY_RSLT_SUCCESS);
+    assert(cy_retarget_io_set_route(5, XMC_USIC0_CH1) != CY_RSLT_SUCCESS);
+    _write(1, "telemetry\n", 10);
+    _write(2, "fault\n", 6);
+    sim_drain();
+    assert((sim_out_len >= 10U) && (memcmp(sim_out, "telemetry", 9U) == 0));
+    assert((sim_out2_len >= 6U) && (memcmp(sim_out2, "fault", 5U) == 0));
+    cy_retarget_io_deinit();
+    printf("ok route\n");
+}
+
+
+int main(void)
+{
+    setvbuf(stdout, NULL, _IONBF, 0);
+    binary_log(false);
+    binary_log(true);
+    route();
+    printf("ALL OK\n");
+    return 0;
+}
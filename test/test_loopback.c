@@ -0,0 +1,132 @@
+// With the transmitter looped back to the receiver, every transmit mode delivers the written
+// bytes to cy_retarget_io_read() in order and without receive overruns
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+typedef enum
+{
+    MODE_POLLING,
+    MODE_POLLING_FIFO,
+    MODE_INTERRUPT,
+    MODE_INTERRUPT_FIFO,
+    MODE_DMA,
+    MODE_COUNT
+} tx_mode_t;
+
+static const char* const mode_names[MODE_COUNT] =
+{
+    "polling", "polling fifo", "interrupt", "interrupt fifo", "dma"
+};
+
+static uint8_t tx_buffer[256];
+static uint8_t rx_buffer[512];
+static uint8_t sent[1 << 16];
+static size_t  sent_len;
+static uint8_t received[1 << 16];
+static size_t  received_len;
+
+
+static void init(tx_mode_t mode)
+{
+    cy_retarget_io_config_t config;
+
+    sim_reset();
+    sim_loopback = 1;
+    if ((mode == MODE_POLLING_FIFO) || (mode == MODE_INTERRUPT_FIFO))
+    {
+        XMC_USIC0_CH0->TBCTR = (uint32_t)XMC_USIC_CH_FIFO_SIZE_16WORDS << USIC_CH_TBCTR_SIZE_Pos;
+        XMC_USIC0_CH0->RBCTR = (uint32_t)XMC_USIC_CH_FIFO_SIZE_16WORDS << USIC_CH_RBCTR_SIZE_Pos;
+    }
+    memset(&config, 0, sizeof(config));
+    config.channel        = XMC_USIC0_CH0;
+    config.rx_buffer      = rx_buffer;
+    config.rx_buffer_size = sizeof(rx_buffer);
+    if (mode >= MODE_INTERRUPT)
+    {
+        config.tx_buffer      = tx_buffer;
+        config.tx_buffer_size = sizeof(tx_buffer);
+    }
+    if (mode == MODE_DMA)
+    {
+        config.dma.enable          = true;
+        config.dma.channel         = 2U;
+        config.dma.service_request = 1U;
+    }
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+    sent_len     = 0U;
+    received_len = 0U;
+}
+
+
+static void receive(uint32_t timeout_ms)
+{
+    received_len += cy_retarget_io_read(&received[received_len], sizeof(received) - received_len,
+                                        timeout_ms, CY_RETARGET_IO_READ_RAW);
+}
+
+
+static void send(const void* ptr, size_t len)
+{
+    memcpy(&sent[sent_len], ptr, len);
+    sent_len += len;
+    assert(_write(1, ptr, (int)len) == (int)len);
+    receive(0U);
+}
+
+
+static void run(tx_mode_t mode)
+{
+    cy_retarget_io_rx_overruns_t overruns;
+    uint8_t                      buf[100];
+
+    init(mode);
+    srand(5U);
+    for (int k = 0; k < 300; k++)
+    {
+        size_t len = 1U + ((size_t)rand() % sizeof(buf));
+        for (size_t i = 0U; i < len; i++)
+        {
+            // Text only, CY_RETARGET_IO_CONVERT_LF_TO_CRLF and line stamps change LF
+            buf[i] = (uint8_t)(' ' + (rand() % 95));
+        }
+        send(buf, len);
+    }
+    sim_drain();
+    while (cy_retarget_io_is_tx_active())
+    {
+        sim_drain();
+    }
+    while (received_len < sent_len)
+    {
+        size_t before = received_len;
+        receive(10U);
+        if (received_len == before)
+        {
+            break;
+        }
+    }
+    cy_retarget_io_get_rx_overruns(&overruns);
+    if ((received_len != sent_len) || (memcmp(received, sent, sent_len) != 0))
+    {
+        printf("FAIL %s: %zu of %zu bytes received\n", mode_names[mode], received_len, sent_len);
+        abort();
+    }
+    assert((overruns.ring == 0U) && (overruns.hardware == 0U));
+    cy_retarget_io_deinit();
+    printf("ok loopback %s: %zu bytes\n", mode_names[mode], sent_len);
+}
+
+
+int main(void)
+{
+    setvbuf(stdout, NULL, _IONBF, 0);
+    for (int mode = 0; mode < (int)MODE_COUNT; mode++)
+    {
+        run((tx_mode_t)mode);
+    }
+    printf("ALL OK\n");
+    return 0;
+}
@@ -0,0 +1,110 @@
+// Every overflow policy accounts for each byte: sent, returned short or counted as dropped
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+
+static uint8_t    tx_buffer[32];
+static const char big[] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ\n";
+
+
+static void run(cy_retarget_io_overflow_policy_t policy, const char* name)
+{
+    cy_retarget_io_config_t config;
+    size_t                  accepted;
+    int                     written;
+
+    sim_reset();
+    memset(&config, 0, sizeof(config));
+    config.channel         = XMC_USIC0_CH0;
+    config.tx_buffer       = tx_buffer;
+    config.tx_buffer_size  = sizeof(tx_buffer);
+    config.overflow_policy = policy;
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+
+    accepted = cy_retarget_io_write_nb(big, strlen(big));
+    written  = _write(1, big, (int)strlen(big));
+    sim_drain();
+    printf("%s: write_nb %zu, _write %d, dropped %u, sent %zu\n", name, accepted, written,
+           (unsigned)cy_retarget_io_get_tx_dropped(), sim_out_len);
+    if (policy != CY_RETARGET_IO_OVERFLOW_DROP_OLDEST)
+    {
+        assert(accepted + (size_t)written + cy_retarget_io_get_tx_dropped() == 2U * strlen(big));
+    }
+    cy_retarget_io_deinit();
+}
+
+
+// CY_RETARGET_IO_OVERFLOW_DROP_OLDEST only drops whole lines and binary records
+static void whole_records(void)
+{
+    static uint8_t          ring[128];
+    cy_retarget_io_config_t config;
+    const uint8_t*          p;
+    const uint8_t*          end;
+    int                     last = -1;
+    int                     lines = 0;
+
+    sim_reset();
+    memset(&config, 0, sizeof(config));
+    config.channel         = XMC_USIC0_CH0;
+    config.tx_buffer       = ring;
+    config.tx_buffer_size  = sizeof(ring);
+    config.overflow_policy = CY_RETARGET_IO_OVERFLOW_DROP_OLDEST;
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+    sim_tx_stall = 1;
+    for (int i = 0; i < 100; i++)
+    {
+        if ((i % 7) == 3)
+        {
+            // Its bytes include LF, the record must not be taken for a line
+            CY_RETARGET_IO_LOG("x", 0x0A0A0A0AU);
+        }
+        else
+        {
+            cy_retarget_io_printf("line %02d\n", i);
+        }
+    }
+    sim_tx_stall = 0;
+    sim_drain();
+    assert(cy_retarget_io_get_tx_dropped() > 0U);
+
+    p   = sim_out;
+    end = &sim_out[sim_out_len];
+    while (p < end)
+    {
+        int n;
+
+        if (*p == CY_RETARGET_IO_LOG_MARKER)
+        {
+            assert((end - p) >= (ptrdiff_t)(CY_RETARGET_IO_LOG_HEADER_SIZE + 4U));
+            assert(p[1] == 1U);
+            assert(memcmp(&p[CY_RETARGET_IO_LOG_HEADER_SIZE], "\n\n\n\n", 4U) == 0);
+            p += CY_RETARGET_IO_LOG_HEADER_SIZE + 4U;
+            continue;
+        }
+        assert(((end - p) >= 8) && (memcmp(p, "line ", 5U) == 0) && (p[7] == '\n'));
+        n = ((p[5] - '0') * 10) + (p[6] - '0');
+        assert(n > last);
+        last = n;
+        lines++;
+        p   += 8;
+    }
+    assert(last == 99);
+    printf("drop oldest: %d whole lines of 100 records kept, dropped %u\n", lines,
+           (unsigned)cy_retarget_io_get_tx_dropped());
+    cy_retarget_io_deinit();
+}
+
+
+int main(void)
+{
+    setvbuf(stdout, NULL, _IONBF, 0);
+    run(CY_RETARGET_IO_OVERFLOW_BLOCK, "block");
+    run(CY_RETARGET_IO_OVERFLOW_DROP_NEWEST, "drop newest");
+    run(CY_RETARGET_IO_OVERFLOW_DROP_OLDEST, "drop oldest");
+    run(CY_RETARGET_IO_OVERFLOW_TRUNCATE, "truncate");
+    whole_records();
+    printf("ALL OK\n");
+    return 0;
+}
@@ -0,0 +1,83 @@
+// cy_retarget_io_printf() formats like the C library for the supported conversions
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+
+static uint8_t tx_buffer[256];
+
+// Compares one cy_retarget_io_printf() call with snprintf() of the same arguments
+#define CHECK(...) \
+    do { \
+        char expected[512]; \
+        int  len = snprintf(expected, sizeof(expected), __VA_ARGS__); \
+        int  ret; \
+        sim_out_len = 0U; \
+        ret = cy_retarget_io_printf(__VA_ARGS__); \
+        sim_drain(); \
+        if ((ret != len) || (sim_out_len != (size_t)len) || \
+            (memcmp(sim_out, expected, (size_t)len) != 0)) \
+        { \
+            printf("FAIL %s: want '%s' (%d) got '%.*s' (%d)\n", #__VA_ARGS__, expected, len, \
+                   (int)sim_out_len, (const char*)sim_out, ret); \
+            assert(0); \
+        } \
+    } while (0)
+
+
+static void conversions(void)
+{
+    char long_str[300];
+
+    CHECK("plain");
+    CHECK("%d %i %u", 0, -12345, 4000000000U);
+    CHECK("%5d|%-5d|%05d|%+d|% d", 42, 42, -42, 7, 7);
+    CHECK("%x %X %#x %#X %08x %#o %o", 0xDEADBEEFU, 0xABCU, 255U, 255U, 0x12U, 8U, 0U);
+    CHECK("%.0d|%.3d|%8.3d|%-8.3x|%#.0o", 0, 7, -7, 0xAU, 0U);
+    CHECK("%c%c|%3c|%-3c|", 'a', 'b', 'z', 'y');
+    CHECK("%s|%10s|%-10s|%.2s|%*s|%-*.*s|", "abc", "right", "left", "trunc", 6, "st", 6, 2,
+          "xyz");
+    CHECK("%ld %lu %lx %hd %hhu %zu", -2147483647L - 1, 4294967295UL, 0x1234UL, (short)-3,
+          (unsigned char)200, (size_t)77);
+    // h and hh convert the promoted argument back to short and char
+    CHECK("%hx %hhd %hhd %hu %hhx %hd", (short)-1, 300, -129, 70000U, 0x1FFU, 40000);
+    CHECK("%% 100%%");
+    CHECK("%*d|%-*d|", -5, 1, 4, 2);
+    CHECK("%p", (void*)0x20001000);
+    memset(long_str, 'q', sizeof(long_str) - 1U);
+    long_str[sizeof(long_str) - 1U] = '\0';
+    CHECK("[%s]\n", long_str);
+#if defined(CY_RETARGET_IO_PRINTF_FLOAT)
+    CHECK("%f %.2f %.0f %#.0f %8.3f|%-8.1f|%08.2f|%+.1f", 3.14159, -2.0051, 2.6, 2.0, 1.0005,
+          -0.26, -1.5, 0.05);
+    CHECK("%.9f %f %.3f", 0.123456789, 123456.0, 0.9996);
+#else
+    sim_out_len = 0U;
+    assert(cy_retarget_io_printf("%f|%d", 1.5, 3) == 4);
+    sim_drain();
+    assert(memcmp(sim_out, "%f|3", 4U) == 0);
+#endif
+#if defined(CY_RETARGET_IO_PRINTF_LONG_LONG)
+    CHECK("%lld %llu %llx", -9000000000000LL, 18446744073709551615ULL, 0x123456789ABCULL);
+#endif
+}
+
+
+int main(void)
+{
+    setvbuf(stdout, NULL, _IONBF, 0);
+    sim_reset();
+    assert(cy_retarget_io_init(XMC_USIC0_CH0) == CY_RSLT_SUCCESS);
+    conversions();
+    cy_retarget_io_deinit();
+    printf("ok polling\n");
+
+    sim_reset();
+    assert(cy_retarget_io_init_buffered(XMC_USIC0_CH0, tx_buffer, sizeof(tx_buffer)) ==
+           CY_RSLT_SUCCESS);
+    conversions();
+    cy_retarget_io_deinit();
+    printf("ok buffered\n");
+    printf("ALL OK\n");
+    return 0;
+}
@@ -0,0 +1,179 @@
+// stderr overtakes buffered stdout at a record boundary, and the panic flush empties every lane
+#define _GNU_SOURCE
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+
+#define LINE        "bulk trace line with some text\n"
+#define LINE_LEN    (sizeof(LINE) - 1U)
+
+static uint8_t tx_buffer[256];
+static uint8_t high_buffer[64];
+
+
+// A deferred log record with two arguments, whose bytes include LF and the log marker
+#define RECORD_LEN  (CY_RETARGET_IO_LOG_HEADER_SIZE + 8U)
+
+
+static void init(bool fifo, bool dma, bool high, int lines)
+{
+    cy_retarget_io_config_t config;
+
+    sim_reset();
+    if (fifo)
+    {
+        XMC_USIC0_CH0->TBCTR = (uint32_t)XMC_USIC_CH_FIFO_SIZE_16WORDS << USIC_CH_TBCTR_SIZE_Pos;
+    }
+    memset(&config, 0, sizeof(config));
+    config.channel        = XMC_USIC0_CH0;
+    config.tx_buffer      = tx_buffer;
+    config.tx_buffer_size = sizeof(tx_buffer);
+    if (high)
+    {
+        config.tx_high_buffer      = high_buffer;
+        config.tx_high_buffer_size = sizeof(high_buffer);
+    }
+    if (dma)
+    {
+        config.dma.enable          = true;
+        config.dma.channel         = 2U;
+        config.dma.service_request = 1U;
+    }
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+    for (int i = 0; i < lines; i++)
+    {
+        _write(1, LINE, (int)LINE_LEN);
+    }
+}
+
+
+static void priority(bool fifo, bool dma)
+{
+    const uint8_t* fault;
+    size_t         pos;
+
+    init(fifo, dma, true, 6);
+    _write(2, "FAULT!\n", 7);
+    sim_drain();
+    fault = memmem(sim_out, sim_out_len, "FAULT!\n", 7U);
+    assert(fault != NULL);
+    pos = (size_t)(fault - sim_out);
+    assert((sim_out_len == 6U * LINE_LEN + 7U) && ((pos % LINE_LEN) == 0U));
+    assert(pos < 5U * LINE_LEN);
+    cy_retarget_io_deinit();
+    printf("ok priority fifo=%d dma=%d sent after line %zu\n", fifo, dma, pos / LINE_LEN);
+}
+
+
+// Binary records are never split, whatever bytes they contain
+static void records(bool fifo, bool dma)
+{
+    const uint8_t* fault;
+    size_t         pos;
+
+    init(fifo, dma, true, 0);
+    for (int i = 0; i < 8; i++)
+    {
+        CY_RETARGET_IO_LOG("value %x %x", 0x0A0AFF0AU, 0xFF0A0AFFU);
+    }
+    _write(2, "FAULT!\n", 7);
+    sim_drain();
+    fault = memmem(sim_out, sim_out_len, "FAULT!\n", 7U);
+    assert(fault != NULL);
+    pos = (size_t)(fault - sim_out);
+    assert((sim_out_len == 8U * RECORD_LEN + 7U) && ((pos % RECORD_LEN) == 0U));
+    assert(pos < 7U * RECORD_LEN);
+    cy_retarget_io_deinit();
+    printf("ok records fifo=%d dma=%d sent after record %zu\n", fifo, dma, pos / RECORD_LEN);
+}
+
+
+// The high priority lane returns what it accepted and only waits for space with
+// CY_RETARGET_IO_OVERFLOW_BLOCK
+static void lane_policy(cy_retarget_io_overflow_policy_t policy, const char* name)
+{
+    static const char       msg[] = "stderr message longer than half the lane\n";
+    cy_retarget_io_config_t config;
+    int                     written[3];
+    size_t                  accepted = 0U;
+
+    sim_reset();
+    memset(&config, 0, sizeof(config));
+    config.channel             = XMC_USIC0_CH0;
+    config.tx_buffer           = tx_buffer;
+    config.tx_buffer_size      = sizeof(tx_buffer);
+    config.tx_high_buffer      = high_buffer;
+    config.tx_high_buffer_size = sizeof(high_buffer);
+    config.overflow_policy     = policy;
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+    sim_tx_stall = (policy != CY_RETARGET_IO_OVERFLOW_BLOCK);
+    for (int i = 0; i < 3; i++)
+    {
+        written[i] = _write(2, msg, (int)strlen(msg));
+        accepted  += (size_t)written[i];
+    }
+    sim_tx_stall = 0;
+    sim_drain();
+    printf("ok lane %s: %d %d %d accepted, dropped %u\n", name, written[0], written[1],
+           written[2], (unsigned)cy_retarget_io_get_tx_dropped());
+    assert(sim_out_len == accepted);
+    assert(accepted + cy_retarget_io_get_tx_dropped() == 3U * strlen(msg));
+    assert(written[0] == (int)strlen(msg));
+    if (policy == CY_RETARGET_IO_OVERFLOW_BLOCK)
+    {
+        assert(accepted == 3U * strlen(msg));
+    }
+    else if (policy == CY_RETARGET_IO_OVERFLOW_TRUNCATE)
+    {
+        assert((written[1] > 0) && (written[1] < (int)strlen(msg)) && (written[2] == 0));
+    }
+    else
+    {
+        assert((written[1] == 0) && (written[2] == 0));
+    }
+    cy_retarget_io_deinit();
+}
+
+
+static void panic(bool fifo, bool dma, bool high)
+{
+    sim_tick_masked = 1;
+    init(fifo, dma, high, 6);
+    _write(2, "FAULT!\n", 7);
+    cy_retarget_io_panic_flush();
+    assert(!cy_retarget_io_is_tx_active());
+    _write(2, "after\n", 6);
+    sim_drain();
+    assert(sim_out_len == 6U * LINE_LEN + 7U + 6U);
+    assert(memcmp(&sim_out[sim_out_len - 6U], "after\n", 6U) == 0);
+    sim_tick_masked = 0;
+    cy_retarget_io_deinit();
+    printf("ok panic fifo=%d dma=%d high=%d\n", fifo, dma, high);
+}
+
+
+int main(void)
+{
+    setvbuf(stdout, NULL, _IONBF, 0);
+    priority(false, false);
+    priority(true, false);
+    priority(false, true);
+    records(false, false);
+    records(true, false);
+    records(false, true);
+    lane_policy(CY_RETARGET_IO_OVERFLOW_BLOCK, "block");
+    lane_policy(CY_RETARGET_IO_OVERFLOW_DROP_NEWEST, "drop newest");
+    lane_policy(CY_RETARGET_IO_OVERFLOW_DROP_OLDEST, "drop oldest");
+    lane_policy(CY_RETARGET_IO_OVERFLOW_TRUNCATE, "truncate");
+    for (int high = 0; high < 2; high++)
+    {
+        panic(false, false, high != 0);
+        panic(true, false, high != 0);
+#if (UC_FAMILY == XMC4)
+        panic(false, true, high != 0);
+#endif
+    }
+    printf("ALL OK\n");
+    return 0;
+}
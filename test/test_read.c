@@ -0,0 +1,96 @@
+// cy_retarget_io_read() in the raw and line modes, with and without the receive ring
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+
+static uint8_t rx_buffer[64];
+
+
+static void feed(const char* str)
+{
+    for (; *str != '\0'; str++)
+    {
+        sim_rx((uint8_t)*str);
+    }
+}
+
+
+static void run(bool buffered)
+{
+    cy_retarget_io_config_t config;
+    char                    buf[64];
+    size_t                  len;
+
+    sim_reset();
+    memset(&config, 0, sizeof(config));
+    config.channel = XMC_USIC0_CH0;
+    if (buffered)
+    {
+        config.rx_buffer      = rx_buffer;
+        config.rx_buffer_size = sizeof(rx_buffer);
+    }
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+
+    assert(cy_retarget_io_read(buf, sizeof(buf), 5U, CY_RETARGET_IO_READ_RAW) == 0U);
+    assert(cy_retarget_io_read(buf, sizeof(buf), 5U, CY_RETARGET_IO_READ_LINE) == 0U);
+    if (buffered)
+    {
+        const uint32_t crlf = CY_RETARGET_IO_READ_CRLF_TO_LF;
+
+        feed("cmd");
+        len = cy_retarget_io_read(buf, sizeof(buf), 5U, CY_RETARGET_IO_READ_LINE);
+        assert((len == 3U) && (memcmp(buf, "cmd", 3U) == 0));
+        feed("ab\r\ncd\ref\n");
+        len = cy_retarget_io_read(buf, sizeof(buf), 5U, CY_RETARGET_IO_READ_LINE | crlf);
+        assert((len == 3U) && (memcmp(buf, "ab\n", 3U) == 0));
+        len = cy_retarget_io_read(buf, sizeof(buf), 5U, CY_RETARGET_IO_READ_LINE | crlf);
+        assert((len == 3U) && (memcmp(buf, "cd\n", 3U) == 0));
+        len = cy_retarget_io_read(buf, sizeof(buf), 5U, CY_RETARGET_IO_READ_RAW | crlf);
+        assert((len == 3U) && (memcmp(buf, "ef\n", 3U) == 0));
+        feed("x\ny\n");
+        assert(cy_retarget_io_read(buf, sizeof(buf), 0U, CY_RETARGET_IO_READ_RAW) == 4U);
+        feed("line\n");
+        assert((_read(0, buf, sizeof(buf)) == 5) && (memcmp(buf, "line\n", 5U) == 0));
+        feed("q");
+        len = cy_retarget_io_read(buf, 1U, CY_RETARGET_IO_WAIT_FOREVER,
+                                  CY_RETARGET_IO_READ_LINE);
+        assert((len == 1U) && (buf[0] == 'q'));
+    }
+    else
+    {
+        feed("z");
+        len = cy_retarget_io_read(buf, sizeof(buf), 5U, CY_RETARGET_IO_READ_RAW);
+        assert((len == 1U) && (buf[0] == 'z'));
+    }
+    cy_retarget_io_deinit();
+    printf("ok read buffered=%d\n", buffered);
+}
+
+
+// A core clock of no whole MHz still waits the whole timeout, 20 ms are 300 ticks at 1.5 MHz
+static void odd_clock(void)
+{
+    char buf[4];
+
+    sim_reset();
+    SystemCoreClock = 1500000U;
+    assert(cy_retarget_io_init(XMC_USIC0_CH0) == CY_RSLT_SUCCESS);
+    uint64_t start = sim_time;
+    assert(cy_retarget_io_read(buf, sizeof(buf), 20U, CY_RETARGET_IO_READ_RAW) == 0U);
+    assert((sim_time - start >= 300U) && (sim_time - start < 330U));
+    cy_retarget_io_deinit();
+    SystemCoreClock = 1000000U;
+    printf("ok read odd clock\n");
+}
+
+
+int main(void)
+{
+    setvbuf(stdout, NULL, _IONBF, 0);
+    run(true);
+    run(false);
+    odd_clock();
+    printf("ALL OK\n");
+    return 0;
+}
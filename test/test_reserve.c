@@ -0,0 +1,125 @@
+// Zero-copy cy_retarget_io_reserve()/cy_retarget_io_commit() interleaved with _write()
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+static uint8_t tx_buffer[50];
+static char    ref[200000];
+static size_t  ref_len;
+static char    ref_prev;
+static void*   held;
+#if defined(CY_RTOS_AWARE)
+static int     other_task;
+#endif
+
+
+static void ref_write(const char* ptr, size_t len)
+{
+    for (size_t i = 0U; i < len; i++)
+    {
+#if defined(CY_RETARGET_IO_CONVERT_LF_TO_CRLF)
+        if ((ptr[i] == '\n') && (ref_prev != '\r'))
+        {
+            ref[ref_len++] = '\r';
+        }
+#endif
+        ref[ref_len++] = ptr[i];
+        ref_prev       = ptr[i];
+    }
+}
+
+
+#if defined(CY_RTOS_AWARE)
+// Runs as another task while the main task is blocked, it commits the region it holds
+static void holder_commit(void)
+{
+    sim_thread_id = &other_task;
+    memcpy(held, "held\n", 5U);
+    cy_retarget_io_commit(5U);
+    ref_write("held\n", 5U);
+    sim_thread_id = NULL;
+}
+
+
+#endif
+
+
+int main(void)
+{
+    int short_grants = 0;
+
+    setvbuf(stdout, NULL, _IONBF, 0);
+    sim_reset();
+    assert(cy_retarget_io_init_buffered(XMC_USIC0_CH0, tx_buffer, sizeof(tx_buffer)) ==
+           CY_RSLT_SUCCESS);
+    for (int k = 0; k < 2000; k++)
+    {
+        char line[40];
+        int  len = snprintf(line, sizeof(line), "k=%d %s\n", k, ((k % 3) != 0) ? "abc" :
+                            "longer text");
+        if ((k % 2) != 0)
+        {
+            void*  ptr;
+            size_t granted = cy_retarget_io_reserve(30U, &ptr);
+            size_t used    = ((size_t)len < granted) ? (size_t)len : granted;
+
+            assert(granted > 0U);
+            if (granted < 30U)
+            {
+                short_grants++;
+            }
+            memcpy(ptr, line, used);
+            cy_retarget_io_commit(used);
+            ref_write(line, used);
+        }
+        else
+        {
+            _write(1, line, len);
+            ref_write(line, (size_t)len);
+        }
+    }
+    sim_expect("reserve", ref, ref_len);
+    printf("%d short grants\n", short_grants);
+
+    // The task holding the region drops its own writes instead of waiting for itself
+    assert(cy_retarget_io_reserve(8U, &held) >= 8U);
+    assert(_write(1, "self\n", 5) == 0);
+    assert(cy_retarget_io_reserve(8U, &held) == 0U);
+    cy_retarget_io_commit(0U);
+#if defined(CY_RTOS_AWARE)
+    // Other tasks block until the region is committed
+    sim_thread_id = &other_task;
+    assert(cy_retarget_io_reserve(8U, &held) >= 8U);
+    sim_thread_id = NULL;
+    sim_switch    = holder_commit;
+    assert(_write(1, "after\n", 6) == 6);
+    assert(sim_switch == NULL);
+    ref_write("after\n", 6U);
+#endif
+    sim_expect("wait open", ref, ref_len);
+#if defined(CY_RTOS_AWARE)
+    // Half of the ring is free but split by its end, the task blocks until a region fits
+    cy_retarget_io_deinit();
+    assert(cy_retarget_io_init_buffered(XMC_USIC0_CH0, tx_buffer, sizeof(tx_buffer)) ==
+           CY_RSLT_SUCCESS);
+    size_t sent = sim_out_len;
+    assert(_write(1, "0123456789abcdefghijklmnopqrst", 30) == 30);
+    ref_write("0123456789abcdefghijklmnopqrst", 30U);
+    while (sim_out_len < (sent + 20U))
+    {
+        sim_tick();
+    }
+    int waits = sim_semaphore_waits;
+    assert(cy_retarget_io_reserve(30U, &held) >= 24U);
+    assert(sim_semaphore_waits > waits);
+    memcpy(held, "split\n", 6U);
+    cy_retarget_io_commit(6U);
+    ref_write("split\n", 6U);
+    sim_expect("split", ref, ref_len);
+#endif
+    cy_retarget_io_deinit();
+    printf("ALL OK\n");
+    return 0;
+}
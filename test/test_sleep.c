@@ -0,0 +1,78 @@
+// Waiting for ring space sleeps in __WFI unless CY_RETARGET_IO_NO_SLEEP or an RTOS is in use
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+
+void __NOP(void);
+
+static uint8_t tx_buffer[32];
+static char    big[2000];
+
+
+static void run(const char* what)
+{
+    sim_wfi_count = 0;
+    _write(1, big, (int)strlen(big));
+    while (cy_retarget_io_is_tx_active())
+    {
+        __NOP();
+    }
+    sim_expect(what, big, strlen(big));
+#if defined(CY_RETARGET_IO_NO_SLEEP) || defined(CY_RTOS_AWARE)
+    assert(sim_wfi_count == 0);
+#else
+    assert(sim_wfi_count > 0);
+#endif
+}
+
+
+int main(void)
+{
+    setvbuf(stdout, NULL, _IONBF, 0);
+    for (size_t i = 0U; i < sizeof(big) - 1U; i++)
+    {
+        big[i] = (char)('a' + (i % 26U));
+    }
+
+    sim_reset();
+    assert(cy_retarget_io_init_buffered(XMC_USIC0_CH0, tx_buffer, sizeof(tx_buffer)) ==
+           CY_RSLT_SUCCESS);
+    run("interrupt");
+    // Data in the ring counts as active while the hardware is idle
+    sim_tx_stall = 1;
+    sim_out_len  = 0U;
+    _write(1, "abc", 3);
+    assert(cy_retarget_io_is_tx_active());
+    sim_tx_stall = 0;
+    sim_drain();
+    cy_retarget_io_deinit();
+    printf("ok active\n");
+
+    sim_reset();
+    XMC_USIC0_CH0->TBCTR = (uint32_t)XMC_USIC_CH_FIFO_SIZE_16WORDS << USIC_CH_TBCTR_SIZE_Pos;
+    assert(cy_retarget_io_init_buffered(XMC_USIC0_CH0, tx_buffer, sizeof(tx_buffer)) ==
+           CY_RSLT_SUCCESS);
+    run("fifo");
+    cy_retarget_io_deinit();
+
+#if (UC_FAMILY == XMC4)
+    {
+        cy_retarget_io_config_t config;
+
+        sim_reset();
+        memset(&config, 0, sizeof(config));
+        config.channel             = XMC_USIC0_CH0;
+        config.tx_buffer           = tx_buffer;
+        config.tx_buffer_size      = sizeof(tx_buffer);
+        config.dma.enable          = true;
+        config.dma.channel         = 2U;
+        config.dma.service_request = 1U;
+        assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+        run("dma");
+        cy_retarget_io_deinit();
+    }
+#endif
+    printf("ALL OK\n");
+    return 0;
+}
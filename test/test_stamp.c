@@ -0,0 +1,167 @@
+// CY_RETARGET_IO_LINE_STAMP puts a time stamp in front of every line in every output path
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+static uint32_t now;
+static int      skipped;
+static char     ref[400000];
+static size_t   ref_len;
+static char     ref_prev;
+static int      preempt_fd = -1;
+static uint32_t preempt_ipsr;
+
+
+static void ref_write(const char* ptr, size_t len);
+
+
+// Also models an interrupt or a task of higher priority that writes to preempt_fd while a write
+// is starting
+uint32_t cy_retarget_io_get_timestamp(void)
+{
+    if (preempt_fd >= 0)
+    {
+        int fd = preempt_fd;
+
+        preempt_fd = -1;
+        sim_force_ipsr(preempt_ipsr);
+        _write(fd, "\nirq\n", 5);
+        ref_write("\nirq\n", 5U);
+        sim_force_ipsr(0U);
+    }
+    return now;
+}
+
+
+static void ref_write(const char* ptr, size_t len)
+{
+    for (size_t i = 0U; i < len; i++)
+    {
+        if (ref_prev == '\n')
+        {
+#if (CY_RETARGET_IO_LINE_STAMP + 0) == 2
+            ref[ref_len++] = (char)0xFE;
+            for (int b = 0; b < 4; b++)
+            {
+                ref[ref_len++] = (char)(now >> (8 * b));
+            }
+#else
+            ref_len += (size_t)sprintf(&ref[ref_len], "%08x ", (unsigned)now);
+#endif
+        }
+#if defined(CY_RETARGET_IO_CONVERT_LF_TO_CRLF)
+        if ((ptr[i] == '\n') && (ref_prev != '\r'))
+        {
+            ref[ref_len++] = '\r';
+        }
+#endif
+        ref[ref_len++] = ptr[i];
+        ref_prev       = ptr[i];
+    }
+}
+
+
+static void run(int fd, bool reserve)
+{
+    ref_len     = 0U;
+    ref_prev    = '\n';
+    sim_out_len = 0U;
+    srand(7U);
+    for (int k = 0; k < 1500; k++)
+    {
+        char   line[48];
+        int    len = snprintf(line, sizeof(line), "%s%d%s", ((k % 5) == 0) ? "\n" : "", k,
+                              ((k % 3) != 0) ? " ab\n" : (((k % 7) == 0) ? "\r\n\n" : " x"));
+        size_t split = (size_t)rand() % (size_t)(len + 1);
+
+        now = 0x1000U + (uint32_t)k;
+        if (reserve && ((k % 2) != 0))
+        {
+            void*  ptr;
+            size_t granted = cy_retarget_io_reserve(60U, &ptr);
+            size_t used    = ((size_t)len < granted) ? (size_t)len : granted;
+
+            assert(granted > 0U);
+            if (granted < 3U * (CY_RETARGET_IO_LINE_STAMP_SIZE + 8U))
+            {
+                cy_retarget_io_commit(0U);
+                skipped++;
+                continue;
+            }
+            memcpy(ptr, line, used);
+            cy_retarget_io_commit(used);
+            ref_write(line, used);
+        }
+        else
+        {
+            _write(fd, line, (int)split);
+            ref_write(line, split);
+            _write(fd, &line[split], len - (int)split);
+            ref_write(&line[split], (size_t)len - split);
+        }
+    }
+}
+
+
+// A write that is preempted follows the output of the preempting writer, not the character the
+// stream ended with when the write started. The high lane used here is too small for an interrupt,
+// which would drop what does not fit.
+static void preempt(int fd, uint32_t ipsr)
+{
+    _write(fd, "x", 1);
+    ref_write("x", 1U);
+    preempt_fd   = fd;
+    preempt_ipsr = ipsr;
+    _write(fd, "task\n", 5);
+    ref_write("task\n", 5U);
+    assert(preempt_fd < 0);
+}
+
+
+int main(void)
+{
+    static uint8_t          big[256];
+    static uint8_t          tiny[4U + CY_RETARGET_IO_LINE_STAMP_SIZE];
+    static uint8_t          high[4U + CY_RETARGET_IO_LINE_STAMP_SIZE];
+    cy_retarget_io_config_t config;
+
+    setvbuf(stdout, NULL, _IONBF, 0);
+    sim_reset();
+    assert(cy_retarget_io_init(XMC_USIC0_CH0) == CY_RSLT_SUCCESS);
+    run(1, false);
+    sim_expect("polling", ref, ref_len);
+    cy_retarget_io_deinit();
+
+    sim_reset();
+    assert(cy_retarget_io_init_buffered(XMC_USIC0_CH0, tiny, sizeof(tiny) - 1U) !=
+           CY_RSLT_SUCCESS);
+    assert(cy_retarget_io_init_buffered(XMC_USIC0_CH0, tiny, sizeof(tiny)) == CY_RSLT_SUCCESS);
+    run(1, false);
+    sim_expect("tiny ring", ref, ref_len);
+    cy_retarget_io_deinit();
+
+    sim_reset();
+    assert(cy_retarget_io_init_buffered(XMC_USIC0_CH0, big, sizeof(big)) == CY_RSLT_SUCCESS);
+    run(1, true);
+    preempt(1, 20U);
+    sim_expect("ring and commit", ref, ref_len);
+    printf("%d reservations skipped\n", skipped);
+    cy_retarget_io_deinit();
+
+    sim_reset();
+    memset(&config, 0, sizeof(config));
+    config.channel             = XMC_USIC0_CH0;
+    config.tx_buffer           = big;
+    config.tx_buffer_size      = sizeof(big);
+    config.tx_high_buffer      = high;
+    config.tx_high_buffer_size = sizeof(high);
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+    run(2, false);
+    preempt(2, 0U);
+    sim_expect("high lane", ref, ref_len);
+    cy_retarget_io_deinit();
+    printf("ALL OK\n");
+    return 0;
+}
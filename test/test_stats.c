@@ -0,0 +1,62 @@
+// CY_RETARGET_IO_STATS counts bytes, calls, waits and high water marks
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+
+#define LINE        "bulk trace line with some text\n"
+#define LINE_LEN    (sizeof(LINE) - 1U)
+
+static uint8_t tx_buffer[64];
+static uint8_t rx_buffer[32];
+
+
+int main(void)
+{
+    cy_retarget_io_config_t config;
+    cy_retarget_io_stats_t  stats;
+    char                    line[16];
+    uint32_t                calls = 0U;
+
+    setvbuf(stdout, NULL, _IONBF, 0);
+    sim_reset();
+    memset(&config, 0, sizeof(config));
+    config.channel        = XMC_USIC0_CH0;
+    config.tx_buffer      = tx_buffer;
+    config.tx_buffer_size = sizeof(tx_buffer);
+    config.rx_buffer      = rx_buffer;
+    config.rx_buffer_size = sizeof(rx_buffer);
+    assert(cy_retarget_io_init_cfg(&config) == CY_RSLT_SUCCESS);
+    for (int i = 0; i < 6; i++)
+    {
+        _write(1, LINE, (int)LINE_LEN);
+    }
+    sim_drain();
+    for (const char* p = "abc\n"; *p != '\0'; p++)
+    {
+        sim_rx((uint8_t)*p);
+    }
+    assert(cy_retarget_io_read(line, sizeof(line), 5U, CY_RETARGET_IO_READ_LINE) == 4U);
+
+    cy_retarget_io_get_stats(&stats);
+    for (unsigned i = 0U; i < CY_RETARGET_IO_STATS_LATENCY_BINS; i++)
+    {
+        calls += stats.write_latency[i];
+    }
+    assert((calls == 6U) && (stats.write_cycles > 0U));
+    assert((stats.bytes_written == 6U * LINE_LEN) && (stats.write_calls == 6U));
+    assert(stats.bytes_read == 4U);
+    assert((stats.tx_high_water > LINE_LEN) && (stats.tx_high_water < sizeof(tx_buffer)));
+    assert((stats.rx_high_water == 4U) && (stats.tx_blocked_cycles > 0U));
+
+    // cy_retarget_io_printf() writes output longer than its buffer at the line ends, three lines of
+    // 40 characters in three parts, not in a full buffer and the rest
+    const char* text = "thirty-nine characters of text, then LF";
+    calls = stats.write_calls;
+    assert(cy_retarget_io_printf("%s\n%s\n%s\n", text, text, text) == 3 * 40);
+    cy_retarget_io_get_stats(&stats);
+    assert(stats.write_calls == calls + 3U);
+    cy_retarget_io_deinit();
+    printf("ALL OK\n");
+    return 0;
+}
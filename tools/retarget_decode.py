@@ -0,0 +1,403 @@
+#!/usr/bin/env python3
+# Copyright 2021-2022 Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""Decodes the binary output of retarget-io into text.
+
+Reads the bytes received from the UART, from a capture file, a serial device
+or stdin, and writes the text with the binary parts decoded:
+
+* CY_RETARGET_IO_COMPRESS frames (0xFD) are checked and decompressed. After a
+  bad check or a lost frame, frames are dropped until the next one that
+  clears the window.
+* CY_RETARGET_IO_LOG records (0xFF) are formatted with the format string
+  found at their address in the .cy_retarget_io_fmt section of the ELF file
+  of the application, after their timestamp as 8 hex digits and a space. %s
+  arguments are looked up in the ELF file as well.
+* Binary CY_RETARGET_IO_LINE_STAMP headers (0xFE) are written as 8 hex
+  digits and a space, like the text headers.
+* cy_retarget_io_write_frame() frames between zero bytes are checked and
+  written as <frame n: hex>. Zero delimited data that is no valid frame is
+  written as text.
+
+Example:
+    retarget_decode.py -e build/app.elf capture.bin
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+LOG_MARKER = 0xFF
+STAMP_MARKER = 0xFE
+COMPRESS_MARKER = 0xFD
+LOG_HEADER_SIZE = 10
+COMPRESS_RESET = 0x80
+FMT_SECTION = '.cy_retarget_io_fmt'
+
+# Longest data between two zero bytes that is still taken for a frame
+MAX_FRAME = 4096
+
+_SPEC = re.compile(rb'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|z|t|j)?([diouxXcsp%])')
+
+
+class Elf:
+    """Allocated sections of an ELF file, to look up strings by address."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            image = f.read()
+        if image[:4] != b'\x7fELF':
+            raise ValueError(f'{path} is no ELF file')
+        wide = image[4] == 2
+        order = '<' if image[5] == 1 else '>'
+        if wide:
+            shoff, = struct.unpack_from(order + 'Q', image, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from(order + 'HHH', image, 0x3A)
+            layout = order + 'IIQQQQ'
+        else:
+            shoff, = struct.unpack_from(order + 'I', image, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from(order + 'HHH', image, 0x2E)
+            layout = order + 'IIIIII'
+        headers = [struct.unpack_from(layout, image, shoff + i * shentsize)
+                   for i in range(shnum)]
+        names = headers[shstrndx][4] if shnum > 0 else 0
+
+        # (start address, contents, name) of every allocated section with contents
+        self.sections = []
+        for name, kind, flags, addr, offset, size in headers:
+            if (flags & 2) and kind != 8 and size > 0:
+                end = image.index(b'\0', names + name)
+                self.sections.append((addr, image[offset:offset + size],
+                                      image[names + name:end].decode()))
+
+    def string(self, addr, section=None):
+        """Returns the zero terminated string at addr, None if it is not in the file."""
+        for start, data, name in self.sections:
+            if (section is None or name == section) and start <= addr < start + len(data):
+                offset = addr - start
+                end = data.find(b'\0', offset)
+                return data[offset:] if end < 0 else data[offset:end]
+        return None
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE of cy_retarget_io_write_frame()."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+        crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    """Returns the payload of a COBS encoded frame, None if it is invalid."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    if len(out) < 2 or crc16(out[:-2]) != (out[-2] | (out[-1] << 8)):
+        return None
+    return bytes(out[:-2])
+
+
+def format_log(fmt, args, elf):
+    """Formats the arguments of a log record like cy_retarget_io_printf()."""
+    out = bytearray()
+    args = list(args)
+    pos = 0
+    for match in _SPEC.finditer(fmt):
+        out += fmt[pos:match.start()]
+        pos = match.end()
+        flags, width, precision, length, conv = match.groups()
+        if conv == b'%':
+            out += b'%'
+            continue
+        needed = (width == b'*') + (precision == b'*') + 1
+        if len(args) < needed:
+            out += match.group(0)
+            continue
+        flags = flags.decode()
+        if width == b'*':
+            width = struct.unpack('<i', struct.pack('<I', args.pop(0)))[0]
+            if width < 0:
+                flags += '-'
+                width = -width
+        width = int(width) if width else 0
+        if precision == b'*':
+            precision = struct.unpack('<i', struct.pack('<I', args.pop(0)))[0]
+            precision = None if precision < 0 else precision
+        elif precision is not None:
+            precision = int(precision or b'0')
+        value = args.pop(0)
+        bits = {b'hh': 8, b'h': 16}.get(length, 32)
+        value &= (1 << bits) - 1
+        prec = '' if precision is None else f'.{precision}'
+        if conv in b'di':
+            if value >= 1 << (bits - 1):
+                value -= 1 << bits
+            text = ('%' + flags + prec + 'd') % value
+        elif conv in b'uxX':
+            if value == 0:
+                flags = flags.replace('#', '')
+            text = ('%' + flags.replace('+', '').replace(' ', '') + prec +
+                    {b'u': 'd', b'x': 'x', b'X': 'X'}[conv]) % value
+        elif conv == b'o':
+            text = ('%' + prec + 'o') % value
+            if '#' in flags and not text.startswith('0'):
+                text = '0' + text
+        elif conv == b'c':
+            text = chr(value & 0xFF)
+        elif conv == b'p':
+            text = f'0x{value:x}'
+        else:
+            string = elf.string(value) if elf else None
+            text = (f'<0x{value:08x}>' if string is None else string.decode('latin-1'))
+            if precision is not None:
+                text = text[:precision]
+        if len(text) < width:
+            if '-' in flags:
+                text = text.ljust(width)
+            elif '0' in flags and conv not in b'csp' and precision is None:
+                sign = text[0] if text[0] in '+- ' else ''
+                body = text[len(sign):]
+                prefix = body[:2] if body[:2] in ('0x', '0X') else ''
+                text = sign + prefix + body[len(prefix):].rjust(width - len(sign) - len(prefix),
+                                                                 '0')
+            else:
+                text = text.rjust(width)
+        out += text.encode('latin-1')
+    out += fmt[pos:]
+    return bytes(out)
+
+
+class StreamDecoder:
+    """Decodes text with log records, binary line stamps and frames."""
+
+    def __init__(self, out, elf, max_args):
+        self.out = out
+        self.elf = elf
+        self.max_args = max_args
+        self.buf = bytearray()
+
+    @property
+    def pending(self):
+        """True while a record or frame is incomplete."""
+        return len(self.buf) > 0
+
+    def reset(self):
+        self.buf.clear()
+
+    def feed(self, data):
+        self.buf += data
+        while self.buf:
+            used = self._decode()
+            if used == 0:
+                break
+            del self.buf[:used]
+
+    def _decode(self):
+        """Decodes the item at the start of the buffer, returns its size or 0 if incomplete."""
+        buf = self.buf
+        head = buf[0]
+        if head == LOG_MARKER:
+            if len(buf) < 2:
+                return 0
+            count = buf[1]
+            if count > self.max_args:
+                return 1
+            size = LOG_HEADER_SIZE + 4 * count
+            if len(buf) < size:
+                return 0
+            addr, stamp = struct.unpack_from('<II', buf, 2)
+            args = struct.unpack_from(f'<{count}I', buf, LOG_HEADER_SIZE)
+            fmt = self.elf.string(addr, FMT_SECTION) if self.elf else None
+            if fmt is None:
+                arg_text = ' '.join(f'0x{arg:x}' for arg in args)
+                text = f'<log 0x{addr:08x}: {arg_text}>\n'.encode()
+            else:
+                text = format_log(fmt, args, self.elf)
+            self.out.write(b'%08x ' % stamp + text)
+            return size
+        if head == STAMP_MARKER:
+            if len(buf) < 5:
+                return 0
+            self.out.write(b'%08x ' % struct.unpack_from('<I', buf, 1))
+            return 5
+        if head == 0:
+            end = buf.find(b'\0', 1)
+            if end < 0:
+                # Without a closing zero within the longest frame, the zero was no delimiter
+                return 0 if len(buf) <= MAX_FRAME else 1
+            if end == 1:
+                return 1
+            payload = cobs_decode(bytes(buf[1:end]))
+            if payload is None:
+                return 1
+            self.out.write(b'<frame %d: %s>' % (len(payload), payload.hex().encode()))
+            return end + 1
+        size = 1
+        while size < len(buf) and buf[size] not in (LOG_MARKER, STAMP_MARKER, 0):
+            size += 1
+        self.out.write(bytes(buf[:size]))
+        return size
+
+    def flush(self):
+        """Decodes the rest of the input, skipping the start of an incomplete item."""
+        while self.buf:
+            del self.buf[:1]
+            self.feed(b'')
+
+
+class Decoder:
+    """Separates CY_RETARGET_IO_COMPRESS frames from the output sent between them."""
+
+    def __init__(self, out, elf, max_args=8):
+        self.raw = StreamDecoder(out, elf, max_args)
+        self.unpacked = StreamDecoder(out, elf, max_args)
+        self.buf = bytearray()
+        self.window = bytearray()
+        self.seq = None
+        # Set after a damaged frame until the next frame that clears the window
+        self.lost = False
+        # Set after a damaged frame until the next valid one, the bytes meanwhile are dropped
+        self.resync = False
+
+    def feed(self, data):
+        self.buf += data
+        while self.buf:
+            if self.raw.pending:
+                # A record or frame of the output between the frames may contain the marker
+                end = 1
+            elif self.buf[0] != COMPRESS_MARKER:
+                end = self.buf.find(bytes([COMPRESS_MARKER]))
+                end = len(self.buf) if end < 0 else end
+            else:
+                end = 0
+            if end > 0:
+                if not self.resync:
+                    self.raw.feed(bytes(self.buf[:end]))
+                del self.buf[:end]
+                continue
+            if len(self.buf) < 3 or len(self.buf) < self.buf[2] + 5:
+                return
+            size = self.buf[2] + 5
+            frame = bytes(self.buf[:size])
+            total = check = 0
+            for byte in frame[1:-2]:
+                total = (total + byte) & 0xFF
+                check = (check + total) & 0xFF
+            if (total, check) != (frame[-2], frame[-1]):
+                # Not a frame, or a damaged one: resume at a frame that clears the window
+                del self.buf[:1]
+                self.resync = True
+                self._lose()
+                continue
+            del self.buf[:size]
+            self.resync = False
+            self._frame(frame[1], frame[3:-2])
+
+    def _lose(self):
+        self.lost = True
+        self.seq = None
+        self.unpacked.reset()
+
+    def _frame(self, flags, payload):
+        seq = flags & 0x7F
+        if flags & COMPRESS_RESET:
+            self.window.clear()
+            self.lost = False
+        elif self.lost or (self.seq is not None and seq != self.seq):
+            self._lose()
+            return
+        self.seq = (seq + 1) & 0x7F
+        start = len(self.window)
+        i = 0
+        try:
+            while i < len(payload):
+                code = payload[i]
+                if code < 0x80:
+                    if i + 2 + code > len(payload):
+                        raise IndexError
+                    self.window += payload[i + 1:i + 2 + code]
+                    i += 2 + code
+                    continue
+                length = ((code >> 4) & 7) + 3
+                distance = ((code & 0x0F) << 8) + payload[i + 1] + 1
+                i += 2
+                if length == 10:
+                    length += payload[i]
+                    i += 1
+                if distance > len(self.window):
+                    raise IndexError
+                for _ in range(length):
+                    self.window.append(self.window[-distance])
+        except IndexError:
+            self._lose()
+            return
+        self.unpacked.feed(bytes(self.window[start:]))
+        # Matches reach at most 4096 bytes back
+        del self.window[:-4096]
+
+    def flush(self):
+        """Decodes the rest of the input, an incomplete frame is dropped."""
+        self.unpacked.flush()
+        if self.raw.pending:
+            self.raw.feed(bytes(self.buf))
+            self.buf.clear()
+        self.raw.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('input', nargs='?', default='-',
+                        help='capture file or serial device, - for stdin (default)')
+    parser.add_argument('-e', '--elf', help='ELF file of the application, for log records')
+    parser.add_argument('--max-args', type=int, default=8,
+                        help='CY_RETARGET_IO_LOG_MAX_ARGS of the application (default 8)')
+    options = parser.parse_args()
+
+    elf = Elf(options.elf) if options.elf else None
+    out = sys.stdout.buffer
+    decoder = Decoder(out, elf, options.max_args)
+    source = sys.stdin.buffer if options.input == '-' else open(options.input, 'rb', buffering=0)
+    try:
+        while True:
+            data = source.read(4096)
+            if not data:
+                break
+            decoder.feed(data)
+            out.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        decoder.flush()
+        out.flush()
+        if source is not sys.stdin.buffer:
+            source.close()
+
+
+if __name__ == '__main__':
+    main()